@@ -25,6 +25,7 @@
 #include "splinter.h"
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
@@ -37,12 +38,25 @@
 #include <sys/eventfd.h>
 #include <sys/syscall.h>
 #include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <pthread.h>
+#if defined(__x86_64__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 #ifdef SPLINTER_NUMA_AFFINITY
 #include <numa.h>
 #include <numaif.h>
 #endif // SPLINTER_NUMA_AFFINITY
 
+#ifdef HAVE_SDT
+#include <sys/sdt.h>
+#endif // HAVE_SDT
+
 /** @brief Base pointer to the memory-mapped region. */
 static void *g_base = NULL;
 /** @brief Total size of the memory-mapped region. */
@@ -51,13 +65,41 @@ static size_t g_total_sz = 0;
 static struct splinter_header *H;
 /** @brief Pointer to the array of slots within the mapped region. */
 static struct splinter_slot *S;
+/** @brief Pointer to the ordered key index nodes (one per slot). */
+static struct splinter_index_node *IX;
+/** @brief Pointer to the per-slot aux records (TTL, CLOCK reference bit, tiering heat). */
+static struct splinter_slot_aux *AUX;
+/** @brief Base pointer to the occupancy bitmap: bit i is set while slot i holds a key. */
+static atomic_uint_least64_t *OCC;
 /** @brief Pointer to the start of the value storage area. */
 static uint8_t *VALUES;
 /** @brief Process-local eventfd used to signal epoch changes; -1 if not initialized. */
 static int g_event_fd = -1;
+/** @brief Name the store was opened or created under, for following a resize. */
+static char g_name[PATH_MAX];
+/** @brief Mapping superseded by the last resize; unmapped on the next one or on close. */
+static void *g_retired_base = NULL;
+static size_t g_retired_sz = 0;
+/** @brief Held while this process swaps its mapping, so one thread follows a resize. */
+static atomic_flag g_remap_lock = ATOMIC_FLAG_INIT;
 
 /* Forward declaration — defined near splinter_pulse_watchers */
 static void splinter_event_bus_notify(size_t physical_idx);
+static void spl_madv_bus_close(void);
+/* Forward declaration — defined with the tracing code */
+static void spl_trace_env(void);
+/* Forward declarations — ordered key index maintenance, defined after splinter_list */
+static void spl_index_insert(uint32_t slot);
+static int spl_index_remove(uint32_t slot);
+static void spl_index_remove_settle(uint32_t slot);
+/* Forward declaration — value arena allocator, defined before splinter_unset */
+static inline uint32_t spl_slot_extent(const struct splinter_slot *slot);
+static inline int spl_slot_chained(const struct splinter_slot *slot);
+static void spl_chain_scrub_tail(const struct splinter_slot *slot, size_t len);
+/* Forward declarations — online resize, defined after splinter_append */
+static void spl_follow_resize(void);
+static int spl_resize_reap(void);
+static struct splinter_slot *spl_find_slot(const char *key);
 
 /**
  * @brief Computes the 64-bit FNV-1a hash of a string.
@@ -94,6 +136,49 @@ static void add_ms(struct timespec *ts, uint64_t ms) {
     }
 }
 
+/** @brief Size of the aux region, padded to a whole number of cache lines. */
+static inline size_t spl_aux_size(size_t slots) {
+    return (slots * sizeof(struct splinter_slot_aux) + 63) & ~(size_t)63;
+}
+
+/** @brief Size of the occupancy bitmap, padded to a whole number of cache lines. */
+static inline size_t spl_occ_size(size_t slots) {
+    return (((slots + 63) / 64) * sizeof(uint64_t) + 63) & ~(size_t)63;
+}
+
+/**
+ * @brief Computes the mapped size of a store of the given geometry.
+ * Layout: [header][slots][index nodes][aux][occupancy][values]. Every region is a whole
+ * number of 64-byte lines, so each one starts cache-line aligned. The value
+ * arena is last, so its size never moves the regions before it.
+ */
+static size_t spl_store_size(size_t slots, size_t arena_sz) {
+    return sizeof(struct splinter_header)
+         + slots * sizeof(struct splinter_slot)
+         + slots * sizeof(struct splinter_index_node)
+         + spl_aux_size(slots)
+         + spl_occ_size(slots)
+         + arena_sz;
+}
+
+/**
+ * @brief Largest value arena. Offsets are 64-bit, but free-stack links and
+ * chain descriptors hold them as 32-bit counts of 64-byte units.
+ */
+#define SPL_ARENA_MAX ((uint64_t)UINT32_MAX * 64u)
+
+/**
+ * @brief Derives the region pointers from H. Must run whenever H->slots is
+ * (re)established, i.e. after mapping an existing store or populating a new one.
+ */
+static void spl_map_regions(void) {
+    S = (struct splinter_slot *)(H + 1);
+    IX = (struct splinter_index_node *)(S + H->slots);
+    AUX = (struct splinter_slot_aux *)(IX + H->slots);
+    OCC = (atomic_uint_least64_t *)((uint8_t *)AUX + spl_aux_size(H->slots));
+    VALUES = (uint8_t *)OCC + spl_occ_size(H->slots);
+}
+
 /**
  * @brief Internal helper to memory-map a file descriptor and set up global pointers.
  * @param fd The file descriptor to map.
@@ -103,10 +188,13 @@ static void add_ms(struct timespec *ts, uint64_t ms) {
 static int map_fd(int fd, size_t size) {
     g_total_sz = size;
     g_base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping keeps the object alive; nothing else needs the descriptor.
+    int err = errno;
+    close(fd);
+    errno = err;
     if (g_base == MAP_FAILED) return -1;
     H = (struct splinter_header *)g_base;
-    S = (struct splinter_slot *)(H + 1);
-    VALUES = (uint8_t *)(S + H->slots);
+    spl_map_regions();
     return 0;
 }
 
@@ -145,7 +233,17 @@ static void restore_env_umask(mode_t prev) {
     if (prev != (mode_t)-1) umask(prev);
 }
 
+/** @brief Record the name we attached by, so a resize can be followed. */
+static void spl_remember_name(const char *name_or_path) {
+    if (name_or_path != g_name) snprintf(g_name, sizeof(g_name), "%s", name_or_path);
+}
+
 int splinter_create(const char *name_or_path, size_t slots, size_t max_value_sz) {
+    return splinter_create_ex(name_or_path, slots, max_value_sz, 0);
+}
+
+int splinter_create_ex(const char *name_or_path, size_t slots, size_t max_value_sz,
+                       size_t arena_sz) {
     int fd;
 
     if (slots <= 0 || max_value_sz <= 0) {
@@ -153,6 +251,26 @@ int splinter_create(const char *name_or_path, size_t slots, size_t max_value_sz)
         return -2;
     }
 
+    /*
+     * Value offsets are 64-bit, but free-stack links and chain descriptors
+     * keep them in 32 bits of 64-byte units, so the arena tops out at
+     * SPL_ARENA_MAX (256 GiB). An explicit arena beyond that is refused; the
+     * default (slots x max) is clamped to it.
+     */
+    const size_t arena_max = (size_t)SPL_ARENA_MAX;
+    const size_t top_sz = (max_value_sz + 63) & ~(size_t)63;
+    if (max_value_sz > UINT32_MAX - 63 || top_sz > arena_max) {
+        errno = EFBIG;
+        return -2;
+    }
+    if (arena_sz == 0) {
+        arena_sz = (slots > arena_max / top_sz) ? arena_max : slots * top_sz;
+    } else {
+        arena_sz = (arena_sz + 63) & ~(size_t)63;
+        if (arena_sz > arena_max) { errno = EFBIG; return -2; }
+        if (arena_sz < top_sz)    { errno = EINVAL; return -2; }
+    }
+
     mode_t prev_umask = apply_env_umask();
 #ifdef SPLINTER_PERSISTENT
     /*
@@ -168,26 +286,37 @@ int splinter_create(const char *name_or_path, size_t slots, size_t max_value_sz)
 #endif
     restore_env_umask(prev_umask);
     if (fd < 0) return -1;
-    size_t region_sz = slots * max_value_sz;
-    size_t total_sz  = sizeof(struct splinter_header) + slots * sizeof(struct splinter_slot) + region_sz;
-    if (ftruncate(fd, (off_t)total_sz) != 0) return -1;
+    size_t total_sz = spl_store_size(slots, arena_sz);
+    if (ftruncate(fd, (off_t)total_sz) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
     if (map_fd(fd, total_sz) != 0) return -1;
     
     H->magic = SPLINTER_MAGIC;
     H->version = SPLINTER_VER;
     H->slots = (uint32_t)slots;
     H->max_val_sz = (uint32_t)max_value_sz;
-    H->val_sz = total_sz;
+    H->val_sz = (uint64_t)arena_sz;
 
     /*
-     * map_fd() derived VALUES from H->slots, but on a fresh create the mapping
-     * is zero-filled so H->slots read as 0 there, leaving VALUES aliased onto
-     * the slot array. Now that the header is populated, recompute it so the
-     * value arena starts after the slots. (splinter_open() is unaffected: it
-     * maps a store whose header already carries the real slot count.)
+     * map_fd() derived the regions from H->slots, but on a fresh create the
+     * mapping is zero-filled so H->slots read as 0 there, leaving IX and VALUES
+     * aliased onto the slot array. Now that the header is populated, recompute
+     * them. (splinter_open() is unaffected: it maps a store whose header
+     * already carries the real slot count.)
      */
-    VALUES = (uint8_t *)(S + H->slots);
+    spl_map_regions();
     atomic_store_explicit(&H->val_brk, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->val_chain, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->tier_on, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->resizing, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->moved, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->resize_front, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->resize_owner, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->resize_held, 0, memory_order_relaxed);
     atomic_store_explicit(&H->epoch, 1, memory_order_relaxed);
     /* New stores default to hybrid scrub (mop mode 1): see splinter_set_mop(). */
     atomic_store_explicit(&H->core_flags, SPL_SYS_AUTO_SCRUB | SPL_SYS_HYBRID_SCRUB, memory_order_relaxed);
@@ -213,22 +342,45 @@ int splinter_create(const char *name_or_path, size_t slots, size_t max_value_sz)
         atomic_store_explicit(&H->shard_bids[b].claimed_at,   0, memory_order_relaxed);
     }
 
-    size_t i;
-    for (i = 0; i < slots; ++i) {
-        atomic_fetch_or(&S[i].type_flag, SPL_SLOT_DEFAULT_TYPE);
-        atomic_store_explicit(&S[i].hash, 0, memory_order_relaxed);
-        atomic_store_explicit(&S[i].epoch, 0, memory_order_relaxed);
-        atomic_store_explicit(&S[i].ctime, 0, memory_order_relaxed);
-        atomic_store_explicit(&S[i].atime, 0, memory_order_relaxed);
-        atomic_store_explicit(&S[i].user_flag, 0, memory_order_relaxed);
-        atomic_store_explicit(&S[i].watcher_mask, 0, memory_order_relaxed);
-        for (int b = 0; b < 64; b++) {
-            atomic_store_explicit(&H->bloom_watches[b], 0xFF, memory_order_relaxed);
-        }
-        S[i].val_off = (uint32_t)(i * max_value_sz);
-        atomic_store_explicit(&S[i].val_len, 0, memory_order_relaxed);
-        S[i].key[0] = '\0';      
-    }
+    // Ordered key index: empty, unlocked, not stale. Nodes are zero-filled by
+    // ftruncate and only linked once SPL_SYS_KEY_INDEX is turned on.
+    atomic_store_explicit(&H->index_seq,   0, memory_order_relaxed);
+    atomic_store_explicit(&H->index_count, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->index_stale, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->index_owner, 0, memory_order_relaxed);
+    for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++)
+        atomic_store_explicit(&H->index_head.next[l], 0, memory_order_relaxed);
+
+    // Cache residence: TTL stamps count from one second before now, so a
+    // stamp is never 0 (0 means "no TTL"). The aux region is zero-filled.
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    H->ttl_base = (uint64_t)ts.tv_sec - 1;
+    atomic_store_explicit(&H->clock_hand, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->ttl_live, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->expired, 0, memory_order_relaxed);
+    atomic_store_explicit(&H->evicted, 0, memory_order_relaxed);
+
+    // Value arena: empty free lists; classes 64 B doubling up to the top class.
+    H->val_top_sz = (uint32_t)top_sz;
+    H->val_classes = 1;
+    while ((64ull << (H->val_classes - 1)) < top_sz) H->val_classes++;
+    for (size_t c = 0; c < SPLINTER_SIZE_CLASSES; c++)
+        atomic_store_explicit(&H->val_free[c], 0, memory_order_relaxed);
+    atomic_store_explicit(&H->val_inuse, 0, memory_order_relaxed);
+
+    // No bloom bit is bound to a signal group yet.
+    for (int b = 0; b < 64; b++)
+        atomic_store_explicit(&H->bloom_watches[b], 0xFF, memory_order_relaxed);
+
+    /*
+     * Slots are not touched: ftruncate() zero-filled them, and all-zero is an
+     * empty slot (hash 0, epoch 0, no extent). The one non-zero default, the
+     * VOID type, is applied when splinter_set() first claims the slot. Their
+     * pages are faulted in by the first write that lands there, not here.
+     */
+    spl_remember_name(name_or_path);
+    spl_trace_env();
     return 0;
 }
 
@@ -241,9 +393,16 @@ int splinter_open(const char *name_or_path) {
 #endif
     if (fd < 0) return -1;
     struct stat st;
-    if (fstat(fd, &st) != 0) return -1;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
     if (map_fd(fd, (size_t)st.st_size) != 0) return -1;
     if (H->magic != SPLINTER_MAGIC || H->version != SPLINTER_VER) return -1;
+    spl_remember_name(name_or_path);
+    spl_trace_env();
     return 0;
 }
 
@@ -275,6 +434,7 @@ int splinter_open_or_create(const char *name_or_path, size_t slots, size_t max_v
 
 int splinter_set_mop(unsigned int mode) {
     if (!H) return -2;
+    spl_follow_resize();
     switch (mode) {
         case 0:
             atomic_fetch_and(&H->core_flags, ~(SPL_SYS_AUTO_SCRUB | SPL_SYS_HYBRID_SCRUB));
@@ -294,288 +454,2176 @@ int splinter_set_mop(unsigned int mode) {
 
 int splinter_get_mop(void) {
     if (!H) return -2;
+    spl_follow_resize();
     if (splinter_config_test(H, SPL_SYS_HYBRID_SCRUB)) return 1;
     if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) return 2;
     return 0;
 }
 
-void splinter_purge(void) {
-    if (!H || !S || !VALUES) return;
-    for (uint32_t i = 0; i < H->slots; ++i) {
-        struct splinter_slot *slot = &S[i];
-        uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-        if (e & 1ull) continue;
-        if (!atomic_compare_exchange_strong(&slot->epoch, &e, e + 1)) continue;
-        uint32_t len = atomic_load_explicit(&slot->val_len, memory_order_relaxed);
-        uint8_t *dst = VALUES + slot->val_off;
-        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == 0) {
-            memset(dst, 0, H->max_val_sz);
-        } else if (len < H->max_val_sz) {
-            memset(dst + len, 0, H->max_val_sz - len);
+/** @brief Extents at least this wide are zeroed with non-temporal stores. */
+#define SPL_NT_MIN 4096u
+
+/** @brief Slots purge visits between clock reads. */
+#define SPL_PURGE_STRIDE 64u
+
+/**
+ * @brief memset(dst, 0, len) that bypasses the cache for large runs, so a
+ * purge does not push the readers' working set out of it. Stores issued here
+ * are weakly ordered: the caller must spl_zero_fence() before publishing.
+ */
+static void spl_zero_nt(uint8_t *dst, size_t len) {
+#if defined(__x86_64__) && defined(__SSE2__)
+    if (len >= SPL_NT_MIN) {
+        size_t head = (size_t)(-(uintptr_t)dst & 15u);
+        memset(dst, 0, head);
+        dst += head; len -= head;
+        const __m128i z = _mm_setzero_si128();
+        for (; len >= 64; dst += 64, len -= 64) {
+            _mm_stream_si128((__m128i *)dst, z);
+            _mm_stream_si128((__m128i *)(dst + 16), z);
+            _mm_stream_si128((__m128i *)(dst + 32), z);
+            _mm_stream_si128((__m128i *)(dst + 48), z);
         }
-        atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
     }
+#endif
+    memset(dst, 0, len);
 }
 
-void splinter_close(void) {
-    if (g_event_fd >= 0) { close(g_event_fd); g_event_fd = -1; }
-    if (g_base) munmap(g_base, g_total_sz);
-    g_base = NULL; H = NULL; S = NULL; VALUES = NULL; g_total_sz = 0;
+/** @brief Order spl_zero_nt() stores before the seqlock release that follows. */
+static inline void spl_zero_fence(void) {
+#if defined(__x86_64__) && defined(__SSE2__)
+    _mm_sfence();
+#endif
 }
 
-int splinter_unset(const char *key) {
-    if (!H || !key) return -2;
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots);
-    size_t i;
-    for (i = 0; i < H->slots; ++i) {
-        struct splinter_slot *slot = &S[(idx + i) % H->slots];
-        uint64_t slot_hash = atomic_load_explicit(&slot->hash, memory_order_acquire);
-        if (slot_hash == h && strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
-            uint64_t start_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-            if (start_epoch & 1) { errno = EAGAIN; return -1; }
-            int ret = (int)atomic_load_explicit(&slot->val_len, memory_order_acquire);
-            atomic_store_explicit(&slot->hash, 0, memory_order_release);
-            if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) {
-                memset(VALUES + slot->val_off, 0, H->max_val_sz);
-                memset(slot->key, 0, SPLINTER_KEY_MAX);
-            } else {
-                slot->key[0] = '\0';
+/** @brief Upper bound of a cursor's range in the current store. */
+static inline uint64_t spl_cursor_end(const splinter_cursor_t *cursor) {
+    return (cursor->end && cursor->end < H->slots) ? cursor->end : H->slots;
+}
+
+/**
+ * @brief Scrub one slot's stale bytes, unless it is mid-write, has no
+ * extent, or is still as clean as the last purge left it.
+ */
+static void spl_purge_slot(size_t i) {
+    struct splinter_slot *slot = &S[i];
+    uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+    if (e & 1ull) return;
+    if (e == atomic_load_explicit(&AUX[i].scrubbed, memory_order_relaxed)) return;
+    if (!spl_slot_extent(slot)) return;
+    if (!atomic_compare_exchange_strong(&slot->epoch, &e, e + 1)) return;
+    uint32_t len = atomic_load_explicit(&slot->val_len, memory_order_relaxed);
+    uint32_t extent = spl_slot_extent(slot);
+    uint8_t *dst = VALUES + slot->val_off;
+    if (extent == 0) {
+        // Released between the check and the CAS; nothing to scrub.
+    } else if (atomic_load_explicit(&slot->hash, memory_order_acquire) == 0) {
+        spl_zero_nt(dst, extent);
+    } else if (spl_slot_chained(slot)) {
+        spl_chain_scrub_tail(slot, len);
+    } else if (len < extent) {
+        spl_zero_nt(dst + len, extent - len);
+    }
+    spl_zero_fence();
+    atomic_store_explicit(&AUX[i].scrubbed, e + 2, memory_order_relaxed);
+    atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+}
+
+int splinter_purge_step(splinter_cursor_t *cursor, uint64_t budget_ns) {
+    if (!H || !S || !VALUES || !cursor) return -2;
+    spl_follow_resize();
+    const uint64_t n = spl_cursor_end(cursor);
+    struct timespec ts;
+    uint64_t deadline = 0;
+    if (budget_ns) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        deadline = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec + budget_ns;
+    }
+    uint64_t i = cursor->next;
+    while (i < n) {
+        spl_purge_slot((size_t)i++);
+        if (deadline && i % SPL_PURGE_STRIDE == 0 && i < n) {
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            if ((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec >= deadline) {
+                cursor->next = i;
+                return 1;
             }
-            atomic_store_explicit(&slot->type_flag, 0, memory_order_release);
-            atomic_fetch_or(&slot->type_flag, SPL_SLOT_DEFAULT_TYPE);
-            atomic_store_explicit(&slot->epoch, 0, memory_order_release);
-            atomic_store_explicit(&slot->val_len, 0, memory_order_release);
-#ifdef SPLINTER_EMBEDDINGS
-            // This is necessary or overwrites may leave garbage at the end.
-            memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
-#endif
-            atomic_store_explicit(&slot->ctime, 0, memory_order_release);
-            atomic_store_explicit(&slot->atime, 0, memory_order_release);
-            atomic_store_explicit(&slot->user_flag, 0, memory_order_release);
-            atomic_store_explicit(&slot->watcher_mask, 0, memory_order_release);
-            atomic_store_explicit(&slot->bloom, 0, memory_order_release);
-            atomic_fetch_add_explicit(&slot->epoch, 2, memory_order_release);
-            return ret;
         }
     }
-    return -1;
+    cursor->next = n;
+    return 0;
 }
 
-int splinter_set(const char *key, const void *val, size_t len) {
-    if (!H || !key) return -2;
-    if (len == 0 || len > H->max_val_sz) return -1;
+void splinter_purge(void) {
+    splinter_cursor_t cursor = { 0 };
+    splinter_purge_step(&cursor, 0);
+}
 
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots);
-    const size_t arena_sz = (size_t)H->slots * (size_t)H->max_val_sz;
+void splinter_close(void) {
+    int saved_errno = errno;
+    splinter_trace_stop();  /* no-op (EINVAL) unless tracing */
+    errno = saved_errno;
+    if (g_event_fd >= 0) { close(g_event_fd); g_event_fd = -1; }
+    spl_madv_bus_close();
+    if (g_base) munmap(g_base, g_total_sz);
+    if (g_retired_base) munmap(g_retired_base, g_retired_sz);
+    g_retired_base = NULL; g_retired_sz = 0;
+    g_base = NULL; H = NULL; S = NULL; IX = NULL; AUX = NULL; OCC = NULL; VALUES = NULL;
+    g_total_sz = 0;
+}
 
-    for (size_t i = 0; i < H->slots; ++i) {
-        struct splinter_slot *slot = &S[(idx + i) % H->slots];
-        uint64_t slot_hash = atomic_load_explicit(&slot->hash, memory_order_acquire);
+/*
+ * Value arena allocator
+ * ---------------------
+ * Size-class slabs over the VALUES arena. Each class has a Treiber stack of
+ * free extents whose head (in the header) carries an ABA tag next to the
+ * link, so a pop that raced a pop+push of the same extent fails its CAS
+ * instead of corrupting the list. A free extent's first four bytes hold the
+ * next link and the rest is zero: extents are scrubbed as they are freed, so
+ * an unset, shrunk or relocated value never lingers in the arena, whatever
+ * the mop mode. When a class's stack is empty the extent is carved from val_brk.
+ * Links count 64-byte units (offset / 64 + 1, 0 = end), which is what lets a
+ * 32-bit link reach every extent of an arena up to SPL_ARENA_MAX.
+ *
+ * Extents belong to exactly one slot and only change hands while that slot
+ * is held odd, so a reader that copies from an extent which is freed and
+ * reused under it always sees the slot epoch move and retries.
+ */
 
-        if (slot_hash == 0 || (slot_hash == h && strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0)) {
-            uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
-            if (e & 1ull) continue;
+/** @brief CLOCK sweeps a set may run to find arena space before ENOSPC. */
+#define SPL_RESERVE_RETRIES 16
 
-            if (!atomic_compare_exchange_weak_explicit(&slot->epoch, &e, e + 1,
-                                                      memory_order_acq_rel, memory_order_relaxed)) {
-                continue;
-            }
+/** @brief Extent size of size class c. */
+static inline uint32_t spl_cls_size(unsigned c) {
+    return (c + 1 >= H->val_classes) ? H->val_top_sz : (64u << c);
+}
 
-            if ((size_t)slot->val_off >= arena_sz || (size_t)slot->val_off + len > arena_sz) {
-                atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
-                return -1;
-            }
+/** @brief Smallest size class whose extents hold len bytes. */
+static inline unsigned spl_cls_for(size_t len) {
+    unsigned c = 0;
+    while (c + 1 < H->val_classes && ((size_t)64 << c) < len) c++;
+    return c;
+}
 
-            uint8_t *dst = (uint8_t *)VALUES + slot->val_off;
+/** @brief Link word stored at the head of a free extent. */
+static inline atomic_uint_least32_t *spl_extent_link(uint64_t off) {
+    return (atomic_uint_least32_t *)(VALUES + off);
+}
 
-            if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) {
-                if (splinter_config_test(H, SPL_SYS_HYBRID_SCRUB)) {
-                    size_t scrub_len = (len + 63) & ~63;
-                    if (scrub_len > H->max_val_sz) scrub_len = H->max_val_sz;
-                    memset(dst, 0, scrub_len);
-                } else {
-                    memset(dst, 0, H->max_val_sz);
-                }
-            }
-            
-            memcpy(dst, val, len);
-            atomic_store_explicit(&slot->val_len, (uint32_t)len, memory_order_release);
+/**
+ * @brief Take an extent of class c from its free stack, else from the bump pointer.
+ * @return byte offset into VALUES, or -1 if the arena is exhausted.
+ */
+static int64_t spl_extent_alloc(unsigned c) {
+    const uint32_t sz = spl_cls_size(c);
+    uint64_t head = atomic_load_explicit(&H->val_free[c], memory_order_acquire);
+
+    while ((uint32_t)head != 0) {
+        uint64_t off = (uint64_t)((uint32_t)head - 1) * 64u;
+        uint32_t next = atomic_load_explicit(spl_extent_link(off), memory_order_relaxed);
+        uint64_t want = (((head >> 32) + 1) << 32) | next;
+        if (atomic_compare_exchange_weak_explicit(&H->val_free[c], &head, want,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            atomic_fetch_add_explicit(&H->val_inuse, sz, memory_order_relaxed);
+            return off;
+        }
+    }
 
-#ifdef SPLINTER_EMBEDDINGS
-            // Don't let previous embeddings hang around between writes
-            if (slot_hash == 0) {
-                memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
-            }
-#endif
+    uint64_t brk = atomic_load_explicit(&H->val_brk, memory_order_relaxed);
+    do {
+        if (brk + sz > H->val_sz) return -1;
+    } while (!atomic_compare_exchange_weak_explicit(&H->val_brk, &brk, brk + sz,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    atomic_fetch_add_explicit(&H->val_inuse, sz, memory_order_relaxed);
+    return (int64_t)brk;
+}
 
-            slot->key[0] = '\0';
-            strncpy(slot->key, key, SPLINTER_KEY_MAX - 1);
-            slot->key[SPLINTER_KEY_MAX - 1] = '\0';
+/** @brief Zero the extent at off and push it back on class c's free stack. */
+static void spl_extent_free(uint64_t off, unsigned c) {
+    spl_zero_nt(VALUES + off, spl_cls_size(c));
+    spl_zero_fence();
+    uint64_t head = atomic_load_explicit(&H->val_free[c], memory_order_relaxed);
+    uint64_t want;
+    do {
+        atomic_store_explicit(spl_extent_link(off), (uint32_t)head, memory_order_relaxed);
+        want = (((head >> 32) + 1) << 32) | (uint32_t)(off / 64u + 1);
+    } while (!atomic_compare_exchange_weak_explicit(&H->val_free[c], &head, want,
+                                                    memory_order_release, memory_order_relaxed));
+    atomic_fetch_sub_explicit(&H->val_inuse, spl_cls_size(c), memory_order_relaxed);
+}
 
-            atomic_thread_fence(memory_order_release);
-            atomic_store_explicit(&slot->hash, h, memory_order_release);
-            atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
-            
-            splinter_pulse_watchers(slot);
-            atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
-            splinter_event_bus_notify((idx + i) % H->slots);
+/** @brief val_cls without the chained bit: the class of the extent at val_off, plus one. */
+#define SPL_CLS_MASK 0x7fu
 
-            return 0;
-        }
+/**
+ * @brief Make sure a plain slot (held odd by the caller) has an extent for len bytes.
+ * The current extent is kept when it fits and is at most one class too big;
+ * otherwise a right-sized one is allocated, the first keep bytes are carried
+ * over, and the old extent is freed. A shrink that finds the arena dry keeps
+ * the oversized extent rather than failing.
+ * @return 0 on success, -1 (errno ENOSPC) if the arena is exhausted.
+ */
+static int spl_slot_reserve(struct splinter_slot *slot, size_t len, size_t keep) {
+    unsigned want = spl_cls_for(len);
+    unsigned have = atomic_load_explicit(&slot->val_cls, memory_order_relaxed) & SPL_CLS_MASK;
+
+    if (have && have - 1 >= want && have - 1 <= want + 1) return 0;
+
+    int64_t off = spl_extent_alloc(want);
+    if (off < 0) {
+        if (have && have - 1 >= want) return 0;
+        errno = ENOSPC;
+        return -1;
     }
-    return -1;
+    if (have) {
+        if (keep) memcpy(VALUES + off, VALUES + slot->val_off, keep);
+        spl_extent_free(slot->val_off, have - 1);
+    }
+    slot->val_off = (uint64_t)off;
+    atomic_store_explicit(&slot->val_cls, (uint8_t)(want + 1), memory_order_release);
+    return 0;
 }
 
-int splinter_get(const char *key, void *buf, size_t buf_sz, size_t *out_sz) {
-    if (!H || !key) return -2;
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots);
+/** @brief Width of a slot's current extent (0 if it has none). */
+static inline uint32_t spl_slot_extent(const struct splinter_slot *slot) {
+    unsigned have = atomic_load_explicit(&slot->val_cls, memory_order_relaxed) & SPL_CLS_MASK;
+    return have ? spl_cls_size(have - 1) : 0;
+}
 
-    size_t i;
-    for (i = 0; i < H->slots; ++i) {
-        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+/*
+ * Chained values
+ * --------------
+ * With chaining on, a value longer than max_val_sz is spread over top-class
+ * segments. The slot's own extent then holds the segments' arena offsets in
+ * 64-byte units (uint32_t each, in value order; see spl_chain_seg()) and
+ * val_cls carries SPLINTER_VAL_CHAINED.
+ * Segments change only while the slot is held odd, like any extent, so the
+ * slot seqlock covers the whole chain. A descriptor is at most one top-class
+ * extent, which bounds a chain at val_top_sz / 4 segments (spl_chain_max).
+ */
 
-        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
-            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
-            uint64_t start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-            if (start & 1) { errno = EAGAIN; return -1; }
+static inline int spl_slot_chained(const struct splinter_slot *slot) {
+    return (atomic_load_explicit(&slot->val_cls, memory_order_relaxed) & SPLINTER_VAL_CHAINED) != 0;
+}
 
-            atomic_thread_fence(memory_order_acquire);
+/** @brief Segments needed to hold len bytes of chained value. */
+static inline uint32_t spl_chain_segs(size_t len) {
+    return (uint32_t)((len + H->val_top_sz - 1) / H->val_top_sz);
+}
 
-            size_t len = (size_t)atomic_load_explicit(&slot->val_len, memory_order_acquire);
-            if (out_sz) *out_sz = len;
+static inline uint32_t *spl_chain_desc(const struct splinter_slot *slot) {
+    return (uint32_t *)(VALUES + slot->val_off);
+}
 
-            if (buf) {
-                if (buf_sz < len) { errno = EMSGSIZE; return -1; }
-                memcpy(buf, VALUES + slot->val_off, len);
-            }
+/** @brief Arena offset of segment k of a descriptor. */
+static inline uint64_t spl_chain_seg(const uint32_t *desc, uint32_t k) {
+    return (uint64_t)desc[k] * 64u;
+}
 
-            atomic_thread_fence(memory_order_acquire);
-            uint64_t end = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-            if (start == end && !(end & 1)) return 0;
+/** @brief Descriptor entry for the segment at arena offset off. */
+static inline uint32_t spl_chain_unit(uint64_t off) {
+    return (uint32_t)(off / 64u);
+}
 
-            errno = EAGAIN;
-            return -1;
-        }
-    }
-    return -1;
+/** @brief Longest value a single descriptor can chain (val_len is 32-bit). */
+static uint64_t spl_chain_max(void) {
+    uint64_t m = (uint64_t)(H->val_top_sz / 4) * H->val_top_sz;
+    return m > UINT32_MAX ? UINT32_MAX : m;
 }
 
-int splinter_list(char **out_keys, size_t max_keys, size_t *out_count) {
-    if (!H || !out_keys || !out_count) return -2;
-    size_t count = 0, i;
-    for (i = 0; i < H->slots && count < max_keys; ++i) {
-        if (atomic_load_explicit(&S[i].hash, memory_order_acquire) &&
-            atomic_load_explicit(&S[i].val_len, memory_order_acquire) > 0) {
-            out_keys[count++] = S[i].key;
+/**
+ * @brief Give a slot (held odd by the caller) a chain of segments for total bytes.
+ * A chained slot keeps its segments, growing or trimming the list; a plain one
+ * turns a top-class extent into segment 0, or copies its first keep bytes into
+ * a fresh segment. If the arena runs dry nothing is changed.
+ * @return 0 on success, -1 (errno ENOSPC) if the arena is exhausted.
+ */
+static int spl_chain_resize(struct splinter_slot *slot, size_t total, size_t keep) {
+    const unsigned top = H->val_classes - 1;
+    const unsigned raw = atomic_load_explicit(&slot->val_cls, memory_order_relaxed);
+    const unsigned have = raw & SPL_CLS_MASK;
+    const int chained = (raw & SPLINTER_VAL_CHAINED) != 0;
+    const uint32_t n = spl_chain_segs(total);
+    const uint32_t n_old = chained
+        ? spl_chain_segs(atomic_load_explicit(&slot->val_len, memory_order_relaxed)) : 0;
+    const uint64_t old_off = slot->val_off;
+    uint32_t *old = chained ? spl_chain_desc(slot) : NULL;
+    unsigned dc = have - 1;
+    int64_t doff = (int64_t)old_off, seg;
+    uint32_t *desc, first_new, k;
+
+    if (chained && spl_cls_size(have - 1) >= (size_t)n * 4) {
+        desc = old;
+    } else {
+        dc = spl_cls_for((size_t)n * 4);
+        if ((doff = spl_extent_alloc(dc)) < 0) goto nospace;
+        desc = (uint32_t *)(VALUES + doff);
+        if (chained) memcpy(desc, old, (size_t)(n_old < n ? n_old : n) * 4);
+    }
+
+    first_new = n_old;
+    if (!chained && have) {
+        if (have - 1 == top) {
+            desc[0] = spl_chain_unit(old_off);
+        } else {
+            if ((seg = spl_extent_alloc(top)) < 0) goto undo_desc;
+            if (keep) memcpy(VALUES + seg, VALUES + old_off, keep);
+            desc[0] = spl_chain_unit((uint64_t)seg);
         }
+        first_new = 1;
     }
-    *out_count = count;
+    for (k = first_new; k < n; k++) {
+        if ((seg = spl_extent_alloc(top)) < 0) goto undo_segs;
+        desc[k] = spl_chain_unit((uint64_t)seg);
+    }
+
+    // Committed: trim what a shorter chain no longer needs, drop the old home.
+    for (k = n; k < n_old; k++) spl_extent_free(spl_chain_seg(old, k), top);
+    if (chained && desc != old) spl_extent_free(old_off, have - 1);
+    if (!chained && have && have - 1 != top) spl_extent_free(old_off, have - 1);
+    slot->val_off = (uint64_t)doff;
+    atomic_store_explicit(&slot->val_cls, (uint8_t)((dc + 1) | SPLINTER_VAL_CHAINED),
+                          memory_order_release);
     return 0;
+
+undo_segs:
+    while (k-- > first_new) spl_extent_free(spl_chain_seg(desc, k), top);
+    if (!chained && have && have - 1 != top) spl_extent_free(spl_chain_seg(desc, 0), top);
+undo_desc:
+    if (desc != old) spl_extent_free((uint64_t)doff, dc);
+nospace:
+    errno = ENOSPC;
+    return -1;
 }
 
-int splinter_poll(const char *key, uint64_t timeout_ms) {
-    if (!H || !key) return -2;
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots);
-    struct splinter_slot *slot = NULL;
-    size_t i;
-    for (i = 0; i < H->slots; ++i) {
-        struct splinter_slot *s = &S[(idx + i) % H->slots];
-        if (atomic_load_explicit(&s->hash, memory_order_acquire) == h &&
-            strncmp(s->key, key, SPLINTER_KEY_MAX) == 0) {
-            slot = s;
-            break;
-        }
-    }
-    if (!slot) return -1;
+/** @brief Turn a chained slot (held odd) plain again, keeping segment 0 as its extent. */
+static void spl_chain_collapse(struct splinter_slot *slot) {
+    const unsigned top = H->val_classes - 1;
+    const unsigned have = atomic_load_explicit(&slot->val_cls, memory_order_relaxed) & SPL_CLS_MASK;
+    const uint32_t *desc = spl_chain_desc(slot);
+    const uint32_t n = spl_chain_segs(atomic_load_explicit(&slot->val_len, memory_order_relaxed));
+    const uint64_t seg0 = spl_chain_seg(desc, 0);
+
+    for (uint32_t k = 1; k < n; k++) spl_extent_free(spl_chain_seg(desc, k), top);
+    spl_extent_free(slot->val_off, have - 1);
+    slot->val_off = seg0;
+    atomic_store_explicit(&slot->val_cls, (uint8_t)(top + 1), memory_order_release);
+}
 
-    uint64_t start_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-    if (start_epoch & 1) { errno = EAGAIN; return -1; }
+/** @brief Copy len bytes into a chained value (slot held odd) starting at byte at. */
+static void spl_chain_write(const struct splinter_slot *slot, size_t at,
+                            const void *src, size_t len) {
+    const uint32_t top = H->val_top_sz;
+    const uint32_t *desc = spl_chain_desc(slot);
+    const uint8_t *p = (const uint8_t *)src;
+    while (len) {
+        size_t o = at % top, run = top - o;
+        if (run > len) run = len;
+        memcpy(VALUES + spl_chain_seg(desc, (uint32_t)(at / top)) + o, p, run);
+        p += run; at += run; len -= run;
+    }
+}
 
-    struct timespec deadline;
-    clock_gettime(CLOCK_REALTIME, &deadline);
-    add_ms(&deadline, timeout_ms);
+/** @brief Zero the unused tail of a chained value's last segment. */
+static void spl_chain_scrub_tail(const struct splinter_slot *slot, size_t len) {
+    const uint32_t top = H->val_top_sz;
+    const uint32_t n = spl_chain_segs(len);
+    const size_t used = len - (size_t)(n - 1) * top;
+    if (used < top) memset(VALUES + spl_chain_seg(spl_chain_desc(slot), n - 1) + used, 0, top - used);
+}
 
-    struct timespec sleep_ts = {0, 10 * NS_PER_MS};
-    while (1) {
-        uint64_t cur_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-        if (cur_epoch & 1) { nanosleep(&sleep_ts, NULL); continue; }
-        if (cur_epoch != start_epoch) return 0;
-        struct timespec now;
-        clock_gettime(CLOCK_REALTIME, &now);
-        if ((now.tv_sec > deadline.tv_sec) ||
-            (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
-            errno = ETIMEDOUT;
-            return -1;
-        }
-        nanosleep(&sleep_ts, NULL);
+/**
+ * @brief Map a chained value for a reader that does not hold the slot.
+ * Offsets are read racily, so every one is bounds-checked; the caller's
+ * epoch check decides whether what it then read is real.
+ * @return segments mapped, or -1 if the chain looked torn (retry).
+ */
+static int spl_chain_map(uint64_t desc_off, size_t len, struct iovec *iov, int iovcnt) {
+    const uint32_t top = H->val_top_sz;
+    const uint32_t n = spl_chain_segs(len);
+    if ((int64_t)n > iovcnt || desc_off + (uint64_t)n * 4 > H->val_sz) return -1;
+    const uint32_t *desc = (const uint32_t *)(VALUES + desc_off);
+    for (uint32_t k = 0; k < n; k++) {
+        uint64_t seg = spl_chain_seg(desc, k);
+        if (seg + top > H->val_sz) return -1;
+        iov[k].iov_base = VALUES + seg;
+        iov[k].iov_len = (k + 1 < n) ? top : len - (size_t)k * top;
     }
+    return (int)n;
 }
 
-int splinter_get_header_snapshot(splinter_header_snapshot_t *snapshot) {
-    if (!H) return -2;
-    snapshot->magic = H->magic;
-    snapshot->version = H->version;
-    snapshot->slots = H->slots;
-    snapshot->max_val_sz = H->max_val_sz;
-    snapshot->core_flags = atomic_load_explicit(&H->core_flags, memory_order_acquire);
-    snapshot->user_flags = atomic_load_explicit(&H->user_flags, memory_order_acquire);
-    snapshot->epoch = atomic_load_explicit(&H->epoch, memory_order_acquire);
-    snapshot->parse_failures = atomic_load_explicit(&H->parse_failures, memory_order_relaxed);
-    snapshot->last_failure_epoch = atomic_load_explicit(&H->last_failure_epoch, memory_order_relaxed);
+/** @brief Reader-side copy of a chained value, checked like spl_chain_map(). */
+static int spl_chain_copy(uint64_t desc_off, size_t len, void *buf) {
+    const uint32_t top = H->val_top_sz;
+    const uint32_t n = spl_chain_segs(len);
+    if (desc_off + (uint64_t)n * 4 > H->val_sz) return -1;
+    const uint32_t *desc = (const uint32_t *)(VALUES + desc_off);
+    uint8_t *out = (uint8_t *)buf;
+    for (uint32_t k = 0; k < n; k++) {
+        uint64_t seg = spl_chain_seg(desc, k);
+        size_t run = (k + 1 < n) ? top : len - (size_t)k * top;
+        if (seg + top > H->val_sz) return -1;
+        memcpy(out + (size_t)k * top, VALUES + seg, run);
+    }
     return 0;
 }
 
-int splinter_get_slot_snapshot(const char *key, splinter_slot_snapshot_t *snapshot) {
-    if (!H || !key || !snapshot) return -2;
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots), i = 0;
-    for (i = 0; i < H->slots; ++i) {
-        struct splinter_slot *slot = &S[(idx + i) % H->slots];
-        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
-            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
-            uint64_t start = 0, end = 0;
-            do {
-                start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-                if (start & 1) continue;
-                snapshot->hash = h;
-                snapshot->epoch = start;
-                snapshot->val_off = slot->val_off;
-                snapshot->val_len = atomic_load_explicit(&slot->val_len, memory_order_relaxed);
-                snapshot->type_flag = atomic_load_explicit(&slot->type_flag, memory_order_acquire);
-                snapshot->user_flag = atomic_load_explicit(&slot->user_flag, memory_order_acquire);
-                snapshot->ctime = atomic_load_explicit(&slot->ctime, memory_order_acquire);
-                snapshot->atime = atomic_load_explicit(&slot->atime, memory_order_acquire);
-                snapshot->bloom = atomic_load_explicit(&slot->bloom, memory_order_acquire);
-                strncpy(snapshot->key, slot->key, SPLINTER_KEY_MAX);
-#ifdef SPLINTER_EMBEDDINGS                
-                memcpy(snapshot->embedding, slot->embedding, sizeof(float) * SPLINTER_EMBED_DIM);
-#endif
-                atomic_thread_fence(memory_order_acquire);
-                end = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-            } while (start != end);
-            return 0;
-        }
+/**
+ * @brief Return a slot's extent (if any) to its class, and a chained value's
+ * segments with it. Caller holds the slot odd.
+ */
+static void spl_slot_release(struct splinter_slot *slot) {
+    unsigned raw = atomic_load_explicit(&slot->val_cls, memory_order_relaxed);
+    unsigned have = raw & SPL_CLS_MASK;
+    if (!have) return;
+    if (raw & SPLINTER_VAL_CHAINED) {
+        const unsigned top = H->val_classes - 1;
+        const uint32_t *desc = spl_chain_desc(slot);
+        uint32_t n = spl_chain_segs(atomic_load_explicit(&slot->val_len, memory_order_relaxed));
+        for (uint32_t k = 0; k < n; k++) spl_extent_free(spl_chain_seg(desc, k), top);
     }
-    return -1;
+    atomic_store_explicit(&slot->val_cls, 0, memory_order_release);
+    spl_extent_free(slot->val_off, have - 1);
+    slot->val_off = 0;
 }
 
-#ifdef SPLINTER_EMBEDDINGS
-int splinter_set_embedding(const char *key, const float *vec) {
-    if (!H || !key || !vec) return -2;
-    uint64_t h = fnv1a(key);
-    size_t idx = slot_idx(h, H->slots);
+/*
+ * Occupancy bitmap
+ * ----------------
+ * One bit per slot, raised when splinter_set() gives a slot its key and
+ * dropped when unset or reclaim takes it away, both while the slot is held
+ * odd. Traversals walk the words instead of every slot; a set bit is a hint
+ * to look, the slot's own hash and seqlock remain the truth.
+ */
+
+static inline void spl_occ_set(size_t i) {
+    atomic_fetch_or_explicit(&OCC[i / 64], 1ull << (i % 64), memory_order_release);
+}
+
+static inline void spl_occ_clear(size_t i) {
+    atomic_fetch_and_explicit(&OCC[i / 64], ~(1ull << (i % 64)), memory_order_release);
+}
+
+/*
+ * Slots a running resize has already copied (see "Online resize") still
+ * serve reads, but a write to one would never reach the new store. Writers
+ * check right after taking the seqlock, and back out -- unless the copier has
+ * died, in which case the writer settles the resize (spl_resize_reap()) and
+ * carries on.
+ */
+
+/** @brief Attempts spl_slot_hold() makes on a slot held mid-write. */
+#define SPL_HOLD_SPINS 1024u
+
+/**
+ * @brief 1 if pid names a process that no longer runs: gone, or a zombie,
+ * which still answers kill() and stays until its parent (or an init that may
+ * never get to it) reaps it.
+ */
+static int spl_pid_dead(int32_t pid) {
+    if (pid <= 0) return 0;
+    if (kill((pid_t)pid, 0) != 0) return errno == ESRCH;
+    char path[32], buf[128];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = '\0';
+    // "pid (comm) state ..."; comm may hold spaces or parentheses.
+    const char *end = strrchr(buf, ')');
+    return end && end[1] == ' ' && (end[2] == 'Z' || end[2] == 'X');
+}
+
+/** @brief 1 if a running resize has already copied slot. */
+static inline int spl_slot_migrated(const struct splinter_slot *slot) {
+    return atomic_load_explicit(&H->resizing, memory_order_acquire) &&
+           (uint64_t)(slot - S) < atomic_load_explicit(&H->resize_front, memory_order_acquire);
+}
+
+/**
+ * @brief Call right after taking slot's seqlock at e. If the slot was already
+ * copied by a live resize, put the seqlock back as it was (nothing was
+ * written) and return 1.
+ */
+static inline int spl_slot_backout(struct splinter_slot *slot, uint64_t e) {
+    if (!spl_slot_migrated(slot) || spl_resize_reap()) return 0;
+    atomic_store_explicit(&slot->epoch, e, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Hold slot's seqlock for a metadata write (labels, watches, times)
+ * that leaves the epoch where it was; release with spl_slot_unhold().
+ * @return 0 holding it at *out_e, -1 (EAGAIN) if it stayed mid-write or a
+ * running resize has already copied it.
+ */
+static int spl_slot_hold(struct splinter_slot *slot, uint64_t *out_e) {
+    for (uint32_t spins = 0; spins < SPL_HOLD_SPINS; spins++) {
+        uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+        if (!(e & 1ull) &&
+            atomic_compare_exchange_weak_explicit(&slot->epoch, &e, e + 1,
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            if (spl_slot_backout(slot, e)) break;
+            *out_e = e;
+            return 0;
+        }
+        sched_yield();
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+static inline void spl_slot_unhold(struct splinter_slot *slot, uint64_t e) {
+    atomic_store_explicit(&slot->epoch, e, memory_order_release);
+}
+
+/*
+ * Cache residence: TTL expiry and CLOCK eviction
+ * ----------------------------------------------
+ * Both reclaim a slot exactly the way splinter_unset() frees it, but only
+ * after winning the slot's seqlock from the even epoch the caller observed.
+ * Losing that race just means a writer got there first -- the slot is live,
+ * so it is not our victim.
+ */
+
+/** @brief Seconds since H->ttl_base, from the coarse (vDSO, no syscall) clock. */
+static inline uint32_t spl_ttl_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec - H->ttl_base);
+}
+
+/**
+ * @brief Set slot i's expiry stamp (0 = none), keeping H->ttl_live in step.
+ * Caller holds the slot odd, so the load and store do not race.
+ */
+static inline void spl_slot_set_expiry(size_t i, uint32_t exp) {
+    uint32_t old = atomic_load_explicit(&AUX[i].expires, memory_order_relaxed);
+    atomic_store_explicit(&AUX[i].expires, exp, memory_order_relaxed);
+    if (!old && exp) atomic_fetch_add_explicit(&H->ttl_live, 1, memory_order_relaxed);
+    else if (old && !exp) atomic_fetch_sub_explicit(&H->ttl_live, 1, memory_order_relaxed);
+}
+
+/** @brief 1 if slot i carries a TTL that has lapsed. Reads no clock otherwise. */
+static inline int spl_slot_expired(size_t i) {
+    uint32_t exp = atomic_load_explicit(&AUX[i].expires, memory_order_relaxed);
+    return exp != 0 && spl_ttl_now() >= exp;
+}
+
+/*
+ * AUX heat byte (splinter_tier_pass): TOUCHED is set by any access while
+ * tiering is on, COLD once a pass has advised the value out, and the low
+ * bits count the passes since the slot was last touched.
+ */
+#define SPL_HEAT_TOUCHED 0x80u
+#define SPL_HEAT_COLD    0x40u
+#define SPL_HEAT_IDLE    0x3Fu
+
+/**
+ * @brief Set the CLOCK reference bit and the tiering touched bit for slot i,
+ * without dirtying the line if already set.
+ */
+static inline void spl_slot_touch(size_t i) {
+    if (splinter_config_test(H, SPL_SYS_EVICT) &&
+        !atomic_load_explicit(&AUX[i].ref, memory_order_relaxed))
+        atomic_store_explicit(&AUX[i].ref, 1, memory_order_relaxed);
+    if (atomic_load_explicit(&H->tier_on, memory_order_relaxed) &&
+        !(atomic_load_explicit(&AUX[i].heat, memory_order_relaxed) & SPL_HEAT_TOUCHED))
+        atomic_fetch_or_explicit(&AUX[i].heat, SPL_HEAT_TOUCHED, memory_order_relaxed);
+}
+
+/**
+ * @brief Free slot i if it is still at (even) epoch e.
+ * @return 0 if the slot was reclaimed, -1 if it was busy or already empty.
+ */
+static int spl_reclaim_slot(size_t i, uint64_t e) {
+    struct splinter_slot *slot = &S[i];
+    if ((e & 1ull) ||
+        !atomic_compare_exchange_strong_explicit(&slot->epoch, &e, e + 1,
+                                                 memory_order_acq_rel, memory_order_relaxed))
+        return -1;
+    if (spl_slot_backout(slot, e)) return -1;
+    if (atomic_load_explicit(&slot->hash, memory_order_acquire) == 0) {
+        atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+        return -1;
+    }
+
+    int ix_skipped = splinter_config_test(H, SPL_SYS_KEY_INDEX) && spl_index_remove((uint32_t)i);
+    atomic_store_explicit(&slot->hash, 0, memory_order_release);
+    if (ix_skipped) spl_index_remove_settle((uint32_t)i);
+    spl_occ_clear(i);
+    spl_slot_release(slot);
+    if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) {
+        memset(slot->key, 0, SPLINTER_KEY_MAX);
+    } else {
+        slot->key[0] = '\0';
+    }
+    atomic_store_explicit(&slot->type_flag, SPL_SLOT_DEFAULT_TYPE, memory_order_release);
+    atomic_store_explicit(&slot->val_len, 0, memory_order_release);
+#ifdef SPLINTER_EMBEDDINGS
+    memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
+#endif
+    atomic_store_explicit(&slot->ctime, 0, memory_order_release);
+    atomic_store_explicit(&slot->atime, 0, memory_order_release);
+    atomic_store_explicit(&slot->user_flag, 0, memory_order_release);
+    atomic_store_explicit(&slot->watcher_mask, 0, memory_order_release);
+    atomic_store_explicit(&slot->bloom, 0, memory_order_release);
+    spl_slot_set_expiry(i, 0);
+    atomic_store_explicit(&AUX[i].tomb, 1, memory_order_relaxed);
+    atomic_store_explicit(&AUX[i].ref, 0, memory_order_relaxed);
+    atomic_store_explicit(&AUX[i].heat, 0, memory_order_relaxed);
+    atomic_store_explicit(&AUX[i].scrubbed, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+    return 0;
+}
+
+/** @brief Lazily reclaim an expired slot found by a lookup, counting it. */
+static void spl_expire_slot(size_t i, uint64_t e) {
+    if (spl_reclaim_slot(i, e) == 0)
+        atomic_fetch_add_explicit(&H->expired, 1, memory_order_relaxed);
+}
+
+/** @brief Slots the CLOCK hand claims per shared fetch_add. */
+#define SPL_CLOCK_BATCH 64u
+
+/**
+ * @brief Advance the shared CLOCK hand until one slot is freed.
+ * Expired slots are always fair game; live ones only when eviction is on,
+ * and then never if odd (mid-write) or labelled (bloom != 0), and only after
+ * their reference bit has had its second chance. When sweeping for arena
+ * space (for_space), an already-empty slot frees nothing and is passed over.
+ * With eviction off and no TTL set anywhere nothing can be freed, so it
+ * returns at once. The hand moves SPL_CLOCK_BATCH slots at a time, so
+ * concurrent sweepers share one cache line far less often.
+ * @return 0 once a slot is free, -1 if a full pass freed nothing.
+ */
+static int spl_clock_sweep(int for_space) {
+    const int evict = splinter_config_test(H, SPL_SYS_EVICT);
+    if (!evict && atomic_load_explicit(&H->ttl_live, memory_order_relaxed) == 0) return -1;
+
+    const uint32_t n = H->slots;
+    const uint32_t now = spl_ttl_now();
+    const uint32_t budget = evict ? 2 * n : n;
+    const uint32_t batch = n < SPL_CLOCK_BATCH ? n : SPL_CLOCK_BATCH;
+    uint32_t hand = 0;
+
+    for (uint32_t step = 0; step < budget; step++) {
+        if (step % batch == 0)
+            hand = atomic_fetch_add_explicit(&H->clock_hand, batch, memory_order_relaxed);
+        size_t i = (hand + step % batch) % n;
+        struct splinter_slot *slot = &S[i];
+        uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+        if (e & 1ull) continue;
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == 0) {
+            if (for_space) continue;
+            return 0;
+        }
+
+        uint32_t exp = atomic_load_explicit(&AUX[i].expires, memory_order_relaxed);
+        if (exp != 0 && now >= exp) {
+            if (spl_reclaim_slot(i, e) == 0) {
+                atomic_fetch_add_explicit(&H->expired, 1, memory_order_relaxed);
+                return 0;
+            }
+            continue;
+        }
+        if (!evict) continue;
+        if (atomic_load_explicit(&slot->bloom, memory_order_acquire) != 0) continue;
+        if (atomic_load_explicit(&AUX[i].ref, memory_order_relaxed)) {
+            atomic_store_explicit(&AUX[i].ref, 0, memory_order_relaxed);
+            continue;
+        }
+        if (spl_reclaim_slot(i, e) == 0) {
+            atomic_fetch_add_explicit(&H->evicted, 1, memory_order_relaxed);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int splinter_set_ttl(const char *key, uint32_t ttl_sec) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    for (size_t i = 0; i < H->slots; ++i) {
+        size_t n = (idx + i) % H->slots;
+        struct splinter_slot *slot = &S[n];
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            if (e & 1ull) { errno = EAGAIN; return -1; }
+            if (spl_slot_expired(n)) { spl_expire_slot(n, e); errno = ENOENT; return -1; }
+            if (!atomic_compare_exchange_strong(&slot->epoch, &e, e + 1)) {
+                errno = EAGAIN; return -1;
+            }
+            if (spl_slot_backout(slot, e)) { errno = EAGAIN; return -1; }
+            // The key may have been replaced between the match and the CAS.
+            if (atomic_load_explicit(&slot->hash, memory_order_acquire) != h ||
+                strncmp(slot->key, key, SPLINTER_KEY_MAX) != 0) {
+                atomic_store_explicit(&slot->epoch, e, memory_order_release);
+                continue;
+            }
+            spl_slot_set_expiry(n, ttl_sec ? spl_ttl_now() + ttl_sec : 0);
+            atomic_store_explicit(&slot->epoch, e + 2, memory_order_release);
+            return 0;
+        }
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+int64_t splinter_get_ttl(const char *key) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    for (size_t i = 0; i < H->slots; ++i) {
+        size_t n = (idx + i) % H->slots;
+        struct splinter_slot *slot = &S[n];
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint32_t exp = atomic_load_explicit(&AUX[n].expires, memory_order_relaxed);
+            if (exp == 0) return 0;
+            uint32_t now = spl_ttl_now();
+            if (now >= exp) { errno = ENOENT; return -1; }
+            return (int64_t)(exp - now);
+        }
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+int splinter_expire_sweep(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    int reaped = 0;
+    const uint32_t now = spl_ttl_now();
+    for (uint32_t i = 0; i < H->slots; i++) {
+        uint32_t exp = atomic_load_explicit(&AUX[i].expires, memory_order_relaxed);
+        if (exp == 0 || now < exp) continue;
+        uint64_t e = atomic_load_explicit(&S[i].epoch, memory_order_acquire);
+        if (spl_reclaim_slot(i, e) == 0) {
+            atomic_fetch_add_explicit(&H->expired, 1, memory_order_relaxed);
+            reaped++;
+        }
+    }
+    return reaped;
+}
+
+int splinter_set_eviction(unsigned int on) {
+    if (!H) return -2;
+    spl_follow_resize();
+    if (on) splinter_config_set(H, SPL_SYS_EVICT);
+    else splinter_config_clear(H, SPL_SYS_EVICT);
+    return 0;
+}
+
+int splinter_get_eviction(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    return splinter_config_test(H, SPL_SYS_EVICT) ? 1 : 0;
+}
+
+int splinter_set_tiering(unsigned int on) {
+    if (!H) return -2;
+    spl_follow_resize();
+    atomic_store_explicit(&H->tier_on, on ? 1 : 0, memory_order_relaxed);
+    return 0;
+}
+
+int splinter_get_tiering(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    return atomic_load_explicit(&H->tier_on, memory_order_relaxed) ? 1 : 0;
+}
+
+int splinter_set_chaining(unsigned int on) {
+    if (!H) return -2;
+    spl_follow_resize();
+    atomic_store_explicit(&H->val_chain, on ? 1 : 0, memory_order_relaxed);
+    return 0;
+}
+
+int splinter_get_chaining(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    return atomic_load_explicit(&H->val_chain, memory_order_relaxed) ? 1 : 0;
+}
+
+/*
+ * Operation counters
+ * ------------------
+ * Opt-in (H->stats_on). A thread adds to the stripe of the CPU it first
+ * counted on and keeps it, which spares a sched_getcpu() per call; stripes
+ * are whole cache lines, so only threads that started on the same CPU share
+ * one. Readers sum the stripes. Off, each hook is a single relaxed load.
+ */
+static _Thread_local int t_stats_stripe = -1;
+
+static inline struct splinter_stats_stripe *spl_stats(void) {
+    if (!atomic_load_explicit(&H->stats_on, memory_order_relaxed)) return NULL;
+    if (t_stats_stripe < 0) {
+        int cpu = sched_getcpu();
+        t_stats_stripe = (cpu < 0 ? 0 : cpu) % SPLINTER_STATS_STRIPES;
+    }
+    return &H->stats[t_stats_stripe];
+}
+
+#define SPL_STAT_ADD(field) do {                                              \
+        struct splinter_stats_stripe *st_ = spl_stats();                      \
+        if (st_) atomic_fetch_add_explicit(&st_->field, 1, memory_order_relaxed); \
+    } while (0)
+
+/** @brief Count a lookup that found its slot n slots past home. */
+static inline void spl_stat_probe(size_t n) {
+    struct splinter_stats_stripe *st = spl_stats();
+    if (!st) return;
+    unsigned b = n ? 64u - (unsigned)__builtin_clzll((unsigned long long)n) : 0;
+    if (b >= SPLINTER_PROBE_BUCKETS) b = SPLINTER_PROBE_BUCKETS - 1;
+    atomic_fetch_add_explicit(&st->probe[b], 1, memory_order_relaxed);
+}
+
+/** @brief Fail with EAGAIN, counting it. */
+static inline int spl_stat_eagain(void) {
+    SPL_STAT_ADD(eagain);
+    errno = EAGAIN;
+    return -1;
+}
+
+/*
+ * USDT probes
+ * -----------
+ * Built with WITH_USDT (HAVE_SDT), every probe below is a single nop in the
+ * "splinter" provider until bpftrace or perf attaches to it. Key calls fire
+ * <call>__entry with the key and length, and <call>__return with the result,
+ * key hash, physical slot (-1 if none was reached), slot epoch and the number
+ * of in-call retries; the lookup fills those in through t_probe as it goes.
+ * Without HAVE_SDT all of it compiles away. scripts/bpftrace has examples.
+ */
+#ifdef HAVE_SDT
+static _Thread_local struct {
+    uint64_t hash;
+    int64_t  slot;
+    uint64_t epoch;
+    uint32_t retries;
+} t_probe;
+
+#define SPL_PROBE(name, ...)   STAP_PROBEV(splinter, name, __VA_ARGS__)
+#define SPL_PROBE_ENTRY(name, ...) do {                                       \
+        t_probe.hash = 0; t_probe.slot = -1;                                  \
+        t_probe.epoch = 0; t_probe.retries = 0;                               \
+        SPL_PROBE(name, __VA_ARGS__);                                         \
+    } while (0)
+#define SPL_PROBE_KEY(h)       (t_probe.hash = (h))
+#define SPL_PROBE_SLOT(i, e)   (t_probe.slot = (int64_t)(i), t_probe.epoch = (e))
+#define SPL_PROBE_RETRY()      (t_probe.retries++)
+#define SPL_PROBE_RETURN(name, rc) \
+    SPL_PROBE(name, rc, t_probe.hash, t_probe.slot, t_probe.epoch, t_probe.retries)
+#else
+#define SPL_PROBE(name, ...)       ((void)0)
+#define SPL_PROBE_ENTRY(name, ...) ((void)0)
+#define SPL_PROBE_KEY(h)           ((void)0)
+#define SPL_PROBE_SLOT(i, e)       ((void)0)
+#define SPL_PROBE_RETRY()          ((void)0)
+#define SPL_PROBE_RETURN(name, rc) ((void)0)
+#endif
+
+int splinter_set_stats(unsigned int on) {
+    if (!H) return -2;
+    spl_follow_resize();
+    atomic_store_explicit(&H->stats_on, on ? 1 : 0, memory_order_relaxed);
+    return 0;
+}
+
+int splinter_get_stats(splinter_stats_t *out) {
+    if (!H || !out) return -2;
+    spl_follow_resize();
+    memset(out, 0, sizeof(*out));
+    out->enabled = atomic_load_explicit(&H->stats_on, memory_order_relaxed) ? 1 : 0;
+    for (int k = 0; k < SPLINTER_STATS_STRIPES; k++) {
+        const struct splinter_stats_stripe *st = &H->stats[k];
+        for (int op = 0; op < SPL_OP_COUNT; op++)
+            out->ops[op] += atomic_load_explicit(&st->ops[op], memory_order_relaxed);
+        out->misses += atomic_load_explicit(&st->misses, memory_order_relaxed);
+        out->eagain += atomic_load_explicit(&st->eagain, memory_order_relaxed);
+        out->retries += atomic_load_explicit(&st->retries, memory_order_relaxed);
+        out->set_full += atomic_load_explicit(&st->set_full, memory_order_relaxed);
+        out->eventfd_writes += atomic_load_explicit(&st->eventfd_writes, memory_order_relaxed);
+        for (int b = 0; b < SPLINTER_PROBE_BUCKETS; b++)
+            out->probe[b] += atomic_load_explicit(&st->probe[b], memory_order_relaxed);
+        out->eventfd_reads += atomic_load_explicit(&st->eventfd_reads, memory_order_relaxed);
+        out->sovereign_changes += atomic_load_explicit(&st->sovereign_changes, memory_order_relaxed);
+        out->madvise_defers += atomic_load_explicit(&st->madvise_defers, memory_order_relaxed);
+    }
+    return 0;
+}
+
+int splinter_reset_stats(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    for (int k = 0; k < SPLINTER_STATS_STRIPES; k++) {
+        struct splinter_stats_stripe *st = &H->stats[k];
+        for (int op = 0; op < SPL_OP_COUNT; op++)
+            atomic_store_explicit(&st->ops[op], 0, memory_order_relaxed);
+        atomic_store_explicit(&st->misses, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->eagain, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->retries, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->set_full, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->eventfd_writes, 0, memory_order_relaxed);
+        for (int b = 0; b < SPLINTER_PROBE_BUCKETS; b++)
+            atomic_store_explicit(&st->probe[b], 0, memory_order_relaxed);
+        atomic_store_explicit(&st->eventfd_reads, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->sovereign_changes, 0, memory_order_relaxed);
+        atomic_store_explicit(&st->madvise_defers, 0, memory_order_relaxed);
+    }
+    return 0;
+}
+
+/*
+ * Tick calibration
+ * ----------------
+ * splinter_now() counts at whatever rate the CPU's counter runs. The rate is
+ * found once per host, on first use rather than at create so creation stays
+ * O(1), and shared through the header.
+ */
+#define SPL_TICK_CAL_NS 1000000ull
+#define SPL_NS_PER_SEC  1000000000ull
+
+static uint64_t g_tick_hz;
+
+/** @brief Ask the CPU for the counter's frequency, or time it. */
+static uint64_t spl_tick_measure(void) {
+#if defined(__aarch64__)
+    uint64_t f;
+    __asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (f));
+    if (f) return f;
+#elif defined(__x86_64__) || defined(__i386__)
+    unsigned a, b, c, d;
+    if (__get_cpuid_max(0, NULL) >= 0x15) {
+        __cpuid_count(0x15, 0, a, b, c, d);
+        (void)d;
+        if (a && b && c) return (uint64_t)c * b / a;
+    }
+#elif !defined(__arm__)
+    return SPL_NS_PER_SEC;  // splinter_now() is CLOCK_MONOTONIC_RAW ns here
+#endif
+    struct timespec t0, t1;
+    uint64_t ns;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+    uint64_t c0 = splinter_now();
+    do {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+        ns = (uint64_t)(t1.tv_sec - t0.tv_sec) * SPL_NS_PER_SEC + (uint64_t)t1.tv_nsec - (uint64_t)t0.tv_nsec;
+    } while (ns < SPL_TICK_CAL_NS);
+    uint64_t c1 = splinter_now();
+    uint64_t hz = (c1 - c0) * SPL_NS_PER_SEC / ns;
+    return hz ? hz : 1;
+}
+
+uint64_t splinter_tick_hz(void) {
+    uint64_t hz = H ? atomic_load_explicit(&H->tick_hz, memory_order_relaxed) : 0;
+    if (hz) return hz;
+    if (!g_tick_hz) g_tick_hz = spl_tick_measure();
+    if (H) {
+        uint64_t none = 0;
+        // First process in wins; everyone then uses its figure.
+        if (!atomic_compare_exchange_strong_explicit(&H->tick_hz, &none, g_tick_hz,
+                                                     memory_order_relaxed, memory_order_relaxed))
+            return none;
+    }
+    return g_tick_hz;
+}
+
+uint64_t splinter_ticks_to_ns(uint64_t ticks) {
+    const uint64_t hz = splinter_tick_hz();
+    return (ticks / hz) * SPL_NS_PER_SEC + (ticks % hz) * SPL_NS_PER_SEC / hz;
+}
+
+uint64_t splinter_ns_to_ticks(uint64_t ns) {
+    const uint64_t hz = splinter_tick_hz();
+    return (ns / SPL_NS_PER_SEC) * hz + (ns % SPL_NS_PER_SEC) * hz / SPL_NS_PER_SEC;
+}
+
+/*
+ * Latency histograms
+ * ------------------
+ * Opt-in (H->lat_every). Each thread counts down its own sampling interval,
+ * so an untimed call touches no shared line at all. A timed call adds its
+ * splinter_now() delta to a log-linear (HDR-style) histogram in the header,
+ * where every process reads the same merged counts.
+ */
+static _Thread_local uint32_t t_lat_skip;
+
+/** @brief Start timing a call if this one is sampled; 0 means not sampled. */
+static inline uint64_t spl_lat_begin(void) {
+    if (!H) return 0;
+    uint32_t every = atomic_load_explicit(&H->lat_every, memory_order_relaxed);
+    if (!every) return 0;
+    if (t_lat_skip) { t_lat_skip--; return 0; }
+    t_lat_skip = every - 1;
+    return splinter_now();
+}
+
+/** @brief Histogram bucket for a duration of v ticks. */
+static inline unsigned spl_lat_bucket(uint64_t v) {
+    const unsigned k = SPLINTER_LAT_SUB_BITS;
+    if (v < (2ull << k)) return (unsigned)v;
+    unsigned e = 63u - (unsigned)__builtin_clzll(v);
+    unsigned b = (e - k) * (1u << k) + (unsigned)(v >> (e - k));
+    return b < SPLINTER_LAT_BUCKETS ? b : SPLINTER_LAT_BUCKETS - 1;
+}
+
+/** @brief Largest duration that lands in bucket b. */
+static uint64_t spl_lat_bucket_top(unsigned b) {
+    const unsigned k = SPLINTER_LAT_SUB_BITS;
+    if (b < (2u << k)) return b;
+    unsigned shift = b / (1u << k) - 1;
+    uint64_t m = (b % (1u << k)) + (1u << k);
+    return ((m + 1) << shift) - 1;
+}
+
+/** @brief Finish timing a call started by spl_lat_begin(). */
+static inline void spl_lat_end(unsigned op, uint64_t t0) {
+    if (!t0 || !H) return;
+    uint64_t d = splinter_now() - t0;
+    struct splinter_latency_hist *lh = &H->latency[op];
+    atomic_fetch_add_explicit(&lh->buckets[spl_lat_bucket(d)], 1, memory_order_relaxed);
+    uint64_t m = atomic_load_explicit(&lh->max, memory_order_relaxed);
+    while (d > m && !atomic_compare_exchange_weak_explicit(&lh->max, &m, d,
+                                                           memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+int splinter_set_latency_sampling(unsigned int every) {
+    if (!H) return -2;
+    spl_follow_resize();
+    atomic_store_explicit(&H->lat_every, every, memory_order_relaxed);
+    return 0;
+}
+
+int splinter_get_latency(unsigned int op, splinter_latency_t *out) {
+    if (!H || !out || op >= SPL_LAT_OPS) return -2;
+    spl_follow_resize();
+    const struct splinter_latency_hist *lh = &H->latency[op];
+    static const double q[4] = { 0.50, 0.90, 0.99, 0.999 };
+    uint64_t *pct[4] = { &out->p50, &out->p90, &out->p99, &out->p999 };
+    uint64_t counts[SPLINTER_LAT_BUCKETS], total = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->every = atomic_load_explicit(&H->lat_every, memory_order_relaxed);
+    for (unsigned b = 0; b < SPLINTER_LAT_BUCKETS; b++) {
+        counts[b] = atomic_load_explicit(&lh->buckets[b], memory_order_relaxed);
+        total += counts[b];
+    }
+    out->samples = total;
+    out->max = atomic_load_explicit(&lh->max, memory_order_relaxed);
+    if (!total) return 0;
+
+    uint64_t seen = 0;
+    unsigned b = 0, k = 0;
+    for (; k < 4; k++) {
+        uint64_t rank = (uint64_t)(q[k] * (double)total);
+        if (rank >= total) rank = total - 1;
+        while (seen + counts[b] <= rank) seen += counts[b++];
+        *pct[k] = spl_lat_bucket_top(b);
+        // Never report a percentile above the exact maximum.
+        if (out->max && *pct[k] > out->max) *pct[k] = out->max;
+    }
+    return 0;
+}
+
+int splinter_reset_latency(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    for (unsigned op = 0; op < SPL_LAT_OPS; op++) {
+        struct splinter_latency_hist *lh = &H->latency[op];
+        atomic_store_explicit(&lh->max, 0, memory_order_relaxed);
+        for (unsigned b = 0; b < SPLINTER_LAT_BUCKETS; b++)
+            atomic_store_explicit(&lh->buckets[b], 0, memory_order_relaxed);
+    }
+    return 0;
+}
+
+/*
+ * Tracing
+ * -------
+ * Opt-in and per process. Callers reserve a ring position with a CAS on
+ * g_trace_head, fill the record, then publish it by storing its position + 1
+ * in g_trace_seq. Draining (by whichever call crosses a half-ring boundary,
+ * or by flush/stop) writes the published run from g_trace_tail onward and
+ * then advances the tail, which is what frees those positions for reuse.
+ * Nothing here ever waits: a caller that finds the ring full drops its record,
+ * and one that finds a drain in progress leaves the work to it.
+ *
+ * A forked child inherits all of this, including the parent's unwritten
+ * records and a descriptor sharing the parent's file offset. An atfork
+ * handler turns tracing off in the child, and SPLINTER_TRACE then starts the
+ * child's own file.
+ */
+#define SPL_TRACE_RING (1u << 16)
+#define SPL_TRACE_MASK (SPL_TRACE_RING - 1)
+
+static atomic_int g_trace_on;
+static int g_trace_fd = -1;
+static uint32_t g_trace_pid;
+static splinter_trace_record_t *g_trace_ring;
+static _Atomic uint64_t *g_trace_seq;
+static _Atomic uint64_t g_trace_head;
+static _Atomic uint64_t g_trace_tail;
+static _Atomic uint64_t g_trace_dropped;
+static atomic_int g_trace_draining;
+static _Thread_local uint32_t t_trace_tid;
+static atomic_flag g_trace_atfork = ATOMIC_FLAG_INIT;
+
+static void spl_trace_env(void);
+
+/** @brief Write the published records at the tail of the ring to the file. */
+static void spl_trace_drain(void) {
+    if (atomic_exchange_explicit(&g_trace_draining, 1, memory_order_acquire)) return;
+    uint64_t tail = atomic_load_explicit(&g_trace_tail, memory_order_relaxed);
+    uint64_t end = tail;
+    while (end - tail < SPL_TRACE_RING &&
+           atomic_load_explicit(&g_trace_seq[end & SPL_TRACE_MASK], memory_order_acquire) == end + 1)
+        end++;
+    while (tail < end) {
+        // Stop at the end of the ring; the rest goes in the next write.
+        uint64_t run = end - tail;
+        uint64_t room = SPL_TRACE_RING - (tail & SPL_TRACE_MASK);
+        if (run > room) run = room;
+        size_t bytes = (size_t)run * sizeof(splinter_trace_record_t);
+        if (write(g_trace_fd, &g_trace_ring[tail & SPL_TRACE_MASK], bytes) != (ssize_t)bytes)
+            atomic_fetch_add_explicit(&g_trace_dropped, run, memory_order_relaxed);
+        tail += run;
+    }
+    atomic_store_explicit(&g_trace_tail, tail, memory_order_release);
+    atomic_store_explicit(&g_trace_draining, 0, memory_order_release);
+}
+
+/** @brief Append one record to the trace ring. */
+static void spl_trace_emit(uint8_t op, uint8_t arg, const char *key, size_t len, int rc) {
+    uint64_t pos = atomic_load_explicit(&g_trace_head, memory_order_relaxed);
+    do {
+        if (pos - atomic_load_explicit(&g_trace_tail, memory_order_acquire) >= SPL_TRACE_RING) {
+            atomic_fetch_add_explicit(&g_trace_dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&g_trace_head, &pos, pos + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    if (!t_trace_tid) t_trace_tid = (uint32_t)syscall(SYS_gettid);
+
+    splinter_trace_record_t *r = &g_trace_ring[pos & SPL_TRACE_MASK];
+    r->ts = splinter_now();
+    r->key_hash = key ? fnv1a(key) : 0;
+    r->pid = g_trace_pid;
+    r->tid = t_trace_tid;
+    r->val_len = len > UINT32_MAX ? UINT32_MAX : (uint32_t)len;
+    r->op = op;
+    r->arg = arg;
+    r->result = (int8_t)(rc < 0 ? (rc < -128 ? -128 : rc) : 0);
+    r->err = (uint8_t)(rc == -1 ? (errno > 255 ? 255 : errno) : 0);
+    atomic_store_explicit(&g_trace_seq[pos & SPL_TRACE_MASK], pos + 1, memory_order_release);
+
+    if (((pos + 1) & (SPL_TRACE_RING / 2 - 1)) == 0) spl_trace_drain();
+}
+
+/** @brief Record a call if this process is tracing. */
+static inline void spl_trace(uint8_t op, uint8_t arg, const char *key, size_t len, int rc) {
+    if (__builtin_expect(atomic_load_explicit(&g_trace_on, memory_order_relaxed), 0)) {
+        int saved = errno;
+        spl_trace_emit(op, arg, key, len, rc);
+        errno = saved;
+    }
+}
+
+/** @brief Drop the parent's trace in a forked child; the parent owns the file and ring. */
+static void spl_trace_atfork_child(void) {
+    t_trace_tid = 0;
+    if (!atomic_exchange(&g_trace_on, 0)) return;
+    close(g_trace_fd);
+    g_trace_fd = -1;
+    atomic_store(&g_trace_draining, 0);
+    spl_trace_env();
+}
+
+int splinter_trace_start(const char *path) {
+    if (!H || !path) return -2;
+    if (!atomic_flag_test_and_set(&g_trace_atfork))
+        pthread_atfork(NULL, NULL, spl_trace_atfork_child);
+    if (atomic_load(&g_trace_on)) { errno = EBUSY; return -1; }
+    // The ring outlives stop, so a caller racing a stop never writes freed memory.
+    if (!g_trace_ring) {
+        g_trace_ring = calloc(SPL_TRACE_RING, sizeof(*g_trace_ring));
+        g_trace_seq = calloc(SPL_TRACE_RING, sizeof(*g_trace_seq));
+        if (!g_trace_ring || !g_trace_seq) {
+            free(g_trace_ring); free((void *)g_trace_seq);
+            g_trace_ring = NULL; g_trace_seq = NULL;
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+
+    splinter_trace_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SPLINTER_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = SPLINTER_TRACE_VER;
+    hdr.rec_size = sizeof(splinter_trace_record_t);
+    hdr.tick_hz = splinter_tick_hz();
+    hdr.slots = H->slots;
+    hdr.max_val_sz = H->max_val_sz;
+    hdr.pid = (uint64_t)getpid();
+    if (write(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr)) {
+        int e = errno;
+        close(fd);
+        errno = e;
+        return -1;
+    }
+
+    for (size_t i = 0; i < SPL_TRACE_RING; i++)
+        atomic_store_explicit(&g_trace_seq[i], 0, memory_order_relaxed);
+    atomic_store(&g_trace_head, 0);
+    atomic_store(&g_trace_tail, 0);
+    atomic_store(&g_trace_dropped, 0);
+    g_trace_pid = (uint32_t)getpid();
+    g_trace_fd = fd;
+    atomic_store_explicit(&g_trace_on, 1, memory_order_release);
+    return 0;
+}
+
+int splinter_trace_flush(void) {
+    if (!atomic_load(&g_trace_on)) { errno = EINVAL; return -1; }
+    spl_trace_drain();
+    return 0;
+}
+
+int splinter_trace_stop(void) {
+    if (!atomic_exchange(&g_trace_on, 0)) { errno = EINVAL; return -1; }
+    // A drain may be running on another thread; let it finish, then take the rest.
+    while (atomic_load_explicit(&g_trace_draining, memory_order_acquire))
+        sched_yield();
+    spl_trace_drain();
+    uint64_t dropped = atomic_load(&g_trace_dropped);
+    (void)!pwrite(g_trace_fd, &dropped, sizeof(dropped),
+                  offsetof(splinter_trace_header_t, dropped));
+    close(g_trace_fd);
+    g_trace_fd = -1;
+    return 0;
+}
+
+/** @brief Honor SPLINTER_TRACE=<path> on create/open: trace to <path>.<pid>. */
+static void spl_trace_env(void) {
+    const char *env = getenv("SPLINTER_TRACE");
+    char path[PATH_MAX];
+    if (!env || !*env || atomic_load(&g_trace_on)) return;
+    snprintf(path, sizeof(path), "%s.%ld", env, (long)getpid());
+    splinter_trace_start(path);
+}
+
+static int spl_do_unset(const char *key) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    SPL_STAT_ADD(ops[SPL_OP_UNSET]);
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    size_t i;
+    for (i = 0; i < H->slots; ++i) {
+        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+        uint64_t slot_hash = atomic_load_explicit(&slot->hash, memory_order_acquire);
+        if (slot_hash == h && strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t start_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            if ((start_epoch & 1) ||
+                !atomic_compare_exchange_strong_explicit(&slot->epoch, &start_epoch, start_epoch + 1,
+                                                         memory_order_acq_rel, memory_order_relaxed)) {
+                return spl_stat_eagain();
+            }
+            if (spl_slot_backout(slot, start_epoch)) return spl_stat_eagain();
+            int ret = (int)atomic_load_explicit(&slot->val_len, memory_order_acquire);
+            // Unlink while the key is still intact: the index is ordered by it.
+            int ix_skipped = splinter_config_test(H, SPL_SYS_KEY_INDEX) &&
+                             spl_index_remove((uint32_t)(slot - S));
+            atomic_store_explicit(&slot->hash, 0, memory_order_release);
+            if (ix_skipped) spl_index_remove_settle((uint32_t)(slot - S));
+            spl_occ_clear((size_t)(slot - S));
+            spl_slot_release(slot);
+            if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) {
+                memset(slot->key, 0, SPLINTER_KEY_MAX);
+            } else {
+                slot->key[0] = '\0';
+            }
+            atomic_store_explicit(&slot->type_flag, 0, memory_order_release);
+            atomic_fetch_or(&slot->type_flag, SPL_SLOT_DEFAULT_TYPE);
+            atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+            atomic_store_explicit(&slot->val_len, 0, memory_order_release);
+#ifdef SPLINTER_EMBEDDINGS
+            // This is necessary or overwrites may leave garbage at the end.
+            memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
+#endif
+            atomic_store_explicit(&slot->ctime, 0, memory_order_release);
+            atomic_store_explicit(&slot->atime, 0, memory_order_release);
+            atomic_store_explicit(&slot->user_flag, 0, memory_order_release);
+            atomic_store_explicit(&slot->watcher_mask, 0, memory_order_release);
+            atomic_store_explicit(&slot->bloom, 0, memory_order_release);
+            spl_slot_set_expiry((size_t)(slot - S), 0);
+            atomic_store_explicit(&AUX[slot - S].tomb, 1, memory_order_relaxed);
+            atomic_store_explicit(&AUX[slot - S].ref, 0, memory_order_relaxed);
+            atomic_store_explicit(&AUX[slot - S].heat, 0, memory_order_relaxed);
+            // The epoch restarts from 0, so an old watermark could match it again.
+            atomic_store_explicit(&AUX[slot - S].scrubbed, 0, memory_order_relaxed);
+            atomic_fetch_add_explicit(&slot->epoch, 2, memory_order_release);
+            return ret;
+        }
+    }
+    SPL_STAT_ADD(misses);
+    return -1;
+}
+
+int splinter_unset(const char *key) {
+    int rc = spl_do_unset(key);
+    spl_trace(SPL_TRACE_UNSET, 0, key, rc > 0 ? (size_t)rc : 0, rc);
+    return rc;
+}
+
+/**
+ * @brief Probe position of key at or past probe position from, where a set
+ * found a free slot, or 0 if it is not there. Lookups walk the whole probe,
+ * so a key can sit past a hole that unset, expiry or eviction opened after it
+ * was placed; such holes carry aux.tomb. A free slot that was never emptied
+ * ends the search: no key placed since could have skipped it.
+ */
+static size_t spl_probe_past_hole(uint64_t h, const char *key, size_t idx, size_t from) {
+    for (size_t i = from; i < H->slots; ++i) {
+        size_t n = (idx + i) % H->slots;
+        uint64_t slot_hash = atomic_load_explicit(&S[n].hash, memory_order_acquire);
+        if (slot_hash == 0) {
+            if (!atomic_load_explicit(&AUX[n].tomb, memory_order_relaxed)) return 0;
+        } else if (slot_hash == h && strncmp(S[n].key, key, SPLINTER_KEY_MAX) == 0) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static int spl_do_set(const char *key, const void *val, size_t len) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    if (len == 0) return -1;
+    SPL_STAT_ADD(ops[SPL_OP_SET]);
+    const int chain = len > H->max_val_sz;
+    if (chain && (!atomic_load_explicit(&H->val_chain, memory_order_relaxed) ||
+                  len > spl_chain_max())) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    SPL_PROBE_KEY(h);
+
+    // A full probe gets one retry if the CLOCK sweep frees a slot for us.
+    int copied = 0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t live_at = 0;
+        int looked = 0;
+        uint32_t busy = 0;
+        for (size_t i = 0; i < H->slots; ++i) {
+            struct splinter_slot *slot = &S[(idx + i) % H->slots];
+        reprobe:;
+            uint64_t slot_hash = atomic_load_explicit(&slot->hash, memory_order_acquire);
+
+            // Take no hole ahead of the key's own slot further along the probe.
+            if (slot_hash == 0 && !looked) {
+                looked = 1;
+                live_at = spl_probe_past_hole(h, key, idx, i);
+            }
+            if (slot_hash == 0 && i < live_at) continue;
+
+            if (slot_hash == 0 || (slot_hash == h && strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0)) {
+                uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
+                // A key frozen by a resize must not be re-homed further down the
+                // probe; if the resizer died, settling it frees the slot.
+                if ((e & 1ull) && slot_hash == h &&
+                    atomic_load_explicit(&H->resizing, memory_order_relaxed)) {
+                    if (!spl_resize_reap()) return spl_stat_eagain();
+                    e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
+                }
+                if ((e & 1ull) ||
+                    !atomic_compare_exchange_weak_explicit(&slot->epoch, &e, e + 1,
+                                                           memory_order_acq_rel, memory_order_relaxed)) {
+                    SPL_STAT_ADD(retries);
+                    SPL_PROBE_RETRY();
+                    // The key's own slot is busy: wait for it rather than add a second copy.
+                    if (slot_hash != 0) {
+                        if (++busy >= SPL_HOLD_SPINS) return spl_stat_eagain();
+                        sched_yield();
+                        goto reprobe;
+                    }
+                    continue;
+                }
+                if (spl_slot_backout(slot, e)) {
+                    // Copied by a running resize: a new key goes further on, an old one waits.
+                    if (slot_hash != 0) return spl_stat_eagain();
+                    copied = 1;
+                    continue;
+                }
+                SPL_PROBE_SLOT(slot - S, e);
+
+                // Out of arena: let the CLOCK hand free some extents, then give up.
+                if (!chain && spl_slot_chained(slot)) spl_chain_collapse(slot);
+                int tries = 0;
+                while ((chain ? spl_chain_resize(slot, len, 0) : spl_slot_reserve(slot, len, 0)) != 0) {
+                    if (++tries > SPL_RESERVE_RETRIES || spl_clock_sweep(1) != 0) {
+                        atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+                        SPL_STAT_ADD(set_full);
+                        errno = ENOSPC;
+                        return -1;
+                    }
+                }
+
+                uint8_t *dst = (uint8_t *)VALUES + slot->val_off;
+                const size_t extent = spl_slot_extent(slot);
+
+                if (chain) {
+                    // Every segment but the last is overwritten whole.
+                    if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB))
+                        spl_chain_scrub_tail(slot, len);
+                    spl_chain_write(slot, 0, val, len);
+                } else {
+                    if (splinter_config_test(H, SPL_SYS_AUTO_SCRUB)) {
+                        if (splinter_config_test(H, SPL_SYS_HYBRID_SCRUB)) {
+                            size_t scrub_len = (len + 63) & ~63;
+                            if (scrub_len > extent) scrub_len = extent;
+                            memset(dst, 0, scrub_len);
+                        } else {
+                            memset(dst, 0, extent);
+                        }
+                    }
+
+                    memcpy(dst, val, len);
+                }
+                atomic_store_explicit(&slot->val_len, (uint32_t)len, memory_order_release);
+
+#ifdef SPLINTER_EMBEDDINGS
+                // Don't let previous embeddings hang around between writes
+                if (slot_hash == 0) {
+                    memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
+                }
+#endif
+
+                // A never-used slot is still all zero; give it the default type.
+                if (slot_hash == 0 && atomic_load_explicit(&slot->type_flag, memory_order_relaxed) == 0)
+                    atomic_store_explicit(&slot->type_flag, SPL_SLOT_DEFAULT_TYPE, memory_order_relaxed);
+
+                slot->key[0] = '\0';
+                strncpy(slot->key, key, SPLINTER_KEY_MAX - 1);
+                slot->key[SPLINTER_KEY_MAX - 1] = '\0';
+
+                atomic_thread_fence(memory_order_release);
+                atomic_store_explicit(&slot->hash, h, memory_order_release);
+                if (slot_hash == 0) spl_occ_set((size_t)(slot - S));
+                // A new key joins the ordered index while its slot is still odd.
+                if (slot_hash == 0 && splinter_config_test(H, SPL_SYS_KEY_INDEX))
+                    spl_index_insert((uint32_t)(slot - S));
+                // A new key never inherits a TTL; a lapsed one is revived without it.
+                if (slot_hash == 0 || spl_slot_expired((size_t)(slot - S)))
+                    spl_slot_set_expiry((size_t)(slot - S), 0);
+                spl_slot_touch((size_t)(slot - S));
+                atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+                SPL_PROBE_SLOT(slot - S, e + 2);
+            
+                splinter_pulse_watchers(slot);
+                atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
+                splinter_event_bus_notify((idx + i) % H->slots);
+                spl_stat_probe(i);
+
+                return 0;
+            }
+        }
+        if (spl_clock_sweep(0) != 0) break;
+    }
+    // Every free slot was behind a running resize: room again once it lands.
+    if (copied) return spl_stat_eagain();
+    SPL_STAT_ADD(set_full);
+    errno = ENOSPC;
+    return -1;
+}
+
+int splinter_set(const char *key, const void *val, size_t len) {
+    SPL_PROBE_ENTRY(set__entry, key, len);
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_set(key, val, len);
+    spl_lat_end(SPL_LAT_SET, t0);
+    spl_trace(SPL_TRACE_SET, 0, key, len, rc);
+    SPL_PROBE_RETURN(set__return, rc);
+    return rc;
+}
+
+static int spl_do_get(const char *key, void *buf, size_t buf_sz, size_t *out_sz) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    SPL_STAT_ADD(ops[SPL_OP_GET]);
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    SPL_PROBE_KEY(h);
+
+    size_t i;
+    for (i = 0; i < H->slots; ++i) {
+        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            SPL_PROBE_SLOT(slot - S, start);
+            if (start & 1) return spl_stat_eagain();
+            if (spl_slot_expired((size_t)(slot - S))) {
+                spl_expire_slot((size_t)(slot - S), start);
+                SPL_STAT_ADD(misses);
+                errno = ENOENT;
+                return -1;
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+
+            size_t len = (size_t)atomic_load_explicit(&slot->val_len, memory_order_acquire);
+            if (out_sz) *out_sz = len;
+
+            if (buf) {
+                if (buf_sz < len) { errno = EMSGSIZE; return -1; }
+                // val_off may be mid-relocation; never copy from outside the arena.
+                uint64_t off = slot->val_off;
+                if (spl_slot_chained(slot)) {
+                    if (spl_chain_copy(off, len, buf) != 0) return spl_stat_eagain();
+                } else {
+                    if (off + len > H->val_sz) return spl_stat_eagain();
+                    memcpy(buf, VALUES + off, len);
+                }
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+            uint64_t end = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            if (start == end && !(end & 1)) {
+                spl_slot_touch((size_t)(slot - S));
+                spl_stat_probe(i);
+                return 0;
+            }
+
+            return spl_stat_eagain();
+        }
+    }
+    SPL_STAT_ADD(misses);
+    return -1;
+}
+
+int splinter_get(const char *key, void *buf, size_t buf_sz, size_t *out_sz) {
+    SPL_PROBE_ENTRY(get__entry, key, buf_sz);
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_get(key, buf, buf_sz, out_sz);
+    spl_lat_end(SPL_LAT_GET, t0);
+    spl_trace(SPL_TRACE_GET, 0, key, rc == 0 && out_sz ? *out_sz : 0, rc);
+    SPL_PROBE_RETURN(get__return, rc);
+    return rc;
+}
+
+int splinter_get_iov(const char *key, struct iovec *iov, int iovcnt,
+                     size_t *out_len, uint64_t *out_epoch) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+
+    for (size_t i = 0; i < H->slots; ++i) {
+        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            if (start & 1) { errno = EAGAIN; return -1; }
+            if (spl_slot_expired((size_t)(slot - S))) {
+                spl_expire_slot((size_t)(slot - S), start);
+                errno = ENOENT;
+                return -1;
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+            size_t len = (size_t)atomic_load_explicit(&slot->val_len, memory_order_acquire);
+            uint64_t off = slot->val_off;
+            int chained = spl_slot_chained(slot);
+            int n = chained ? (int)spl_chain_segs(len) : 1;
+            if (out_len) *out_len = len;
+            if (out_epoch) *out_epoch = start;
+            if (!iov) return n;
+            if (n > iovcnt) { errno = EMSGSIZE; return -1; }
+
+            if (chained) {
+                if (spl_chain_map(off, len, iov, iovcnt) != n) { errno = EAGAIN; return -1; }
+            } else {
+                if (off + len > H->val_sz) { errno = EAGAIN; return -1; }
+                iov[0].iov_base = VALUES + off;
+                iov[0].iov_len = len;
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&slot->epoch, memory_order_acquire) != start) {
+                errno = EAGAIN;
+                return -1;
+            }
+            spl_slot_touch((size_t)(slot - S));
+            return n;
+        }
+    }
+    return -1;
+}
+
+int splinter_list(char **out_keys, size_t max_keys, size_t *out_count) {
+    if (!H || !out_keys || !out_count) return -2;
+    spl_follow_resize();
+    size_t count = 0;
+    const size_t words = ((size_t)H->slots + 63) / 64;
+    for (size_t w = 0; w < words && count < max_keys; ++w) {
+        uint64_t bits = atomic_load_explicit(&OCC[w], memory_order_acquire);
+        while (bits && count < max_keys) {
+            size_t i = w * 64 + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (atomic_load_explicit(&S[i].hash, memory_order_acquire) &&
+                atomic_load_explicit(&S[i].val_len, memory_order_acquire) > 0 &&
+                !spl_slot_expired(i)) {
+                out_keys[count++] = S[i].key;
+            }
+        }
+    }
+    *out_count = count;
+    return 0;
+}
+
+/** @brief Attempts splinter_iter_next() makes on a slot held mid-write. */
+#define SPL_ITER_SPINS 1024
+
+/**
+ * @brief One seqlock-validated copy of the fields of a slot.
+ * @return 0 if the copy is consistent, -1 if a writer held or moved the slot.
+ */
+static int spl_slot_copy(const struct splinter_slot *slot, splinter_slot_snapshot_t *snap,
+                         unsigned fields) {
+    uint64_t start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+    if (start & 1ull) return -1;
+    snap->hash = atomic_load_explicit(&slot->hash, memory_order_acquire);
+    snap->epoch = start;
+    if (fields & SPL_SNAP_KEY) {
+        memcpy(snap->key, slot->key, SPLINTER_KEY_MAX);
+        snap->key[SPLINTER_KEY_MAX - 1] = '\0';
+    }
+    if (fields & SPL_SNAP_VALUE) {
+        snap->val_off = slot->val_off;
+        snap->val_len = atomic_load_explicit(&slot->val_len, memory_order_relaxed);
+    }
+    if (fields & SPL_SNAP_TYPE) {
+        snap->type_flag = atomic_load_explicit(&slot->type_flag, memory_order_relaxed);
+        snap->user_flag = atomic_load_explicit(&slot->user_flag, memory_order_relaxed);
+    }
+    if (fields & SPL_SNAP_TIME) {
+        snap->ctime = atomic_load_explicit(&slot->ctime, memory_order_relaxed);
+        snap->atime = atomic_load_explicit(&slot->atime, memory_order_relaxed);
+    }
+    if (fields & SPL_SNAP_BLOOM)
+        snap->bloom = atomic_load_explicit(&slot->bloom, memory_order_relaxed);
+#ifdef SPLINTER_EMBEDDINGS
+    if (fields & SPL_SNAP_EMBEDDING)
+        memcpy(snap->embedding, slot->embedding, sizeof(float) * SPLINTER_EMBED_DIM);
+#endif
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->epoch, memory_order_relaxed) == start ? 0 : -1;
+}
+
+int splinter_iter_next(splinter_cursor_t *cursor, splinter_slot_snapshot_t *snapshot,
+                       unsigned fields) {
+    if (!H || !cursor || !snapshot) return -2;
+    spl_follow_resize();
+    const uint64_t n = spl_cursor_end(cursor);
+    uint64_t i = cursor->next;
+
+    while (i < n) {
+        uint64_t bits = atomic_load_explicit(&OCC[i / 64], memory_order_acquire) >> (i % 64);
+        if (!bits) {
+            i = (i / 64 + 1) * 64;
+            continue;
+        }
+        i += (uint64_t)__builtin_ctzll(bits);
+        if (i >= n) break;
+
+        const struct splinter_slot *slot = &S[i];
+        int ok = -1;
+        for (int spin = 0; spin < SPL_ITER_SPINS && ok != 0; spin++)
+            ok = spl_slot_copy(slot, snapshot, fields);
+        i++;
+        if (ok == 0 && snapshot->hash != 0 && !spl_slot_expired((size_t)(i - 1))) {
+            cursor->next = i;
+            return 1;
+        }
+    }
+    cursor->next = n;
+    return 0;
+}
+
+/*
+ * Ordered key index
+ * -----------------
+ * A skiplist threaded through a side array of nodes, one per slot, so node i
+ * always describes slot i and inserting never allocates. Links hold slot + 1
+ * (0 = end of level); link 0 of a walk is the header's index_head.
+ *
+ * Writers serialize on H->index_seq (odd = splicing). The lock is held only
+ * for the O(log n) splice, and only by a set that creates a key or an unset
+ * that removes one; overwrites never touch the index. A writer that cannot
+ * get the lock in bounded time marks the index stale rather than stall the
+ * slot it already holds odd -- scans then fail with ESTALE until someone runs
+ * splinter_index_rebuild(). It gives up at once if the holder is dead, and
+ * while the index is stale writers skip upkeep altogether: the rebuild
+ * re-reads every slot anyway.
+ *
+ * Readers never lock. They seek under the seqlock, copy a small batch of keys
+ * out, validate the sequence and only then hand the batch to the callback,
+ * re-seeking past the last emitted key for the next batch.
+ */
+
+/** @brief Spin budget for the index writer lock before giving up. */
+#define SPL_INDEX_LOCK_SPINS  (1u << 16)
+/** @brief Keys copied per validated scan batch. */
+#define SPL_INDEX_BATCH       32
+
+/** @brief Link cell for level l of node n (0 = the header's head tower). */
+static inline atomic_uint_least32_t *ix_link(uint32_t n, int l) {
+    return n ? &IX[n - 1].next[l] : &H->index_head.next[l];
+}
+
+/** @brief Tower height for a key, drawn from hash bits the slot index ignores. */
+static int ix_height(uint64_t h) {
+    int lvl = 1;
+    h >>= 32;
+    while (lvl < SPLINTER_INDEX_LEVELS && (h & 3u) == 0) {
+        lvl++;
+        h >>= 2;
+    }
+    return lvl;
+}
+
+/**
+ * @brief Bounded acquisition of the index writer lock. Marks the index stale
+ * on timeout, or as soon as the holder turns out to be dead: waiting out the
+ * budget for a lock nobody will release only stalls the caller.
+ */
+static int ix_lock(void) {
+    for (uint32_t spins = 0; spins < SPL_INDEX_LOCK_SPINS; spins++) {
+        uint64_t seq = atomic_load_explicit(&H->index_seq, memory_order_relaxed);
+        if (!(seq & 1ull) &&
+            atomic_compare_exchange_weak_explicit(&H->index_seq, &seq, seq + 1,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            atomic_store_explicit(&H->index_owner, (int32_t)getpid(), memory_order_relaxed);
+            return 0;
+        }
+        if (spins > 64) {
+            if ((spins & 1023) == 65 &&
+                spl_pid_dead(atomic_load_explicit(&H->index_owner, memory_order_relaxed)))
+                break;
+            sched_yield();
+        }
+    }
+    atomic_store_explicit(&H->index_stale, 1, memory_order_release);
+    return -1;
+}
+
+/**
+ * @brief Whether index upkeep should be skipped: a stale index is rebuilt from
+ * the slots anyway, so writers stop paying for the lock until then. The fence
+ * orders the caller's hash store before the load; splinter_index_rebuild()
+ * clears the flag before it reads any hash, so it sees every skipped change.
+ */
+static int ix_skip(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&H->index_stale, memory_order_relaxed) != 0;
+}
+
+static void ix_unlock(void) {
+    atomic_store_explicit(&H->index_owner, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&H->index_seq, 1, memory_order_release);
+}
+
+/**
+ * @brief Fills update[] with, per level, the last node whose key sorts before key.
+ * Caller holds the index lock.
+ */
+static void ix_seek_locked(const char *key, uint32_t update[SPLINTER_INDEX_LEVELS]) {
+    uint32_t x = 0;
+    for (int l = SPLINTER_INDEX_LEVELS - 1; l >= 0; l--) {
+        uint32_t n;
+        while ((n = atomic_load_explicit(ix_link(x, l), memory_order_relaxed)) != 0 &&
+               strncmp(S[n - 1].key, key, SPLINTER_KEY_MAX) < 0)
+            x = n;
+        update[l] = x;
+    }
+}
+
+static void spl_index_insert(uint32_t slot) {
+    uint32_t update[SPLINTER_INDEX_LEVELS];
+    const uint32_t me = slot + 1;
+
+    if (ix_skip() || ix_lock() != 0) return;
+    ix_seek_locked(S[slot].key, update);
+
+    // Already linked (a rebuild raced us): leave it.
+    uint32_t n = atomic_load_explicit(ix_link(update[0], 0), memory_order_relaxed);
+    while (n && n != me && strncmp(S[n - 1].key, S[slot].key, SPLINTER_KEY_MAX) == 0)
+        n = atomic_load_explicit(ix_link(n, 0), memory_order_relaxed);
+    if (n == me) { ix_unlock(); return; }
+
+    int height = ix_height(atomic_load_explicit(&S[slot].hash, memory_order_relaxed));
+    for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++) {
+        if (l < height) {
+            atomic_store_explicit(&IX[slot].next[l],
+                atomic_load_explicit(ix_link(update[l], l), memory_order_relaxed),
+                memory_order_relaxed);
+            atomic_store_explicit(ix_link(update[l], l), me, memory_order_release);
+        } else {
+            atomic_store_explicit(&IX[slot].next[l], 0, memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&H->index_count, 1, memory_order_relaxed);
+    ix_unlock();
+}
+
+/**
+ * @brief Unlink slot's node. Returns 1 if it skipped the work because the
+ * index is stale; the caller then clears the slot's hash and calls
+ * spl_index_remove_settle().
+ */
+static int spl_index_remove(uint32_t slot) {
+    uint32_t update[SPLINTER_INDEX_LEVELS];
+    const uint32_t me = slot + 1;
+    int found = 0;
+
+    if (ix_skip()) return 1;
+    if (ix_lock() != 0) return 0;
+    ix_seek_locked(S[slot].key, update);
+
+    for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++) {
+        // Step over any equal-keyed neighbours to find our own node.
+        uint32_t x = update[l], n;
+        while ((n = atomic_load_explicit(ix_link(x, l), memory_order_relaxed)) != 0 &&
+               n != me && strncmp(S[n - 1].key, S[slot].key, SPLINTER_KEY_MAX) == 0)
+            x = n;
+        if (n != me) continue;
+        atomic_store_explicit(ix_link(x, l),
+            atomic_load_explicit(&IX[slot].next[l], memory_order_relaxed),
+            memory_order_release);
+        found = 1;
+    }
+    if (found) atomic_fetch_sub_explicit(&H->index_count, 1, memory_order_relaxed);
+    ix_unlock();
+    return 0;
+}
+
+/**
+ * @brief Finish a skipped unlink once the slot's hash is cleared. A rebuild
+ * that began after the skip may have linked the node before the hash went, so
+ * if the index is no longer stale, unlink it now (the key is still intact).
+ */
+static void spl_index_remove_settle(uint32_t slot) {
+    if (!ix_skip()) spl_index_remove(slot);
+}
+
+int splinter_index_rebuild(void) {
+    if (!H || !IX) return -2;
+    spl_follow_resize();
+
+    /*
+     * A lock still odd after the bounded wait is broken only if its holder is
+     * gone. Breaking moves the sequence from one odd value to the next, so
+     * scanners still see a change and two rebuilds can't both take it over.
+     */
+    if (ix_lock() != 0) {
+        uint64_t seq = atomic_load_explicit(&H->index_seq, memory_order_acquire);
+        int32_t owner = atomic_load_explicit(&H->index_owner, memory_order_relaxed);
+        if (!(seq & 1ull) || !spl_pid_dead(owner) ||
+            !atomic_compare_exchange_strong_explicit(&H->index_seq, &seq, seq + 2,
+                                                     memory_order_acquire, memory_order_relaxed)) {
+            errno = EBUSY;
+            return -1;
+        }
+        atomic_store_explicit(&H->index_owner, (int32_t)getpid(), memory_order_relaxed);
+    }
+
+    /*
+     * Clear stale before reading any hash (see ix_skip()): a writer that
+     * skipped upkeep did so before this point, so its hash change is seen
+     * below; one after it waits for the lock. A writer that times out during
+     * the rebuild raises stale again, and that sticks.
+     */
+    atomic_store_explicit(&H->index_stale, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++)
+        atomic_store_explicit(&H->index_head.next[l], 0, memory_order_relaxed);
+    atomic_store_explicit(&H->index_count, 0, memory_order_relaxed);
+
+    /*
+     * Build bottom-up in one pass: for every live key find its predecessors
+     * and splice. Slots mid-write (odd) with a hash are included; their key is
+     * already in place by the time the hash is published.
+     */
+    int count = 0;
+    uint32_t update[SPLINTER_INDEX_LEVELS];
+    for (uint32_t i = 0; i < H->slots; i++) {
+        uint64_t h = atomic_load_explicit(&S[i].hash, memory_order_acquire);
+        if (h == 0 || S[i].key[0] == '\0') continue;
+        ix_seek_locked(S[i].key, update);
+        int height = ix_height(h);
+        for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++) {
+            if (l < height) {
+                atomic_store_explicit(&IX[i].next[l],
+                    atomic_load_explicit(ix_link(update[l], l), memory_order_relaxed),
+                    memory_order_relaxed);
+                atomic_store_explicit(ix_link(update[l], l), i + 1, memory_order_relaxed);
+            } else {
+                atomic_store_explicit(&IX[i].next[l], 0, memory_order_relaxed);
+            }
+        }
+        count++;
+    }
+    atomic_store_explicit(&H->index_count, (uint32_t)count, memory_order_relaxed);
+    ix_unlock();
+    return count;
+}
+
+int splinter_set_key_index(unsigned int on) {
+    if (!H) return -2;
+    spl_follow_resize();
+    if (!on) {
+        splinter_config_clear(H, SPL_SYS_KEY_INDEX);
+        // Empty the index so links left behind can't outlive the keys they
+        // ordered; an unset while disabled would otherwise strand its node.
+        if (ix_lock() != 0) { errno = EAGAIN; return -1; }
+        for (int l = 0; l < SPLINTER_INDEX_LEVELS; l++)
+            atomic_store_explicit(&H->index_head.next[l], 0, memory_order_relaxed);
+        atomic_store_explicit(&H->index_count, 0, memory_order_relaxed);
+        ix_unlock();
+        return 0;
+    }
+    /*
+     * Publish the flag first so writers start maintaining the index, then
+     * rebuild: any insert that lands before the rebuild takes the lock is
+     * discarded and re-read from the slots, any after it is spliced normally.
+     */
+    splinter_config_set(H, SPL_SYS_KEY_INDEX);
+    return splinter_index_rebuild() < 0 ? -1 : 0;
+}
+
+int splinter_get_key_index(void) {
+    if (!H) return -2;
+    spl_follow_resize();
+    return splinter_config_test(H, SPL_SYS_KEY_INDEX) ? 1 : 0;
+}
+
+/**
+ * @brief Shared body of the prefix and range scans.
+ * Emits keys k >= lo (all if lo is NULL), stopping at the first key that is
+ * >= hi or that no longer starts with prefix.
+ */
+static int ix_scan(const char *lo, const char *hi, const char *prefix,
+                   void (*callback)(const char *key, uint64_t epoch, void *data),
+                   void *user_data) {
+    struct { char key[SPLINTER_KEY_MAX]; uint64_t epoch; } batch[SPL_INDEX_BATCH];
+    char cursor[SPLINTER_KEY_MAX] = { 0 };
+    size_t plen = prefix ? strnlen(prefix, SPLINTER_KEY_MAX) : 0;
+    int inclusive = 1, visited = 0;
+    uint32_t retries = 0;
+
+    if (!H || !IX || !callback) return -2;
+    spl_follow_resize();
+    if (!splinter_config_test(H, SPL_SYS_KEY_INDEX)) { errno = ENOTSUP; return -1; }
+    if (lo) strncpy(cursor, lo, SPLINTER_KEY_MAX - 1);
+
+    for (;;) {
+        if (atomic_load_explicit(&H->index_stale, memory_order_acquire)) {
+            errno = ESTALE;
+            return -1;
+        }
+        uint64_t seq = atomic_load_explicit(&H->index_seq, memory_order_acquire);
+        if (seq & 1ull) {
+            if (++retries > SPL_INDEX_LOCK_SPINS) { errno = ESTALE; return -1; }
+            if (retries > 64) sched_yield();
+            continue;
+        }
+
+        // Seek to the first node at (or past, after a batch) the cursor.
+        // Hop counts are bounded so a torn link can never loop us forever.
+        size_t hops = 0, max_hops = (size_t)H->slots * SPLINTER_INDEX_LEVELS + 1;
+        uint32_t x = 0, n;
+        for (int l = SPLINTER_INDEX_LEVELS - 1; l >= 0 && hops < max_hops; l--) {
+            while ((n = atomic_load_explicit(ix_link(x, l), memory_order_acquire)) != 0 &&
+                   n <= H->slots && hops++ < max_hops) {
+                int c = strncmp(S[n - 1].key, cursor, SPLINTER_KEY_MAX);
+                if (c > 0 || (c == 0 && inclusive)) break;
+                x = n;
+            }
+        }
+
+        int count = 0, done = 0;
+        n = atomic_load_explicit(ix_link(x, 0), memory_order_acquire);
+        while (count < SPL_INDEX_BATCH && hops++ < max_hops) {
+            if (n == 0 || n > H->slots) { done = 1; break; }
+            memcpy(batch[count].key, S[n - 1].key, SPLINTER_KEY_MAX);
+            batch[count].key[SPLINTER_KEY_MAX - 1] = '\0';
+            if ((hi && strncmp(batch[count].key, hi, SPLINTER_KEY_MAX) >= 0) ||
+                (plen && strncmp(batch[count].key, prefix, plen) != 0)) {
+                done = 1;
+                break;
+            }
+            batch[count].epoch = atomic_load_explicit(&S[n - 1].epoch, memory_order_relaxed);
+            count++;
+            n = atomic_load_explicit(ix_link(n, 0), memory_order_acquire);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&H->index_seq, memory_order_relaxed) != seq) {
+            if (++retries > SPL_INDEX_LOCK_SPINS) { errno = EAGAIN; return -1; }
+            continue;
+        }
+        if (hops >= max_hops && !done && count < SPL_INDEX_BATCH) {
+            // Consistent sequence but no terminator: the links are damaged.
+            atomic_store_explicit(&H->index_stale, 1, memory_order_release);
+            errno = ESTALE;
+            return -1;
+        }
+
+        for (int b = 0; b < count; b++)
+            callback(batch[b].key, batch[b].epoch, user_data);
+        visited += count;
+
+        if (done || count == 0) break;
+        memcpy(cursor, batch[count - 1].key, SPLINTER_KEY_MAX);
+        inclusive = 0;
+        retries = 0;
+    }
+    return visited;
+}
+
+int splinter_scan_prefix(const char *prefix,
+                         void (*callback)(const char *key, uint64_t epoch, void *data),
+                         void *user_data) {
+    return ix_scan(prefix, NULL, prefix, callback, user_data);
+}
+
+int splinter_scan_range(const char *lo, const char *hi,
+                        void (*callback)(const char *key, uint64_t epoch, void *data),
+                        void *user_data) {
+    return ix_scan(lo, hi, NULL, callback, user_data);
+}
+
+int splinter_poll(const char *key, uint64_t timeout_ms) {
+    if (!H || !key) return -2;
+    spl_follow_resize();
+    struct splinter_slot *slot = spl_find_slot(key);
+    if (!slot) return -1;
+
+    uint64_t start_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+    if (start_epoch & 1) { errno = EAGAIN; return -1; }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    add_ms(&deadline, timeout_ms);
+
+    struct timespec sleep_ts = {0, 10 * NS_PER_MS};
+    while (1) {
+        // Resized meanwhile: keep watching the key in the new store. A resize
+        // carries each slot's epoch over, so start_epoch still applies.
+        if (atomic_load_explicit(&H->moved, memory_order_acquire)) {
+            spl_follow_resize();
+            slot = spl_find_slot(key);
+            if (!slot) return -1;
+        }
+        uint64_t cur_epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+        if (!(cur_epoch & 1) && cur_epoch != start_epoch) return 0;
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        if ((now.tv_sec > deadline.tv_sec) ||
+            (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        nanosleep(&sleep_ts, NULL);
+    }
+}
+
+int splinter_get_header_snapshot(splinter_header_snapshot_t *snapshot) {
+    if (!H) return -2;
+    spl_follow_resize();
+    snapshot->magic = H->magic;
+    snapshot->version = H->version;
+    snapshot->slots = H->slots;
+    snapshot->max_val_sz = H->max_val_sz;
+    snapshot->core_flags = atomic_load_explicit(&H->core_flags, memory_order_acquire);
+    snapshot->user_flags = atomic_load_explicit(&H->user_flags, memory_order_acquire);
+    snapshot->epoch = atomic_load_explicit(&H->epoch, memory_order_acquire);
+    snapshot->parse_failures = atomic_load_explicit(&H->parse_failures, memory_order_relaxed);
+    snapshot->last_failure_epoch = atomic_load_explicit(&H->last_failure_epoch, memory_order_relaxed);
+    snapshot->expired = atomic_load_explicit(&H->expired, memory_order_relaxed);
+    snapshot->evicted = atomic_load_explicit(&H->evicted, memory_order_relaxed);
+    snapshot->arena_sz = H->val_sz;
+    snapshot->arena_brk = atomic_load_explicit(&H->val_brk, memory_order_relaxed);
+    snapshot->arena_inuse = atomic_load_explicit(&H->val_inuse, memory_order_relaxed);
+    snapshot->chain_max = spl_chain_max();
+    return 0;
+}
+
+int splinter_get_slot_snapshot(const char *key, splinter_slot_snapshot_t *snapshot) {
+    return splinter_get_slot_snapshot_ex(key, snapshot, SPL_SNAP_ALL);
+}
+
+int splinter_get_slot_snapshot_ex(const char *key, splinter_slot_snapshot_t *snapshot,
+                                  unsigned fields) {
+    if (!H || !key || !snapshot) return -2;
+    spl_follow_resize();
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots), i = 0;
+    for (i = 0; i < H->slots; ++i) {
+        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            if (spl_slot_expired((size_t)(slot - S))) { errno = ENOENT; return -1; }
+            int ok = -1;
+            for (int spin = 0; spin < SPL_ITER_SPINS && ok != 0; spin++) {
+                // Resized meanwhile: the slot will not change here again.
+                if (atomic_load_explicit(&H->moved, memory_order_acquire)) break;
+                ok = spl_slot_copy(slot, snapshot, fields);
+            }
+            if (ok != 0) return spl_stat_eagain();
+            // Unset (and perhaps reused) between the probe and the copy.
+            if (snapshot->hash != h) { errno = ENOENT; return -1; }
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#ifdef SPLINTER_EMBEDDINGS
+static int spl_do_set_embedding(const char *key, const float *vec) {
+    if (!H || !key || !vec) return -2;
+    spl_follow_resize();
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    SPL_PROBE_KEY(h);
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
             uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
+            SPL_PROBE_SLOT(slot - S, e);
             if (e & 1ull) return -1;
             uint64_t want = e + 1;
             if (!atomic_compare_exchange_strong(&slot->epoch, &e, want)) return -1;
+            if (spl_slot_backout(slot, e)) return spl_stat_eagain();
             memcpy(slot->embedding, vec, sizeof(float) * SPLINTER_EMBED_DIM);
             atomic_thread_fence(memory_order_release);
             atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
@@ -587,8 +2635,18 @@ int splinter_set_embedding(const char *key, const float *vec) {
     return -1;
 }
 
+int splinter_set_embedding(const char *key, const float *vec) {
+    SPL_PROBE_ENTRY(set_embedding__entry, key, SPLINTER_EMBED_DIM);
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_set_embedding(key, vec);
+    spl_lat_end(SPL_LAT_SET_EMBEDDING, t0);
+    SPL_PROBE_RETURN(set_embedding__return, rc);
+    return rc;
+}
+
 int splinter_get_embedding(const char *key, float *embedding_out) {
     if (!H || !key || !embedding_out) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -636,6 +2694,7 @@ uint16_t splinter_slot_usr_snapshot(struct splinter_slot *slot) {
 
 int splinter_set_named_type(const char *key, uint16_t mask) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -647,14 +2706,10 @@ int splinter_set_named_type(const char *key, uint16_t mask) {
             if (!atomic_compare_exchange_strong(&slot->epoch, &e, e + 1)) {
                 errno = EAGAIN; return -1;
             }
+            if (spl_slot_backout(slot, e)) { errno = EAGAIN; return -1; }
             atomic_thread_fence(memory_order_acquire);
             uint32_t current_len = atomic_load(&slot->val_len);
             if ((mask & SPL_SLOT_TYPE_BIGUINT) && current_len < 8) {
-                uint32_t new_off = atomic_fetch_add(&H->val_brk, 8);
-                if (new_off + 8 > H->val_sz) {
-                    atomic_fetch_add(&slot->epoch, 1); 
-                    errno = ENOMEM; return -1;
-                }
                 uint8_t *old_ptr = VALUES + slot->val_off;
                 uint64_t converted_val = 0;
                 if (current_len > 0 && old_ptr[0] >= '0' && old_ptr[0] <= '9') {
@@ -664,9 +2719,12 @@ int splinter_set_named_type(const char *key, uint16_t mask) {
                 } else {
                     memcpy(&converted_val, old_ptr, (current_len < 8) ? current_len : 8);
                 }
-                uint64_t *new_ptr = (uint64_t *)(VALUES + new_off);
+                if (spl_slot_reserve(slot, 8, 0) != 0) {
+                    atomic_fetch_add(&slot->epoch, 1);
+                    errno = ENOMEM; return -1;
+                }
+                uint64_t *new_ptr = (uint64_t *)(VALUES + slot->val_off);
                 *new_ptr = converted_val;
-                slot->val_off = new_off;
                 atomic_store_explicit(&slot->val_len, 8, memory_order_relaxed);
             }
             atomic_store_explicit(&slot->type_flag, mask, memory_order_release);
@@ -681,33 +2739,36 @@ int splinter_set_named_type(const char *key, uint16_t mask) {
 
 int splinter_set_slot_time(const char *key, unsigned short mode, uint64_t epoch, size_t offset) {
   if (!H || !key) return -2;
+  spl_follow_resize();
   uint64_t h = fnv1a(key);
   size_t idx = slot_idx(h, H->slots), i;
   for (i = 0; i < H->slots; ++i) {
     struct splinter_slot *slot = &S[(idx + i) % H->slots];
     if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
       strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
-        uint64_t start = atomic_load_explicit(&slot->epoch, memory_order_acquire);
-        if (start & 1) { errno = EAGAIN; return -1; }
-        atomic_thread_fence(memory_order_acquire);
-        switch (mode) {
-          case SPL_TIME_CTIME:
-            atomic_store_explicit(&slot->ctime, epoch - offset, memory_order_release);
-            return 0;
-          case SPL_TIME_ATIME:
-            atomic_store_explicit(&slot->atime, epoch - offset, memory_order_release);
-            return 0;
-          default:
+        if (mode != SPL_TIME_CTIME && mode != SPL_TIME_ATIME) {
             errno = ENOTSUP;
             return -2;
         }
+        uint64_t e;
+        if (spl_slot_hold(slot, &e) != 0) return -1;
+        if (mode == SPL_TIME_CTIME) {
+            atomic_store_explicit(&slot->ctime, epoch - offset, memory_order_release);
+        } else {
+            atomic_store_explicit(&slot->atime, epoch - offset, memory_order_release);
+            // Refreshing atime is an access as far as CLOCK eviction is concerned.
+            spl_slot_touch((size_t)(slot - S));
+        }
+        spl_slot_unhold(slot, e);
+        return 0;
     }
   }
   return -1;
 }
 
-int splinter_integer_op(const char *key, splinter_integer_op_t op, const void *mask) {
+static int spl_do_integer_op(const char *key, splinter_integer_op_t op, const void *mask) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     uint64_t m64 = 0;
@@ -726,6 +2787,11 @@ int splinter_integer_op(const char *key, splinter_integer_op_t op, const void *m
                                                         memory_order_relaxed)) {
                 errno = EAGAIN; return -1;
             }
+            if (spl_slot_backout(slot, e)) { errno = EAGAIN; return -1; }
+            if (spl_slot_chained(slot)) {
+                atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+                errno = EPROTOTYPE; return -1;
+            }
             uint64_t *val = (uint64_t *)(VALUES + slot->val_off);
             switch (op) {
                 case SPL_OP_OR:  *val |= m64;  break;
@@ -744,8 +2810,17 @@ int splinter_integer_op(const char *key, splinter_integer_op_t op, const void *m
     return -1;
 }
 
+int splinter_integer_op(const char *key, splinter_integer_op_t op, const void *mask) {
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_integer_op(key, op, mask);
+    spl_lat_end(SPL_LAT_INTEGER_OP, t0);
+    spl_trace(SPL_TRACE_INTEGER_OP, (uint8_t)op, key, sizeof(uint64_t), rc);
+    return rc;
+}
+
 const void *splinter_get_raw_ptr(const char *key, size_t *out_sz, uint64_t *out_epoch) {
     if (!H || !key) return NULL;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -753,8 +2828,12 @@ const void *splinter_get_raw_ptr(const char *key, size_t *out_sz, uint64_t *out_
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
             uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+            if (spl_slot_expired((size_t)(slot - S))) { errno = ENOENT; return NULL; }
+            // A chained value is not contiguous; splinter_get_iov() maps it.
+            if (spl_slot_chained(slot)) { errno = EMSGSIZE; return NULL; }
             if (out_epoch) *out_epoch = e;
             if (out_sz) *out_sz = (size_t)atomic_load_explicit(&slot->val_len, memory_order_relaxed);
+            spl_slot_touch((size_t)(slot - S));
             return (const void *)(VALUES + slot->val_off);
         }
     }
@@ -763,6 +2842,7 @@ const void *splinter_get_raw_ptr(const char *key, size_t *out_sz, uint64_t *out_
 
 uint64_t splinter_get_epoch(const char *key) {
     if (!H || !key) return 0;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -777,6 +2857,7 @@ uint64_t splinter_get_epoch(const char *key) {
 
 int splinter_bump_slot(const char *key) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -787,6 +2868,7 @@ int splinter_bump_slot(const char *key) {
             if (e & 1ull) return -1; 
             uint64_t want = e + 1;
             if (!atomic_compare_exchange_strong(&slot->epoch, &e, want)) return -1;
+            if (spl_slot_backout(slot, e)) return spl_stat_eagain();
             atomic_thread_fence(memory_order_release);
             splinter_pulse_watchers(slot);
             atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
@@ -798,6 +2880,7 @@ int splinter_bump_slot(const char *key) {
 
 int splinter_retrain_slot(const char *key) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
@@ -816,12 +2899,15 @@ int splinter_retrain_slot(const char *key) {
              * watchers must revalidate the key. This runs even without embeddings
              * compiled in, in which case it just resets the epoch and republishes.
              */
+            // A key a running resize has copied is retrained after the move.
+            if (spl_slot_migrated(slot) && !spl_resize_reap()) return spl_stat_eagain();
             atomic_store_explicit(&slot->epoch, 3, memory_order_release);
             atomic_thread_fence(memory_order_release);
 #ifdef SPLINTER_EMBEDDINGS
             memset(slot->embedding, 0, sizeof(float) * SPLINTER_EMBED_DIM);
 #endif
             atomic_thread_fence(memory_order_release);
+            atomic_store_explicit(&AUX[(idx + i) % H->slots].scrubbed, 0, memory_order_relaxed);
             atomic_store_explicit(&slot->epoch, 4, memory_order_release);
             atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
             splinter_pulse_watchers(slot);
@@ -834,13 +2920,17 @@ int splinter_retrain_slot(const char *key) {
 
 int splinter_set_label(const char *key, uint64_t mask) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t e;
+            if (spl_slot_hold(slot, &e) != 0) return -1;
             atomic_fetch_or_explicit(&slot->bloom, mask, memory_order_release);
+            spl_slot_unhold(slot, e);
             atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
             splinter_event_bus_notify((idx + i) % H->slots);
             return 0;
@@ -851,13 +2941,17 @@ int splinter_set_label(const char *key, uint64_t mask) {
 
 int splinter_unset_label(const char *key, uint64_t mask) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t e;
+            if (spl_slot_hold(slot, &e) != 0) return -1;
             atomic_fetch_and_explicit(&slot->bloom, ~mask, memory_order_release);
+            spl_slot_unhold(slot, e);
             atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
             splinter_event_bus_notify((idx + i) % H->slots);
             return 0;
@@ -888,6 +2982,7 @@ void splinter_client_unset_tandem(const char *base_key, uint8_t orders) {
 
 int splinter_watch_register(const char *key, uint8_t group_id) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     if (group_id >= SPLINTER_MAX_GROUPS) { errno = EINVAL; return -2; }
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
@@ -895,7 +2990,10 @@ int splinter_watch_register(const char *key, uint8_t group_id) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t e;
+            if (spl_slot_hold(slot, &e) != 0) return -1;
             atomic_fetch_or_explicit(&slot->watcher_mask, (1ULL << group_id), memory_order_release);
+            spl_slot_unhold(slot, e);
             return 0;
         }
     }
@@ -904,6 +3002,7 @@ int splinter_watch_register(const char *key, uint8_t group_id) {
 
 int splinter_watch_label_register(uint64_t bloom_mask, uint8_t group_id) {
     if (!H || group_id >= SPLINTER_MAX_GROUPS) return -2;
+    spl_follow_resize();
     for (int i = 0; i < 64; i++) {
         if (bloom_mask & (1ULL << i))
             atomic_store_explicit(&H->bloom_watches[i], group_id, memory_order_release);
@@ -913,6 +3012,7 @@ int splinter_watch_label_register(uint64_t bloom_mask, uint8_t group_id) {
 
 int splinter_pulse_keygroup(const char *key) {
     if (!H || !key) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);  
     for (size_t i = 0; i < H->slots; ++i) {
@@ -935,7 +3035,8 @@ static void splinter_event_bus_notify(size_t physical_idx) {
         memory_order_release);
     uint64_t u = 1;
     int wr = (int)write(g_event_fd, &u, sizeof(u));
-    (void)wr;
+    if (wr == (int)sizeof(u)) SPL_STAT_ADD(eventfd_writes);
+    SPL_PROBE(bus__notify, physical_idx, mapped, wr);
 }
 
 void splinter_pulse_watchers(struct splinter_slot *slot) {
@@ -956,13 +3057,17 @@ void splinter_pulse_watchers(struct splinter_slot *slot) {
 
 int splinter_watch_unregister(const char *key, uint8_t group_id) {
     if (!H || !key || group_id >= SPLINTER_MAX_GROUPS) return -2;
+    spl_follow_resize();
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+            uint64_t e;
+            if (spl_slot_hold(slot, &e) != 0) return -1;
             atomic_fetch_and_explicit(&slot->watcher_mask, ~(1ULL << group_id), memory_order_release);
+            spl_slot_unhold(slot, e);
             return 0;
         }
     }
@@ -971,6 +3076,7 @@ int splinter_watch_unregister(const char *key, uint8_t group_id) {
 
 uint64_t splinter_get_signal_count(uint8_t group_id) {
     if (!H || group_id >= SPLINTER_MAX_GROUPS) return 0;
+    spl_follow_resize();
     return atomic_load_explicit(&H->signal_groups[group_id].counter, memory_order_acquire);
 }
 
@@ -990,23 +3096,29 @@ void splinter_enumerate_matches(uint64_t mask,
 
 int splinter_event_bus_init(void) {
     if (!H) return -1;
+    spl_follow_resize();
     int fd = eventfd(0, EFD_CLOEXEC);
     if (fd < 0) return -1;
     atomic_store_explicit(&H->event_bus.owner_fd,  (int32_t)fd,        memory_order_release);
     atomic_store_explicit(&H->event_bus.owner_pid, (int32_t)getpid(), memory_order_release);
     g_event_fd = fd;
+    SPL_PROBE(bus__init, fd);
     return 0;
 }
 
 int splinter_event_bus_open(void) {
     if (!H) return -1;
+    spl_follow_resize();
     int32_t stored_fd  = atomic_load_explicit(&H->event_bus.owner_fd,  memory_order_acquire);
     int32_t stored_pid = atomic_load_explicit(&H->event_bus.owner_pid, memory_order_acquire);
     if (stored_fd < 0 || stored_pid <= 0) { errno = ENODEV; return -1; }
 
     /* Same process: dup() is the trivial path */
-    if ((pid_t)stored_pid == getpid())
-        return dup((int)stored_fd);
+    if ((pid_t)stored_pid == getpid()) {
+        int fd = dup((int)stored_fd);
+        SPL_PROBE(bus__open, fd, stored_pid);
+        return fd;
+    }
 
     /* Cross-process: use pidfd_getfd (Linux >= 5.6). */
 #if defined(SYS_pidfd_open) && defined(SYS_pidfd_getfd)
@@ -1014,6 +3126,7 @@ int splinter_event_bus_open(void) {
     if (pidfd < 0) return -1;
     int fd = (int)syscall(SYS_pidfd_getfd, pidfd, (int)stored_fd, 0);
     close(pidfd);
+    SPL_PROBE(bus__open, fd, stored_pid);
     return fd;
 #else
     errno = ENOSYS;
@@ -1023,12 +3136,20 @@ int splinter_event_bus_open(void) {
 
 int splinter_event_bus_wait(int fd, uint64_t timeout_ms) {
     if (fd < 0) return -1;
+    SPL_PROBE(bus__wait__entry, fd, timeout_ms);
     struct pollfd pfd = { .fd = fd, .events = POLLIN };
     int t = (timeout_ms == UINT64_MAX) ? -1 :
             (timeout_ms > (uint64_t)INT_MAX) ? INT_MAX : (int)timeout_ms;
-    if (poll(&pfd, 1, t) <= 0) return -1;
-    uint64_t val;
-    return (read(fd, &val, sizeof(val)) == (ssize_t)sizeof(val)) ? 0 : -1;
+    uint64_t val = 0;
+    int rc = -1;
+    if (poll(&pfd, 1, t) > 0)
+        rc = (read(fd, &val, sizeof(val)) == (ssize_t)sizeof(val)) ? 0 : -1;
+    if (rc == 0 && H) {
+        struct splinter_stats_stripe *st = spl_stats();
+        if (st) atomic_fetch_add_explicit(&st->eventfd_reads, val, memory_order_relaxed);
+    }
+    SPL_PROBE(bus__wait__return, fd, rc, val);
+    return rc;
 }
 
 void splinter_event_bus_close(int fd) {
@@ -1037,6 +3158,7 @@ void splinter_event_bus_close(int fd) {
 
 void splinter_event_bus_get_dirty(uint64_t *out, size_t words) {
     if (!H || !out) return;
+    spl_follow_resize();
     size_t n = (words < SPLINTER_EVENT_BUS_MASK_WORDS) ? words : SPLINTER_EVENT_BUS_MASK_WORDS;
     for (size_t i = 0; i < n; i++)
         out[i] = atomic_load_explicit(&H->event_bus.dirty_mask[i], memory_order_acquire);
@@ -1044,27 +3166,50 @@ void splinter_event_bus_get_dirty(uint64_t *out, size_t words) {
 
 int splinter_set_as_system(const char *key) {
     if (!H || !S) return -2;
+    spl_follow_resize();
     size_t idx = 0;
     uint64_t h = fnv1a(key);
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
         if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
             strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0) {
+                uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
+                if ((e & 1ull) || !atomic_compare_exchange_strong(&slot->epoch, &e, e + 1)) {
+                    errno = EAGAIN; return -1;
+                }
+                if (spl_slot_backout(slot, e)) { errno = EAGAIN; return -1; }
+                if (spl_slot_chained(slot)) {
+                    atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+                    errno = EINVAL; return -1;
+                }
+                // A system value spans the whole top-class extent.
+                uint32_t cur_len = atomic_load_explicit(&slot->val_len, memory_order_relaxed);
+                uint64_t old_off = slot->val_off;
+                if (spl_slot_reserve(slot, H->max_val_sz, cur_len) != 0) {
+                    atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+                    return -1;
+                }
+                if (slot->val_off != old_off)
+                    memset(VALUES + slot->val_off + cur_len, 0, H->max_val_sz - cur_len);
                 atomic_store_explicit(&slot->type_flag, SPL_SLOT_TYPE_BINARY, memory_order_release);
                 uint32_t system_sz = H->max_val_sz;
                 atomic_store_explicit(&slot->val_len, system_sz, memory_order_release);
+                atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
                 return 0;
         }
     }
     return -1;
 }
 
-int splinter_append(const char *key, const void *data, size_t data_len, size_t *new_len) {
+static int spl_do_append(const char *key, const void *data, size_t data_len, size_t *new_len) {
     if (!H || !key || !data) return -2;
+    spl_follow_resize();
     if (data_len == 0) return -2;
+    SPL_STAT_ADD(ops[SPL_OP_APPEND]);
 
     uint64_t h = fnv1a(key);
     size_t idx = slot_idx(h, H->slots);
+    SPL_PROBE_KEY(h);
 
     for (size_t i = 0; i < H->slots; ++i) {
         struct splinter_slot *slot = &S[(idx + i) % H->slots];
@@ -1073,40 +3218,473 @@ int splinter_append(const char *key, const void *data, size_t data_len, size_t *
         if (strncmp(slot->key, key, SPLINTER_KEY_MAX) != 0) continue;
 
         uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_relaxed);
-        if (e & 1ull) { errno = EAGAIN; return -1; }
+        SPL_PROBE_SLOT(slot - S, e);
+        if (e & 1ull) return spl_stat_eagain();
 
         if (!atomic_compare_exchange_weak_explicit(&slot->epoch, &e, e + 1,
                                                    memory_order_acq_rel,
                                                    memory_order_relaxed)) {
-            errno = EAGAIN;
+            return spl_stat_eagain();
+        }
+        if (spl_slot_backout(slot, e)) return spl_stat_eagain();
+
+        size_t cur_len = (size_t)atomic_load_explicit(&slot->val_len, memory_order_relaxed);
+        size_t total = cur_len + data_len;
+        const int chain = total > (size_t)H->max_val_sz;
+        if (chain && (!atomic_load_explicit(&H->val_chain, memory_order_relaxed) ||
+                      total > spl_chain_max())) {
+            atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+            errno = EMSGSIZE;
+            return -1;
+        }
+
+        // Grows in place while the extent has room, else relocates keeping
+        // cur_len bytes; past max_val_sz the value becomes (or stays) a chain.
+        if ((chain ? spl_chain_resize(slot, total, cur_len)
+                   : spl_slot_reserve(slot, total, cur_len)) != 0) {
+            atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
             return -1;
         }
 
-        size_t cur_len = (size_t)atomic_load_explicit(&slot->val_len, memory_order_relaxed);
-        if (cur_len + data_len > (size_t)H->max_val_sz) {
-            atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
-            errno = EMSGSIZE;
-            return -1;
-        }
+        if (chain) {
+            spl_chain_write(slot, cur_len, data, data_len);
+        } else {
+            uint8_t *dst = VALUES + slot->val_off + cur_len;
+            memcpy(dst, data, data_len);
+        }
+
+        atomic_store_explicit(&slot->val_len, (uint32_t)total, memory_order_release);
+
+        if (new_len) *new_len = total;
+
+        atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
+        splinter_pulse_watchers(slot);
+        atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
+        splinter_event_bus_notify((idx + i) % H->slots);
+
+        return 0;
+    }
+    SPL_STAT_ADD(misses);
+    return -1;
+}
+
+int splinter_append(const char *key, const void *data, size_t data_len, size_t *new_len) {
+    SPL_PROBE_ENTRY(append__entry, key, data_len);
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_append(key, data, data_len, new_len);
+    spl_lat_end(SPL_LAT_APPEND, t0);
+    spl_trace(SPL_TRACE_APPEND, 0, key, data_len, rc);
+    SPL_PROBE_RETURN(append__return, rc);
+    return rc;
+}
+
+/*
+ * Online resize
+ * -------------
+ * The resizer builds "<name>.resize" beside the live store and walks the old
+ * slots in order. Each slot is held odd just long enough to copy it, then
+ * released with its epoch unchanged and the header's resize_front moved past
+ * it. From then on the old slot still serves reads, but any write that takes
+ * its seqlock finds it below the front and backs out with EAGAIN, so no write
+ * to a key that has already been copied can be lost. Keys written to slots
+ * the walk has not reached are picked up when it gets there; a new key's
+ * probe skips the copied prefix. Once every slot is across, the replacement
+ * is renamed over the store's name and the old header's moved flag sends
+ * attached processes to reopen it. Writes to copied keys therefore wait for
+ * the rest of the walk; reads never do.
+ *
+ * The walk needs both stores' helpers, which all work on this process's
+ * globals, so it runs in a forked child that can point them at either store.
+ * The caller's threads never see its globals move: to them the resize looks
+ * the same as one run by another process. The child records its pid and the
+ * slot it holds, so if it dies the first process to notice can undo the walk
+ * (spl_resize_reap()).
+ */
+
+/** @brief Bounded wait for a mid-write slot before a resize gives up (EBUSY). */
+#define SPL_RESIZE_FREEZE_SPINS (1u << 16)
+
+struct spl_mapping {
+    void *base;
+    size_t sz;
+};
+
+static void spl_mapping_save(struct spl_mapping *m) {
+    m->base = g_base;
+    m->sz = g_total_sz;
+}
+
+static void spl_mapping_use(const struct spl_mapping *m) {
+    g_base = m->base;
+    g_total_sz = m->sz;
+    H = (struct splinter_header *)g_base;
+    spl_map_regions();
+}
+
+/**
+ * @brief Keep a superseded mapping around until the next resize or close, so a
+ * pointer another thread took from it a moment ago does not fault.
+ */
+static void spl_mapping_retire(const struct spl_mapping *m) {
+    if (g_retired_base) munmap(g_retired_base, g_retired_sz);
+    g_retired_base = m->base;
+    g_retired_sz = m->sz;
+}
+
+/** @brief Filesystem path of a store name (the shm object under /dev/shm). */
+static int spl_store_path(const char *name, char *out, size_t n) {
+#ifdef SPLINTER_PERSISTENT
+    int w = snprintf(out, n, "%s", name);
+#else
+    while (*name == '/') name++;
+    int w = snprintf(out, n, "/dev/shm/%s", name);
+#endif
+    return (w < 0 || (size_t)w >= n) ? -1 : 0;
+}
+
+static void spl_remap_lock(void) {
+    while (atomic_flag_test_and_set_explicit(&g_remap_lock, memory_order_acquire))
+        sched_yield();
+}
+
+static void spl_remap_unlock(void) {
+    atomic_flag_clear_explicit(&g_remap_lock, memory_order_release);
+}
+
+/**
+ * @brief If the store was resized under us, reopen it by name. Threads that
+ * see the move together queue on the remap lock; the first one remaps and the
+ * rest find the new header, which is not moved, and return.
+ */
+static void spl_follow_resize(void) {
+    if (!H || !atomic_load_explicit(&H->moved, memory_order_acquire)) return;
+    spl_remap_lock();
+    if (H && atomic_load_explicit(&H->moved, memory_order_acquire)) {
+        struct spl_mapping old;
+        spl_mapping_save(&old);
+        if (splinter_open(g_name) == 0) {
+            spl_mapping_retire(&old);
+        } else {
+            // Could not reopen: stay on the old mapping rather than lose the store.
+            if (g_base != old.base && g_base != MAP_FAILED && g_base) munmap(g_base, g_total_sz);
+            spl_mapping_use(&old);
+        }
+    }
+    spl_remap_unlock();
+}
+
+/** @brief Hold a slot odd, waiting out a writer for a bounded time. */
+static int spl_slot_freeze(struct splinter_slot *slot, uint64_t *out_e) {
+    for (uint32_t spins = 0; spins < SPL_RESIZE_FREEZE_SPINS; spins++) {
+        uint64_t e = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+        if (!(e & 1ull) &&
+            atomic_compare_exchange_weak_explicit(&slot->epoch, &e, e + 1,
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            *out_e = e;
+            return 0;
+        }
+        sched_yield();
+    }
+    return -1;
+}
+
+/** @brief Probe for a live key's slot in the current store. */
+static struct splinter_slot *spl_find_slot(const char *key) {
+    uint64_t h = fnv1a(key);
+    size_t idx = slot_idx(h, H->slots);
+    for (size_t i = 0; i < H->slots; ++i) {
+        struct splinter_slot *slot = &S[(idx + i) % H->slots];
+        if (atomic_load_explicit(&slot->hash, memory_order_acquire) == h &&
+            strncmp(slot->key, key, SPLINTER_KEY_MAX) == 0)
+            return slot;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Place one old slot's key, value and metadata in the current (new)
+ * store, keeping its epoch. Nothing else writes the replacement before it is
+ * renamed into place, so this takes no seqlock, and unlike splinter_set() it
+ * is not traced, counted or signalled and never evicts. The value bytes have
+ * already been read into buf.
+ * @return 0 on success, -1 with errno EMSGSIZE or ENOSPC.
+ */
+static int spl_migrate_slot(const struct splinter_slot *os, const struct splinter_slot_aux *oaux,
+                            uint64_t epoch, const void *buf, size_t len) {
+    const int chain = len > H->max_val_sz;
+    if (chain && (!atomic_load_explicit(&H->val_chain, memory_order_relaxed) ||
+                  len > spl_chain_max())) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    uint64_t h = atomic_load_explicit(&os->hash, memory_order_relaxed);
+    size_t idx = slot_idx(h, H->slots);
+    struct splinter_slot *ns = NULL;
+    for (size_t i = 0; i < H->slots && !ns; i++) {
+        struct splinter_slot *c = &S[(idx + i) % H->slots];
+        if (atomic_load_explicit(&c->hash, memory_order_relaxed) == 0) ns = c;
+    }
+    if (!ns || (chain ? spl_chain_resize(ns, len, 0) : spl_slot_reserve(ns, len, 0)) != 0) {
+        errno = ENOSPC;
+        return -1;
+    }
+    if (chain) spl_chain_write(ns, 0, buf, len);
+    else memcpy(VALUES + ns->val_off, buf, len);
+    atomic_store_explicit(&ns->val_len, (uint32_t)len, memory_order_relaxed);
+    memcpy(ns->key, os->key, SPLINTER_KEY_MAX);
+    ns->key[SPLINTER_KEY_MAX - 1] = '\0';
+    atomic_store_explicit(&ns->type_flag, atomic_load(&os->type_flag), memory_order_relaxed);
+    atomic_store_explicit(&ns->user_flag, atomic_load(&os->user_flag), memory_order_relaxed);
+    atomic_store_explicit(&ns->bloom, atomic_load(&os->bloom), memory_order_relaxed);
+    atomic_store_explicit(&ns->watcher_mask, atomic_load(&os->watcher_mask), memory_order_relaxed);
+    atomic_store_explicit(&ns->ctime, atomic_load(&os->ctime), memory_order_relaxed);
+    atomic_store_explicit(&ns->atime, atomic_load(&os->atime), memory_order_relaxed);
+#ifdef SPLINTER_EMBEDDINGS
+    memcpy(ns->embedding, os->embedding, sizeof(float) * SPLINTER_EMBED_DIM);
+#endif
+    const size_t n = (size_t)(ns - S);
+    spl_slot_set_expiry(n, atomic_load(&oaux->expires));
+    atomic_store_explicit(&ns->hash, h, memory_order_release);
+    spl_occ_set(n);
+    if (splinter_config_test(H, SPL_SYS_KEY_INDEX)) spl_index_insert((uint32_t)n);
+    // Pollers comparing epochs across the move should not see a change.
+    atomic_store_explicit(&ns->epoch, epoch, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Body of the copying child: build tmp beside the store at H, walk the
+ * old slots into it and rename it over name. The child owns its globals, so it
+ * flips them between the two mappings freely; the parent's never move.
+ * @return 0 once the replacement is in place and the old header is marked
+ * moved, else the errno that stopped it (the old store is left as it was).
+ */
+static int spl_resize_copy(const char *tmp, const char *path, const char *tmp_path,
+                           size_t new_slots, size_t new_max_val_sz) {
+    struct spl_mapping old, fresh;
+    struct splinter_header *oh = H;
+    uint8_t *buf = NULL;
+    size_t buf_sz = 0;
+    int err = 0;
+
+    atomic_store_explicit(&oh->resize_owner, (int32_t)getpid(), memory_order_release);
+    spl_mapping_save(&old);
+    unlink(tmp_path);   // a crashed resize's leftovers; we hold the resize flag
+    if (splinter_create_ex(tmp, new_slots, new_max_val_sz, 0) != 0) {
+        err = errno;
+        unlink(tmp_path);
+        goto fail;
+    }
+    spl_mapping_save(&fresh);
+
+    // Carry the store's policy over first, except eviction: the copy must
+    // never evict a key it has just moved.
+    atomic_store(&H->core_flags, atomic_load(&oh->core_flags) & ~SPL_SYS_EVICT);
+    atomic_store(&H->user_flags, atomic_load(&oh->user_flags));
+    atomic_store(&H->val_chain, atomic_load(&oh->val_chain));
+    atomic_store(&H->tier_on, atomic_load(&oh->tier_on));
+    H->ttl_base = oh->ttl_base;
+
+    spl_mapping_use(&old);
+    const uint32_t old_slots = H->slots;
+    for (uint32_t i = 0; i < old_slots && !err; i++) {
+        struct splinter_slot *os = &S[i];
+        uint64_t e;
+        if (spl_slot_freeze(os, &e) != 0) { err = EBUSY; break; }
+        atomic_store_explicit(&oh->resize_held, i + 1, memory_order_relaxed);
+
+        size_t len = atomic_load_explicit(&os->val_len, memory_order_relaxed);
+        if (atomic_load_explicit(&os->hash, memory_order_acquire) != 0 && len != 0 &&
+            !spl_slot_expired(i)) {
+            if (len > buf_sz) {
+                uint8_t *grown = realloc(buf, len);
+                if (grown) {
+                    buf = grown;
+                    buf_sz = len;
+                } else {
+                    err = ENOMEM;
+                }
+            }
+            if (!err) {
+                if (spl_slot_chained(os)) {
+                    spl_chain_copy(os->val_off, len, buf);
+                } else {
+                    memcpy(buf, VALUES + os->val_off, len);
+                }
+                const struct splinter_slot_aux *oaux = &AUX[i];
+                spl_mapping_use(&fresh);
+                if (spl_migrate_slot(os, oaux, e, buf, len) != 0) err = errno;
+                spl_mapping_use(&old);
+            }
+        }
+        // Copied: from here on writers back off the slot, readers carry on.
+        if (!err) atomic_store_explicit(&oh->resize_front, i + 1, memory_order_release);
+        atomic_store_explicit(&oh->resize_held, 0, memory_order_release);
+        atomic_store_explicit(&os->epoch, e, memory_order_release);
+    }
+    free(buf);
+
+    if (!err) {
+        spl_mapping_use(&fresh);
+        atomic_store(&H->core_flags, atomic_load(&oh->core_flags));
+        atomic_store(&H->epoch, atomic_load(&oh->epoch));
+        atomic_store(&H->parse_failures, atomic_load(&oh->parse_failures));
+        atomic_store(&H->last_failure_epoch, atomic_load(&oh->last_failure_epoch));
+        atomic_store(&H->expired, atomic_load(&oh->expired));
+        atomic_store(&H->evicted, atomic_load(&oh->evicted));
+        for (int b = 0; b < 64; b++)
+            atomic_store(&H->bloom_watches[b], atomic_load(&oh->bloom_watches[b]));
+        for (int g = 0; g < SPLINTER_MAX_GROUPS; g++)
+            atomic_store(&H->signal_groups[g].counter, atomic_load(&oh->signal_groups[g].counter));
+        memcpy((void *)&H->event_bus, (const void *)&oh->event_bus, sizeof(H->event_bus));
+        memcpy((void *)H->shard_bids, (const void *)oh->shard_bids, sizeof(H->shard_bids));
+        // Counters and histograms carry over; the copy itself was not counted.
+        memcpy((void *)H->stats, (const void *)oh->stats, sizeof(H->stats));
+        atomic_store(&H->stats_on, atomic_load(&oh->stats_on));
+        memcpy((void *)H->latency, (const void *)oh->latency, sizeof(H->latency));
+        atomic_store(&H->lat_every, atomic_load(&oh->lat_every));
+        atomic_store(&H->tick_hz, atomic_load(&oh->tick_hz));
+        if (rename(tmp_path, path) != 0) err = errno;
+    }
+    if (!err) {
+        atomic_store_explicit(&oh->moved, 1, memory_order_release);
+        return 0;
+    }
+    unlink(tmp_path);
+
+fail:
+    atomic_store(&oh->resize_owner, 0);
+    atomic_store(&oh->resize_front, 0);
+    atomic_store(&oh->resizing, 0);
+    return err;
+}
 
-        uint8_t *dst = VALUES + slot->val_off + cur_len;
-        memcpy(dst, data, data_len);
+/**
+ * @brief Finish the books for a resize whose copier died. A walk that got
+ * through every slot and whose replacement is gone from tmp_path was renamed
+ * into place, so the move is published; anything else is rolled back, the
+ * half-built replacement unlinked and the slot the copier held (unchanged,
+ * since copying only reads it) put back to its even epoch.
+ * @return 1 if the move was published, 0 if it was rolled back.
+ */
+static int spl_resize_settle(const char *tmp_path) {
+    if (unlink(tmp_path) != 0 && errno == ENOENT &&
+        atomic_load_explicit(&H->resize_front, memory_order_acquire) == H->slots) {
+        atomic_store_explicit(&H->moved, 1, memory_order_release);
+        return 1;
+    }
+    uint32_t held = atomic_load_explicit(&H->resize_held, memory_order_acquire);
+    if (held && held <= H->slots) {
+        atomic_fetch_sub_explicit(&S[held - 1].epoch, 1, memory_order_release);
+        atomic_store_explicit(&H->resize_held, 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&H->resize_front, 0, memory_order_release);
+    atomic_store_explicit(&H->resizing, 0, memory_order_release);
+    return 0;
+}
 
-        size_t total = cur_len + data_len;
-        atomic_store_explicit(&slot->val_len, (uint32_t)total, memory_order_release);
+/**
+ * @brief Take over a resize whose owner is dead and settle it. Only the
+ * caller whose CAS clears resize_owner does so; the rest see its outcome.
+ * @return 1 if the resize was rolled back, so the store is writable again.
+ */
+static int spl_resize_settle_dead(int32_t owner) {
+    char tmp[sizeof(g_name)], tmp_path[PATH_MAX];
+    if (owner == 0 ||
+        !atomic_compare_exchange_strong(&H->resize_owner, &owner, 0) ||
+        snprintf(tmp, sizeof(tmp), "%s.resize", g_name) >= (int)sizeof(tmp) ||
+        spl_store_path(tmp, tmp_path, sizeof(tmp_path)) != 0)
+        return 0;
+    return !spl_resize_settle(tmp_path);
+}
 
-        if (new_len) *new_len = total;
+/**
+ * @brief Settle a resize whose copier has died, as the index lock does for a
+ * dead holder. Called by writers that find a slot already copied and by a
+ * resize that finds the flag taken; errno is kept for their own error.
+ * @return 1 if the resize was rolled back, 0 if none is stuck (or it turned
+ * out to be published).
+ */
+static int spl_resize_reap(void) {
+    if (!atomic_load_explicit(&H->resizing, memory_order_acquire)) return 0;
+    int saved = errno;
+    int32_t owner = atomic_load_explicit(&H->resize_owner, memory_order_acquire);
+    int rc = spl_pid_dead(owner) && spl_resize_settle_dead(owner);
+    errno = saved;
+    return rc;
+}
 
-        atomic_fetch_add_explicit(&slot->epoch, 1, memory_order_release);
-        splinter_pulse_watchers(slot);
-        atomic_fetch_add_explicit(&H->epoch, 1, memory_order_relaxed);
-        splinter_event_bus_notify((idx + i) % H->slots);
+/**
+ * @brief Run a resize of the store this process has mapped. The copy happens
+ * in a forked child (spl_resize_copy()) while this process waits, so other
+ * threads here keep using the old mapping like any other attached process,
+ * and follow the move afterwards. A child that exits without saying why is
+ * reported as EIO.
+ */
+static int spl_do_resize(size_t new_slots, size_t new_max_val_sz) {
+    uint8_t idle = 0;
+    if (!atomic_compare_exchange_strong(&H->resizing, &idle, 1)) {
+        // A resize whose copier died is rolled back; then try once more.
+        idle = 0;
+        if (!spl_resize_reap() || !atomic_compare_exchange_strong(&H->resizing, &idle, 1)) {
+            errno = EBUSY;
+            return -1;
+        }
+    }
+    atomic_store_explicit(&H->resize_front, 0, memory_order_release);
+    atomic_store_explicit(&H->resize_owner, (int32_t)getpid(), memory_order_release);
+
+    char tmp[sizeof(g_name)], path[PATH_MAX], tmp_path[PATH_MAX];
+    struct splinter_header *oh = H;
+    int err;
+
+    if (snprintf(tmp, sizeof(tmp), "%s.resize", g_name) >= (int)sizeof(tmp) ||
+        spl_store_path(g_name, path, sizeof(path)) != 0 ||
+        spl_store_path(tmp, tmp_path, sizeof(tmp_path)) != 0) {
+        atomic_store(&oh->resize_owner, 0);
+        atomic_store(&oh->resizing, 0);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
 
-        return 0;
+    pid_t child = fork();
+    if (child < 0) {
+        err = errno;
+        atomic_store(&oh->resize_owner, 0);
+        atomic_store(&oh->resizing, 0);
+        errno = err;
+        return -1;
     }
+    if (child == 0) _exit(spl_resize_copy(tmp, path, tmp_path, new_slots, new_max_val_sz));
+
+    int st = 0;
+    pid_t w;
+    while ((w = waitpid(child, &st, 0)) < 0 && errno == EINTR) {}
+    if (atomic_load_explicit(&oh->moved, memory_order_acquire)) return 0;
+    // The child is gone, whoever it left as owner (itself, or us if it died
+    // before taking over).
+    if (atomic_load(&oh->resizing) &&
+        !spl_resize_settle_dead(atomic_load(&oh->resize_owner)) &&
+        atomic_load_explicit(&oh->moved, memory_order_acquire))
+        return 0;
+    err = (w == child && WIFEXITED(st) && WEXITSTATUS(st) != 0) ? WEXITSTATUS(st) : EIO;
+    errno = err;
     return -1;
 }
 
+int splinter_resize(size_t new_slots, size_t new_max_val_sz) {
+    if (!H) return -2;
+    spl_follow_resize();
+    if (new_slots == 0 || new_slots > UINT32_MAX || new_max_val_sz == 0) {
+        errno = EINVAL;
+        return -2;
+    }
+    int rc = spl_do_resize(new_slots, new_max_val_sz);
+    // Switch the caller over at once rather than on its next call.
+    if (rc == 0) spl_follow_resize();
+    return rc;
+}
+
 /* 
  * Logic Shard Election & Voluntary Yield
  *
@@ -1153,45 +3731,148 @@ static int spl_bid_expired(const struct splinter_shard_bid *bid, uint64_t now) {
     return (now - claimed) >= dur;
 }
 
-int splinter_shard_claim_ex(uint32_t shard_id, uint32_t pid, uint8_t intent,
-                            uint8_t priority, uint64_t duration_tsc,
-                            uint64_t claimed_at) {
+/** @brief Invalidate the cached election after a bid-table write. */
+static inline void spl_shard_touch(void) {
+    atomic_fetch_add_explicit(&H->shard_gen, 1, memory_order_release);
+}
+
+/**
+ * @brief Ticks from now until the bid's expiry test next flips: at claimed_at
+ * (a bid stamped in the future comes alive) or at claimed_at + duration_tsc.
+ * Modular like spl_bid_expired(); 0 means no flip is pending.
+ */
+static uint64_t spl_bid_next_flip(const struct splinter_shard_bid *bid, uint64_t now) {
+    uint64_t claimed = atomic_load_explicit(&bid->claimed_at,   memory_order_acquire);
+    uint64_t dur     = atomic_load_explicit(&bid->duration_tsc, memory_order_acquire);
+    uint64_t to_start = claimed - now, to_end = claimed + dur - now;
+    if (!to_start) return to_end;
+    if (!to_end) return to_start;
+    return to_start < to_end ? to_start : to_end;
+}
+
+/**
+ * @brief Reuse the last election if no bid changed and no bid has started or
+ * expired since. Two loads of elect_seq bracket the read, as for a slot.
+ * scoped reports whether any bid then carried a scope.
+ */
+static int spl_election_cached(uint64_t now, uint32_t *id, uint8_t *intent, int *scoped) {
+    uint64_t s = atomic_load_explicit(&H->elect_seq, memory_order_acquire);
+    if (s & 1) return 0;
+    uint64_t gen  = atomic_load_explicit(&H->elect_gen,  memory_order_relaxed);
+    uint64_t at   = atomic_load_explicit(&H->elect_at,   memory_order_relaxed);
+    uint64_t span = atomic_load_explicit(&H->elect_span, memory_order_relaxed);
+    uint64_t win  = atomic_load_explicit(&H->elect_win,  memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&H->elect_seq, memory_order_relaxed) != s) return 0;
+    if (gen != atomic_load_explicit(&H->shard_gen, memory_order_acquire)) return 0;
+    if (now - at >= span) return 0;
+    *id = (uint32_t)(win >> 8);
+    *intent = (uint8_t)win;
+    *scoped = (int)(win >> 63);
+    return 1;
+}
+
+/** @brief Publish an election computed from bid generation gen at now. */
+static void spl_election_store(uint64_t gen, uint64_t now, uint64_t span,
+                               uint32_t id, uint8_t intent, int scoped) {
+    uint64_t s = atomic_load_explicit(&H->elect_seq, memory_order_relaxed);
+    // Someone else is publishing; theirs will do.
+    if ((s & 1) || !atomic_compare_exchange_strong_explicit(&H->elect_seq, &s, s + 1,
+                                                            memory_order_acquire,
+                                                            memory_order_relaxed))
+        return;
+    atomic_store_explicit(&H->elect_gen,  gen,  memory_order_relaxed);
+    atomic_store_explicit(&H->elect_at,   now,  memory_order_relaxed);
+    atomic_store_explicit(&H->elect_span, span, memory_order_relaxed);
+    atomic_store_explicit(&H->elect_win,  ((uint64_t)(scoped != 0) << 63) | ((uint64_t)id << 8) | intent,
+                          memory_order_relaxed);
+    atomic_store_explicit(&H->elect_seq, s + 2, memory_order_release);
+}
+
+static void spl_bid_scope(const struct splinter_shard_bid *bid, splinter_shard_scope_t *sc) {
+    sc->slot_lo = atomic_load_explicit(&bid->slot_lo, memory_order_acquire);
+    sc->slot_hi = atomic_load_explicit(&bid->slot_hi, memory_order_acquire);
+    sc->labels  = atomic_load_explicit(&bid->labels,  memory_order_acquire);
+}
+
+static inline int spl_scope_whole(const splinter_shard_scope_t *sc) {
+    return sc->slot_lo >= sc->slot_hi && !sc->labels;
+}
+
+/**
+ * @brief Whether two scopes may share a slot. The whole store overlaps
+ * anything, and a range meets any label mask (labels move between slots).
+ */
+static int spl_scope_overlap(const splinter_shard_scope_t *a, const splinter_shard_scope_t *b) {
+    if (spl_scope_whole(a) || spl_scope_whole(b)) return 1;
+    int ar = a->slot_lo < a->slot_hi, br = b->slot_lo < b->slot_hi;
+    if ((ar && b->labels) || (a->labels && br)) return 1;
+    if (ar && br && a->slot_lo < b->slot_hi && b->slot_lo < a->slot_hi) return 1;
+    return (a->labels & b->labels) != 0;
+}
+
+/** @brief The bid record holding shard_id, or NULL if it has none. */
+static struct splinter_shard_bid *spl_shard_find(uint32_t shard_id) {
+    for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++)
+        if (atomic_load_explicit(&H->shard_bids[b].shard_id, memory_order_acquire) == shard_id)
+            return &H->shard_bids[b];
+    return NULL;
+}
+
+/**
+ * @brief Claim or refresh shard_id's bid. With fresh set, an id that already
+ * has a bid is refused (EBUSY) instead of refreshed.
+ */
+static int spl_shard_claim(uint32_t shard_id, uint32_t pid, uint8_t intent,
+                           uint8_t priority, uint64_t duration_tsc,
+                           uint64_t claimed_at, const splinter_shard_scope_t *scope,
+                           int fresh) {
+    static const splinter_shard_scope_t whole = { 0, 0, 0 };
     if (!H || shard_id == 0) return -2;
+    spl_follow_resize();
+    if (!scope) scope = &whole;
+    if (scope->slot_lo > scope->slot_hi) return -2;
 
     /* First pass: refresh if we already own a slot (idempotent re-claim). */
-    for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
-        struct splinter_shard_bid *bid = &H->shard_bids[b];
-        if (atomic_load_explicit(&bid->shard_id, memory_order_acquire) == shard_id) {
-            atomic_store_explicit(&bid->pid,          pid,          memory_order_release);
-            atomic_store_explicit(&bid->intent,       intent,       memory_order_release);
-            atomic_store_explicit(&bid->priority,     priority,     memory_order_release);
-            atomic_store_explicit(&bid->duration_tsc, duration_tsc, memory_order_release);
-            atomic_store_explicit(&bid->claimed_at,   claimed_at,   memory_order_release);
-            return 0;
-        }
+    struct splinter_shard_bid *bid = spl_shard_find(shard_id);
+    if (bid && fresh) {
+        errno = EBUSY;
+        return -1;
     }
 
-    /* Second pass: CAS-claim the first empty slot. */
-    for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
-        struct splinter_shard_bid *bid = &H->shard_bids[b];
+    /* Second pass: CAS-claim the first empty slot. A racing election may see
+     * shard_id but stale fields for one election; the next election corrects
+     * it (see header note). */
+    for (size_t b = 0; !bid && b < SPLINTER_MAX_SHARDS; b++) {
         uint32_t expected = 0;
-        if (atomic_compare_exchange_strong_explicit(&bid->shard_id, &expected, shard_id,
+        if (atomic_compare_exchange_strong_explicit(&H->shard_bids[b].shard_id, &expected, shard_id,
                                                     memory_order_acq_rel,
-                                                    memory_order_relaxed)) {
-            /* Slot is ours; publish the descriptive fields (release) after the
-             * shard_id CAS. A racing election may see shard_id but stale fields
-             * for one election; the next election corrects it (see header note). */
-            atomic_store_explicit(&bid->pid,          pid,          memory_order_release);
-            atomic_store_explicit(&bid->intent,       intent,       memory_order_release);
-            atomic_store_explicit(&bid->priority,     priority,     memory_order_release);
-            atomic_store_explicit(&bid->duration_tsc, duration_tsc, memory_order_release);
-            atomic_store_explicit(&bid->claimed_at,   claimed_at,   memory_order_release);
-            return 0;
-        }
+                                                    memory_order_relaxed))
+            bid = &H->shard_bids[b];
+    }
+    if (!bid) {
+        errno = ENOSPC;
+        return -1;
     }
 
-    errno = ENOSPC;
-    return -1;
+    /* Slot is ours; publish the descriptive fields (release) after the
+     * shard_id CAS. */
+    atomic_store_explicit(&bid->pid,          pid,             memory_order_release);
+    atomic_store_explicit(&bid->intent,       intent,          memory_order_release);
+    atomic_store_explicit(&bid->priority,     priority,        memory_order_release);
+    atomic_store_explicit(&bid->duration_tsc, duration_tsc,    memory_order_release);
+    atomic_store_explicit(&bid->slot_lo,      scope->slot_lo,  memory_order_release);
+    atomic_store_explicit(&bid->slot_hi,      scope->slot_hi,  memory_order_release);
+    atomic_store_explicit(&bid->labels,       scope->labels,   memory_order_release);
+    atomic_store_explicit(&bid->claimed_at,   claimed_at,      memory_order_release);
+    spl_shard_touch();
+    return 0;
+}
+
+int splinter_shard_claim_ex(uint32_t shard_id, uint32_t pid, uint8_t intent,
+                            uint8_t priority, uint64_t duration_tsc,
+                            uint64_t claimed_at) {
+    return spl_shard_claim(shard_id, pid, intent, priority, duration_tsc, claimed_at, NULL, 0);
 }
 
 int splinter_shard_claim(uint32_t shard_id, uint8_t intent,
@@ -1200,9 +3881,16 @@ int splinter_shard_claim(uint32_t shard_id, uint8_t intent,
                                    priority, duration_tsc, splinter_now());
 }
 
+int splinter_shard_claim_scoped(uint32_t shard_id, uint8_t intent, uint8_t priority,
+                                uint64_t duration_tsc, const splinter_shard_scope_t *scope) {
+    return spl_shard_claim(shard_id, (uint32_t)getpid(), intent, priority,
+                           duration_tsc, splinter_now(), scope, 0);
+}
+
 int splinter_shard_rebid(uint32_t shard_id, uint8_t intent,
                          uint8_t priority, uint64_t duration_tsc) {
     if (!H || shard_id == 0) return -2;
+    spl_follow_resize();
     for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
         struct splinter_shard_bid *bid = &H->shard_bids[b];
         if (atomic_load_explicit(&bid->shard_id, memory_order_acquire) == shard_id) {
@@ -1210,6 +3898,7 @@ int splinter_shard_rebid(uint32_t shard_id, uint8_t intent,
             atomic_store_explicit(&bid->priority,     priority,     memory_order_release);
             atomic_store_explicit(&bid->duration_tsc, duration_tsc, memory_order_release);
             atomic_store_explicit(&bid->claimed_at,   splinter_now(), memory_order_release);
+            spl_shard_touch();
             return 0;
         }
     }
@@ -1218,6 +3907,7 @@ int splinter_shard_rebid(uint32_t shard_id, uint8_t intent,
 
 int splinter_shard_release(uint32_t shard_id) {
     if (!H || shard_id == 0) return -2;
+    spl_follow_resize();
     for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
         struct splinter_shard_bid *bid = &H->shard_bids[b];
         if (atomic_load_explicit(&bid->shard_id, memory_order_acquire) == shard_id) {
@@ -1228,88 +3918,182 @@ int splinter_shard_release(uint32_t shard_id) {
             atomic_store_explicit(&bid->priority,     0, memory_order_release);
             atomic_store_explicit(&bid->duration_tsc, 0, memory_order_release);
             atomic_store_explicit(&bid->claimed_at,   0, memory_order_release);
+            atomic_store_explicit(&bid->slot_lo,      0, memory_order_release);
+            atomic_store_explicit(&bid->slot_hi,      0, memory_order_release);
+            atomic_store_explicit(&bid->labels,       0, memory_order_release);
             atomic_store_explicit(&bid->shard_id,     0, memory_order_release);
+            spl_shard_touch();
             return 0;
         }
     }
     return -1;
 }
 
-uint32_t splinter_shard_election(uint8_t *out_intent) {
-    if (out_intent) *out_intent = SPL_INTENT_NONE;
-    if (!H) return 0;
-
-    uint64_t now = splinter_now();
-    int live_protective = 0;   /* any unexpired WILLNEED/SEQUENTIAL present? */
+/** @brief Outcome of one pass of the election. */
+struct spl_election {
+    uint32_t id;
+    uint8_t  intent;
+    uint8_t  prio;
+    uint32_t pid;
+    int      protective;  /* live WILLNEED/SEQUENTIAL bids seen */
+    int      scoped;      /* any claimed bid carries a scope */
+    uint64_t span;        /* ticks until some bid starts or expires */
+};
 
-    /* Pass 1: detect protective bids for the DONTNEED soft bumper. */
+/**
+ * @brief The election proper, over the live bids overlapping region (all of
+ * them if region is NULL). A DONTNEED bid is bumped if any live protective
+ * bid overlaps its own scope, wherever the region is, so that bumping is a
+ * property of the bid and two overlapping bids never both win.
+ */
+static void spl_elect(const splinter_shard_scope_t *region, uint64_t now, struct spl_election *e) {
+    splinter_shard_scope_t prot[SPLINTER_MAX_SHARDS];
+    int nprot = 0;
+    memset(e, 0, sizeof(*e));
+    e->intent = SPL_INTENT_NONE;
+    e->span = UINT64_MAX;
+
+    /* Pass 1: collect protective bids for the DONTNEED soft bumper. */
     for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
         struct splinter_shard_bid *bid = &H->shard_bids[b];
         if (atomic_load_explicit(&bid->shard_id, memory_order_acquire) == 0) continue;
         if (spl_bid_expired(bid, now)) continue;
         uint8_t it = atomic_load_explicit(&bid->intent, memory_order_acquire);
-        if (it == SPL_INTENT_WILLNEED || it == SPL_INTENT_SEQUENTIAL) {
-            live_protective = 1;
-            break;
-        }
+        if (it == SPL_INTENT_WILLNEED || it == SPL_INTENT_SEQUENTIAL)
+            spl_bid_scope(bid, &prot[nprot++]);
     }
+    e->protective = nprot;
 
     /* Pass 2: pick the winner. */
     int have_best = 0;
-    uint32_t best_id = 0;
-    uint8_t  best_intent = SPL_INTENT_NONE;
-    uint8_t  best_prio = 0;
     uint64_t best_claimed = 0;
-    uint32_t best_pid = 0;
 
     for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
         struct splinter_shard_bid *bid = &H->shard_bids[b];
         uint32_t id = atomic_load_explicit(&bid->shard_id, memory_order_acquire);
         if (id == 0) continue;
+        uint64_t flip = spl_bid_next_flip(bid, now);
+        if (flip && flip < e->span) e->span = flip;
+        splinter_shard_scope_t sc;
+        spl_bid_scope(bid, &sc);
+        if (!spl_scope_whole(&sc)) e->scoped = 1;
         if (spl_bid_expired(bid, now)) continue;
+        if (region && !spl_scope_overlap(region, &sc)) continue;
 
         uint8_t  it = atomic_load_explicit(&bid->intent,     memory_order_acquire);
         uint8_t  pr = atomic_load_explicit(&bid->priority,   memory_order_acquire);
         uint64_t ca = atomic_load_explicit(&bid->claimed_at, memory_order_acquire);
         uint32_t pd = atomic_load_explicit(&bid->pid,        memory_order_acquire);
 
-        /* DONTNEED soft bumper: cannot win while live protective bids exist. */
-        if (it == SPL_INTENT_DONTNEED && live_protective) continue;
+        /* DONTNEED soft bumper: cannot win while a live protective bid overlaps it. */
+        if (it == SPL_INTENT_DONTNEED) {
+            int bumped = 0;
+            for (int p = 0; p < nprot && !bumped; p++)
+                bumped = spl_scope_overlap(&prot[p], &sc);
+            if (bumped) continue;
+        }
 
         int beats;
         if (!have_best) {
             beats = 1;
-        } else if (pr != best_prio) {
-            beats = (pr > best_prio);          /* higher priority wins */
+        } else if (pr != e->prio) {
+            beats = (pr > e->prio);            /* higher priority wins */
         } else if (ca != best_claimed) {
             beats = (ca < best_claimed);       /* earlier claim wins */
         } else {
-            beats = (pd < best_pid);           /* lowest pid wins */
+            beats = (pd < e->pid);             /* lowest pid wins */
         }
 
         if (beats) {
             have_best = 1;
-            best_id = id; best_intent = it; best_prio = pr;
-            best_claimed = ca; best_pid = pd;
+            e->id = id; e->intent = it; e->prio = pr;
+            best_claimed = ca; e->pid = pd;
         }
     }
+}
+
+/** @brief The whole-table election, cached; scoped as for spl_election_cached(). */
+static uint32_t spl_shard_winner(uint64_t now, uint8_t *out_intent, int *scoped) {
+    uint32_t cached_id;
+    uint8_t  cached_intent;
+    if (spl_election_cached(now, &cached_id, &cached_intent, scoped)) {
+        if (out_intent) *out_intent = cached_intent;
+        SPL_PROBE(shard_election__cached, cached_id, cached_intent);
+        return cached_id;
+    }
+
+    /* Read the generation first: a bid written during the scan bumps it past
+     * this, so the result is never cached under the newer generation. */
+    uint64_t gen = atomic_load_explicit(&H->shard_gen, memory_order_acquire);
+    struct spl_election e;
+    spl_elect(NULL, now, &e);
+
+    if (out_intent) *out_intent = e.intent;
+    *scoped = e.scoped;
+    SPL_PROBE(shard_election__return, e.id, e.intent, e.prio, e.pid, e.protective);
+    spl_election_store(gen, now, e.span, e.id, e.intent, e.scoped);
+
+    /* Only a changed winner writes the shared line, and only while counting. */
+    if (atomic_load_explicit(&H->stats_on, memory_order_relaxed)) {
+        uint32_t last = atomic_load_explicit(&H->sovereign_last, memory_order_relaxed);
+        if (last != e.id &&
+            atomic_compare_exchange_strong_explicit(&H->sovereign_last, &last, e.id,
+                                                    memory_order_relaxed, memory_order_relaxed))
+            SPL_STAT_ADD(sovereign_changes);
+    }
+    return e.id;
+}
+
+uint32_t splinter_shard_election(uint8_t *out_intent) {
+    if (out_intent) *out_intent = SPL_INTENT_NONE;
+    if (!H) return 0;
+    spl_follow_resize();
+    SPL_PROBE(shard_election__entry, getpid());
+    int scoped;
+    return spl_shard_winner(splinter_now(), out_intent, &scoped);
+}
+
+/**
+ * @brief Whether shard_id wins over its own scope: 1 if so, 0 if not, -1 if
+ * it holds no bid. While no bid is scoped this is the cached whole-table
+ * election. The bid's scope is copied to scope_out if given.
+ */
+static int spl_shard_sovereign(uint32_t shard_id, splinter_shard_scope_t *scope_out) {
+    uint64_t now = splinter_now();
+    int scoped;
+    uint32_t winner = spl_shard_winner(now, NULL, &scoped);
+    if (winner == shard_id && !scoped) {
+        if (scope_out) memset(scope_out, 0, sizeof(*scope_out));
+        return 1;
+    }
 
-    if (out_intent) *out_intent = have_best ? best_intent : SPL_INTENT_NONE;
-    return have_best ? best_id : 0;
+    splinter_shard_scope_t sc;
+    size_t b;
+    for (b = 0; b < SPLINTER_MAX_SHARDS; b++) {
+        if (atomic_load_explicit(&H->shard_bids[b].shard_id, memory_order_acquire) == shard_id) break;
+    }
+    if (b == SPLINTER_MAX_SHARDS) return -1;
+    spl_bid_scope(&H->shard_bids[b], &sc);
+    if (scope_out) *scope_out = sc;
+    // An unscoped bid's region is the whole table: the cached result stands.
+    if (!scoped || spl_scope_whole(&sc)) return winner == shard_id;
+
+    struct spl_election e;
+    spl_elect(&sc, now, &e);
+    return e.id == shard_id;
 }
 
 int splinter_shard_is_sovereign(uint32_t shard_id) {
     if (!H) return -2;
-    return (splinter_shard_election(NULL) == shard_id && shard_id != 0) ? 1 : 0;
+    spl_follow_resize();
+    return (shard_id != 0 && spl_shard_sovereign(shard_id, NULL) == 1) ? 1 : 0;
 }
 
 int splinter_shard_table_snapshot(struct splinter_shard_bid_snapshot *out, size_t max) {
     if (!H || !out) return -2;
+    spl_follow_resize();
 
     uint64_t now = splinter_now();
-    uint8_t  sov_intent = SPL_INTENT_NONE;
-    uint32_t sovereign  = splinter_shard_election(&sov_intent);
-
     size_t n = (max < SPLINTER_MAX_SHARDS) ? max : SPLINTER_MAX_SHARDS;
     for (size_t b = 0; b < n; b++) {
         struct splinter_shard_bid *bid = &H->shard_bids[b];
@@ -1320,14 +4104,161 @@ int splinter_shard_table_snapshot(struct splinter_shard_bid_snapshot *out, size_
         out[b].priority     = atomic_load_explicit(&bid->priority,     memory_order_acquire);
         out[b].duration_tsc = atomic_load_explicit(&bid->duration_tsc, memory_order_acquire);
         out[b].claimed_at   = atomic_load_explicit(&bid->claimed_at,   memory_order_acquire);
+        out[b].slot_lo      = atomic_load_explicit(&bid->slot_lo,      memory_order_acquire);
+        out[b].slot_hi      = atomic_load_explicit(&bid->slot_hi,      memory_order_acquire);
+        out[b].labels       = atomic_load_explicit(&bid->labels,       memory_order_acquire);
         out[b].expired      = (id != 0) ? spl_bid_expired(bid, now) : 1;
-        out[b].sovereign    = (id != 0 && id == sovereign) ? 1 : 0;
+        out[b].sovereign    = (id != 0 && spl_shard_sovereign(id, NULL) == 1) ? 1 : 0;
     }
     return (int)n;
 }
 
-int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
-                     int advice, uint64_t timeout_ticks) {
+/*
+ * splinter_madvise() keeps what it needs across calls: the page size, and
+ * one bus fd per process (not per call) tagged with the owner it was taken
+ * from. A fd superseded by a new bus owner is parked, not closed, since
+ * another thread may still be waiting on it; splinter_close() closes them.
+ */
+#define SPL_MADV_RETIRED 8
+
+static long g_page_sz;
+static atomic_int g_madv_fd = -1;
+static _Atomic uint64_t g_madv_owner;
+static atomic_int g_madv_retired[SPL_MADV_RETIRED] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+
+static long spl_page_size(void) {
+    if (!g_page_sz) g_page_sz = sysconf(_SC_PAGESIZE);
+    return g_page_sz;
+}
+
+/** @brief This process's handle on the store's event bus; -1 if it has none. */
+static int spl_madv_bus(void) {
+    int32_t ofd  = atomic_load_explicit(&H->event_bus.owner_fd,  memory_order_acquire);
+    int32_t opid = atomic_load_explicit(&H->event_bus.owner_pid, memory_order_acquire);
+    if (ofd < 0 || opid <= 0) return -1;
+    uint64_t owner = ((uint64_t)(uint32_t)opid << 32) | (uint32_t)ofd;
+
+    int fd = atomic_load_explicit(&g_madv_fd, memory_order_acquire);
+    if (fd >= 0 && atomic_load_explicit(&g_madv_owner, memory_order_acquire) == owner)
+        return fd;
+
+    int nfd = splinter_event_bus_open();
+    if (nfd < 0) return -1;
+    atomic_store_explicit(&g_madv_owner, owner, memory_order_release);
+    int old = atomic_exchange_explicit(&g_madv_fd, nfd, memory_order_acq_rel);
+    if (old >= 0) {
+        // Park it; past the last spot the oldest has long been out of use.
+        int k;
+        for (k = 0; k < SPL_MADV_RETIRED; k++) {
+            int none = -1;
+            if (atomic_compare_exchange_strong(&g_madv_retired[k], &none, old)) break;
+        }
+        if (k == SPL_MADV_RETIRED)
+            close(atomic_exchange(&g_madv_retired[0], old));
+    }
+    return nfd;
+}
+
+/** @brief Close the madvise bus handles (splinter_close). */
+static void spl_madv_bus_close(void) {
+    int fd = atomic_exchange(&g_madv_fd, -1);
+    if (fd >= 0) close(fd);
+    for (int k = 0; k < SPL_MADV_RETIRED; k++) {
+        fd = atomic_exchange(&g_madv_retired[k], -1);
+        if (fd >= 0) close(fd);
+    }
+    atomic_store(&g_madv_owner, 0);
+}
+
+/** @brief Whether slot i lies in a (non-whole) scope. */
+static inline int spl_scope_has(const splinter_shard_scope_t *sc, size_t i) {
+    if (i >= sc->slot_lo && i < sc->slot_hi) return 1;
+    return sc->labels &&
+           (atomic_load_explicit(&S[i].bloom, memory_order_relaxed) & sc->labels);
+}
+
+/**
+ * @brief Call fn for each arena extent holding slot's value: the slot's own
+ * extent, then each segment if it is a chain descriptor. Read without the
+ * slot seqlock; a slot rewritten meanwhile is seen where it was, which is
+ * harmless for a hint. Extents that fall outside the arena are skipped.
+ */
+static void spl_slot_extents(const struct splinter_slot *slot,
+                             void (*fn)(uint64_t off, uint64_t sz, void *ctx), void *ctx) {
+    uint32_t ext = spl_slot_extent(slot);
+    uint64_t off = slot->val_off;
+    if (!ext || off >= H->val_sz || ext > H->val_sz - off) return;
+    fn(off, ext, ctx);
+    if (!spl_slot_chained(slot)) return;
+    uint32_t n = spl_chain_segs(atomic_load_explicit(&slot->val_len, memory_order_relaxed));
+    if (n > ext / 4) n = ext / 4;
+    const uint32_t *desc = spl_chain_desc(slot);
+    for (uint32_t k = 0; k < n; k++) {
+        uint64_t seg = spl_chain_seg(desc, k);
+        if (seg < H->val_sz && H->val_top_sz <= H->val_sz - seg) fn(seg, H->val_top_sz, ctx);
+    }
+}
+
+/** @brief A run of adjacent pages being gathered for one posix_madvise(). */
+struct spl_advise_run {
+    uintptr_t pg, lo, hi;
+    int advice, rc;
+};
+
+static void spl_advise_flush(struct spl_advise_run *run) {
+    if (run->hi > run->lo) {
+        int r = posix_madvise((void *)run->lo, run->hi - run->lo, run->advice);
+        if (r && !run->rc) run->rc = r;
+    }
+    run->lo = run->hi = 0;
+}
+
+/** @brief Add [off, off + sz) of the arena to the run, advising the run first if not adjacent. */
+static void spl_advise_extent(uint64_t off, uint64_t sz, void *ctx) {
+    struct spl_advise_run *run = ctx;
+    uintptr_t lo = (uintptr_t)(VALUES + off) & ~(run->pg - 1);
+    uintptr_t hi = ((uintptr_t)(VALUES + off + sz) + run->pg - 1) & ~(run->pg - 1);
+    if (run->hi > run->lo && lo <= run->hi && hi >= run->lo) {
+        if (lo < run->lo) run->lo = lo;
+        if (hi > run->hi) run->hi = hi;
+        return;
+    }
+    spl_advise_flush(run);
+    run->lo = lo;
+    run->hi = hi;
+}
+
+/**
+ * @brief posix_madvise() the pages holding the values of the slots in a
+ * scope, a run of adjacent pages at a time.
+ * @return 0 or the first posix_madvise() error.
+ */
+static int spl_madvise_scope(const splinter_shard_scope_t *sc, int advice) {
+    long pgl = spl_page_size();
+    struct spl_advise_run run = { pgl > 0 ? (uintptr_t)pgl : 4096, 0, 0, advice, 0 };
+
+    const size_t words = ((size_t)H->slots + 63) / 64;
+    size_t w_lo = 0, w_hi = words;
+    if (!sc->labels) {
+        // A bare range need not look past its own words.
+        w_lo = sc->slot_lo / 64;
+        if (((size_t)sc->slot_hi + 63) / 64 < w_hi) w_hi = ((size_t)sc->slot_hi + 63) / 64;
+    }
+    for (size_t w = w_lo; w < w_hi; w++) {
+        uint64_t bits = atomic_load_explicit(&OCC[w], memory_order_acquire);
+        while (bits) {
+            size_t i = w * 64 + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i >= H->slots || !spl_scope_has(sc, i)) continue;
+            spl_slot_extents(&S[i], spl_advise_extent, &run);
+        }
+    }
+    spl_advise_flush(&run);
+    return run.rc;
+}
+
+static int spl_do_madvise(uint32_t shard_id, void *addr, size_t len,
+                          int advice, uint64_t timeout_ticks) {
     /* Bound the re-election interval so a sovereign's expiry is noticed
      * promptly even if no eventfd wake fires. ~5 ms. */
     static const uint64_t EVENT_WAIT_CAP_MS = 5;
@@ -1336,31 +4267,22 @@ int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
     if (shard_id == 0) { errno = EINVAL; return -2; }
 
     /* The caller must hold a bid to participate (it need not be sovereign). */
-    int present = 0;
-    for (size_t b = 0; b < SPLINTER_MAX_SHARDS; b++) {
-        if (atomic_load_explicit(&H->shard_bids[b].shard_id, memory_order_acquire) == shard_id) {
-            present = 1;
-            break;
-        }
-    }
-    if (!present) { errno = EINVAL; return -2; }
+    splinter_shard_scope_t scope;
+    int sovereign = spl_shard_sovereign(shard_id, &scope);
+    if (sovereign < 0) { errno = EINVAL; return -2; }
 
+    int by_scope = (addr == NULL && !spl_scope_whole(&scope));
     if (addr == NULL) {
         addr = VALUES;
-        len  = (size_t)H->slots * (size_t)H->max_val_sz;
+        len  = (size_t)H->val_sz;
     }
 
-    int has_deadline = (timeout_ticks != UINT64_MAX);
-    uint64_t deadline = splinter_now() + timeout_ticks;  /* unused when !has_deadline */
-
-    int bus_fd = splinter_event_bus_open();  /* -1 if not armed; poll-sleep fallback */
-
     /* posix_madvise()/madvise() require a page-aligned start address. Round the
      * start down to the enclosing page and extend the length to still cover the
      * requested range, so callers (and the NULL == whole-arena case) need not
      * worry about VALUES landing mid-page. */
     {
-        long pg = sysconf(_SC_PAGESIZE);
+        long pg = spl_page_size();
         if (pg > 0) {
             uintptr_t a = (uintptr_t)addr;
             uintptr_t aligned = a & ~((uintptr_t)pg - 1);
@@ -1369,23 +4291,30 @@ int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
         }
     }
 
+    int has_deadline = (timeout_ticks != UINT64_MAX && timeout_ticks != 0);
+    uint64_t deadline = has_deadline ? splinter_now() + timeout_ticks : 0;
+    int bus_fd = -2;   /* fetched on the first wait; -1 = not armed, poll-sleep */
+    int deferred = 0;
+
     for (;;) {
-        if (splinter_shard_election(NULL) == shard_id) {
-            int rc = posix_madvise(addr, len, advice);
-            if (bus_fd >= 0) splinter_event_bus_close(bus_fd);
+        if (sovereign == 1) {
+            int rc = by_scope ? spl_madvise_scope(&scope, advice)
+                              : posix_madvise(addr, len, advice);
             if (rc == 0) return 0;
             errno = rc;   /* posix_madvise returns the error number directly */
             return -1;
         }
+        if (!deferred) {
+            deferred = 1;
+            SPL_STAT_ADD(madvise_defers);
+        }
 
         if (timeout_ticks == 0) {            /* non-blocking defer */
-            if (bus_fd >= 0) splinter_event_bus_close(bus_fd);
             errno = EAGAIN;
             return -1;
         }
 
         if (has_deadline && splinter_now() >= deadline) {
-            if (bus_fd >= 0) splinter_event_bus_close(bus_fd);
             errno = ETIMEDOUT;
             return -1;
         }
@@ -1393,11 +4322,359 @@ int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
         /* Block for a short capped interval so we re-elect on sovereign-window
          * expiry even without an explicit wake. The eventfd path still wakes
          * immediately on any bus write; the cap is just a safety net. */
+        if (bus_fd == -2) bus_fd = spl_madv_bus();
         if (bus_fd >= 0) {
             splinter_event_bus_wait(bus_fd, EVENT_WAIT_CAP_MS);   /* ignore result; re-elect */
         } else {
             struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)EVENT_WAIT_CAP_MS * NS_PER_MS };
             nanosleep(&ts, NULL);
         }
+        SPL_PROBE_RETRY();
+        sovereign = spl_shard_sovereign(shard_id, NULL);
+    }
+}
+
+int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
+                     int advice, uint64_t timeout_ticks) {
+    SPL_PROBE_ENTRY(madvise__entry, shard_id, advice, len, timeout_ticks);
+    uint64_t t0 = spl_lat_begin();
+    int rc = spl_do_madvise(shard_id, addr, len, advice, timeout_ticks);
+    spl_lat_end(SPL_LAT_MADVISE, t0);
+    SPL_PROBE(madvise__return, rc, shard_id, advice, t_probe.retries);
+    return rc;
+}
+
+/*
+ * Hot/cold tiering (splinter_tier_pass)
+ * -------------------------------------
+ * A pass sorts the arena's pages into three bitmaps: pages holding a value
+ * still in use (keep), a value that has just gone cold (cold) and a value
+ * touched again after being advised cold (rise). Cold pages are only advised
+ * where no kept value shares them.
+ */
+#ifndef MADV_COLD
+#define MADV_COLD 20
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+
+#define SPL_TIER_COLD_PASSES 4
+
+struct spl_tier_pages {
+    uint64_t *map;
+    uintptr_t base, pg;
+};
+
+static void spl_tier_mark(uint64_t off, uint64_t sz, void *ctx) {
+    struct spl_tier_pages *tp = ctx;
+    size_t p0 = ((uintptr_t)(VALUES + off) - tp->base) / tp->pg;
+    size_t p1 = ((uintptr_t)(VALUES + off + sz - 1) - tp->base) / tp->pg;
+    for (size_t p = p0; p <= p1; p++) tp->map[p / 64] |= 1ull << (p % 64);
+}
+
+/** @brief Page test for spl_slot_extents(): clears tp->all unless every page is in map. */
+struct spl_tier_test {
+    struct spl_tier_pages pages;
+    int all;
+};
+
+static void spl_tier_covered(uint64_t off, uint64_t sz, void *ctx) {
+    struct spl_tier_test *tt = ctx;
+    size_t p0 = ((uintptr_t)(VALUES + off) - tt->pages.base) / tt->pages.pg;
+    size_t p1 = ((uintptr_t)(VALUES + off + sz - 1) - tt->pages.base) / tt->pages.pg;
+    for (size_t p = p0; p <= p1; p++)
+        if (!(tt->pages.map[p / 64] >> (p % 64) & 1)) tt->all = 0;
+}
+
+/**
+ * @brief Advise each run of pages set in map (and clear in keep, if given)
+ * through splinter_madvise(). Runs that land are set in done, if given.
+ * @return 0 if every run landed, 1 if the election deferred one, -1 on error.
+ */
+static int spl_tier_advise(uint32_t shard_id, const uint64_t *map, const uint64_t *keep,
+                           uint64_t *done, size_t npages, uintptr_t base, uintptr_t pg,
+                           int advice, uint64_t timeout, uint64_t *bytes) {
+    size_t p = 0;
+    while (p < npages) {
+        uint64_t w = map[p / 64] & ~(keep ? keep[p / 64] : 0);
+        if (!(w >> (p % 64))) { p = (p / 64 + 1) * 64; continue; }
+        p += (size_t)__builtin_ctzll(w >> (p % 64));
+        size_t q = p;
+        while (q < npages && ((map[q / 64] & ~(keep ? keep[q / 64] : 0)) >> (q % 64) & 1)) q++;
+
+        void *addr = (void *)(base + p * pg);
+        size_t len = (q - p) * pg;
+        if (splinter_madvise(shard_id, addr, len, advice, timeout) != 0) {
+            if (errno == EAGAIN || errno == ETIMEDOUT) return 1;
+            // Kernels before 5.14 lack POPULATE_READ: fall back to WILLNEED.
+            if (errno != EINVAL || advice != MADV_POPULATE_READ) return -1;
+            advice = MADV_WILLNEED;
+            continue;
+        }
+        *bytes += len;
+        for (; done && p < q; p++) done[p / 64] |= 1ull << (p % 64);
+        p = q;
+    }
+    return 0;
+}
+
+int splinter_tier_pass(uint32_t shard_id, const splinter_tier_policy_t *pol,
+                       splinter_tier_report_t *out) {
+    splinter_tier_report_t rep = { 0 };
+    if (!H || shard_id == 0) return -2;
+    spl_follow_resize();
+
+    uint8_t cold_passes = (pol && pol->cold_passes) ? pol->cold_passes : SPL_TIER_COLD_PASSES;
+    if (cold_passes > SPL_HEAT_IDLE) cold_passes = SPL_HEAT_IDLE;
+    uint8_t prio = pol ? pol->priority : 0;
+    uint64_t timeout = pol ? pol->timeout_ticks : 0;
+    int cold_advice = (pol && pol->pageout) ? MADV_PAGEOUT : MADV_COLD;
+
+    long pgl = spl_page_size();
+    uintptr_t pg = pgl > 0 ? (uintptr_t)pgl : 4096;
+    uintptr_t base = (uintptr_t)VALUES & ~(pg - 1);
+    size_t npages = ((uintptr_t)VALUES + H->val_sz - base + pg - 1) / pg;
+    size_t mwords = (npages + 63) / 64;
+    /*
+     * The pass claims shard_id itself and releases it when done, so an id
+     * that already has a bid (perhaps the caller's own) is refused rather
+     * than overwritten and then dropped.
+     */
+    if (spl_shard_find(shard_id)) {
+        errno = EBUSY;
+        return -1;
+    }
+    uint64_t *maps = calloc(4 * mwords + 1, sizeof(uint64_t));
+    if (!maps) return -1;
+    struct spl_tier_pages keep = { maps, base, pg };
+    struct spl_tier_pages cold = { maps + mwords, base, pg };
+    struct spl_tier_pages rise = { maps + 2 * mwords, base, pg };
+    struct spl_tier_test advised = { { maps + 3 * mwords, base, pg }, 1 };
+    int have_cold = 0, have_rise = 0;
+    // The first page also holds the tail of the occupancy bitmap.
+    if (base < (uintptr_t)VALUES) keep.map[0] |= 1;
+
+    const size_t words = ((size_t)H->slots + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        uint64_t bits = atomic_load_explicit(&OCC[w], memory_order_acquire);
+        while (bits) {
+            size_t i = w * 64 + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i >= H->slots) break;
+            rep.scanned++;
+
+            uint8_t h = atomic_load_explicit(&AUX[i].heat, memory_order_relaxed), nh;
+            if (h & SPL_HEAT_TOUCHED) {
+                nh = 0;
+            } else {
+                uint8_t idle = h & SPL_HEAT_IDLE;
+                nh = (uint8_t)((h & SPL_HEAT_COLD) | (idle < SPL_HEAT_IDLE ? idle + 1 : idle));
+            }
+            // Lost to a concurrent touch: count it as the hot slot it now is.
+            if (!atomic_compare_exchange_strong_explicit(&AUX[i].heat, &h, nh,
+                                                         memory_order_relaxed, memory_order_relaxed))
+                nh = 0, h = SPL_HEAT_TOUCHED;
+
+            if (h & SPL_HEAT_TOUCHED) {
+                rep.hot++;
+                spl_slot_extents(&S[i], spl_tier_mark, &keep);
+                if (h & SPL_HEAT_COLD) {
+                    rep.rising++;
+                    spl_slot_extents(&S[i], spl_tier_mark, &rise);
+                    have_rise = 1;
+                }
+            } else if ((nh & SPL_HEAT_IDLE) >= cold_passes) {
+                rep.cold++;
+                if (!(nh & SPL_HEAT_COLD)) {
+                    spl_slot_extents(&S[i], spl_tier_mark, &cold);
+                    have_cold = 1;
+                }
+            } else {
+                spl_slot_extents(&S[i], spl_tier_mark, &keep);
+            }
+        }
+    }
+
+    uint64_t window = splinter_ns_to_ticks(1000 * NS_PER_MS);
+    window = (timeout > UINT64_MAX - window) ? UINT64_MAX : window + timeout;
+    int claimed = 0, rc = 0, err = 0;
+
+    if (have_cold) {
+        if (spl_shard_claim(shard_id, (uint32_t)getpid(), SPL_INTENT_DONTNEED, prio, window,
+                            splinter_now(), NULL, 1) != 0) {
+            free(maps);
+            return -1;
+        }
+        claimed = 1;
+        rc = spl_tier_advise(shard_id, cold.map, keep.map, advised.pages.map, npages, base, pg,
+                             cold_advice, timeout, &rep.cold_bytes);
+        if (rc == 1) rep.deferred++;
+        if (rc < 0) err = errno;
+        /*
+         * Mark the values whose pages were all advised so they are advised
+         * once. One that shares a page with a kept value, or whose run was
+         * deferred, stays unmarked and is tried again next pass.
+         */
+        for (size_t w = 0; rc >= 0 && w < words; w++) {
+            uint64_t bits = atomic_load_explicit(&OCC[w], memory_order_acquire);
+            while (bits) {
+                size_t i = w * 64 + (size_t)__builtin_ctzll(bits);
+                bits &= bits - 1;
+                if (i >= H->slots) break;
+                uint8_t h = atomic_load_explicit(&AUX[i].heat, memory_order_relaxed);
+                if ((h & (SPL_HEAT_TOUCHED | SPL_HEAT_COLD)) || (h & SPL_HEAT_IDLE) < cold_passes)
+                    continue;
+                advised.all = 1;
+                spl_slot_extents(&S[i], spl_tier_covered, &advised);
+                if (advised.all)
+                    atomic_compare_exchange_strong_explicit(&AUX[i].heat, &h, h | SPL_HEAT_COLD,
+                                                            memory_order_relaxed, memory_order_relaxed);
+            }
+        }
+    }
+
+    if (have_rise && rc >= 0) {
+        rc = claimed ? splinter_shard_rebid(shard_id, SPL_INTENT_WILLNEED, prio, window)
+                     : spl_shard_claim(shard_id, (uint32_t)getpid(), SPL_INTENT_WILLNEED, prio,
+                                       window, splinter_now(), NULL, 1);
+        if (rc == 0) {
+            claimed = 1;
+            rc = spl_tier_advise(shard_id, rise.map, NULL, NULL, npages, base, pg,
+                                 MADV_POPULATE_READ, timeout, &rep.warm_bytes);
+            if (rc == 1) rep.deferred++;
+        }
+        if (rc < 0) err = errno;
+    }
+
+    if (claimed) splinter_shard_release(shard_id);
+    free(maps);
+    if (out) *out = rep;
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Residency and footprint                                                   */
+/* ------------------------------------------------------------------------- */
+
+/** @brief Tally the pages of [lo, hi) of the mapping, and how many vec marks resident. */
+static void spl_mem_region(splinter_mem_region_t *r, const unsigned char *vec, uintptr_t pg,
+                           uintptr_t lo, uintptr_t hi) {
+    r->bytes = hi - lo;
+    if (hi <= lo) return;
+    for (uintptr_t p = lo / pg; p < (hi + pg - 1) / pg; p++) {
+        r->pages++;
+        if (vec[p] & 1) r->resident++;
+    }
+}
+
+/** @brief Extent and resident bytes of one value, gathered by spl_slot_extents(). */
+struct spl_mem_tally {
+    const unsigned char *vec;
+    uintptr_t pg, arena;  /* arena = offset of VALUES in the mapping */
+    uint64_t ext, resident;
+};
+
+static void spl_mem_extent(uint64_t off, uint64_t sz, void *ctx) {
+    struct spl_mem_tally *t = ctx;
+    uintptr_t lo = t->arena + off, hi = lo + sz;
+    t->ext += sz;
+    while (lo < hi) {
+        uintptr_t end = (lo / t->pg + 1) * t->pg;
+        if (end > hi) end = hi;
+        if (t->vec[lo / t->pg] & 1) t->resident += end - lo;
+        lo = end;
+    }
+}
+
+static void spl_mem_add(splinter_mem_values_t *v, uint64_t len, const struct spl_mem_tally *t) {
+    v->keys++;
+    v->val_bytes += len;
+    v->ext_bytes += t->ext;
+    v->resident  += t->resident;
+}
+
+int splinter_mem_report(splinter_mem_report_t *out) {
+    if (!H || !out) return -2;
+    spl_follow_resize();
+    memset(out, 0, sizeof(*out));
+
+    long pgl = spl_page_size();
+    uintptr_t pg = pgl > 0 ? (uintptr_t)pgl : 4096;
+    size_t npages = (g_total_sz + pg - 1) / pg;
+    unsigned char *vec = malloc(npages ? npages : 1);
+    if (!vec) return -1;
+    if (mincore(g_base, g_total_sz, vec) != 0) {
+        int err = errno;
+        free(vec);
+        errno = err;
+        return -1;
+    }
+
+    const uintptr_t b = (uintptr_t)g_base;
+    out->page_size = pg;
+    out->slots = (uint32_t)H->slots;
+    out->max_val_sz = H->max_val_sz;
+    spl_mem_region(&out->region[SPL_REGION_HEADER], vec, pg, 0, (uintptr_t)S - b);
+    spl_mem_region(&out->region[SPL_REGION_SLOTS], vec, pg, (uintptr_t)S - b, (uintptr_t)IX - b);
+    spl_mem_region(&out->region[SPL_REGION_INDEX], vec, pg, (uintptr_t)IX - b, (uintptr_t)AUX - b);
+    spl_mem_region(&out->region[SPL_REGION_AUX], vec, pg, (uintptr_t)AUX - b, (uintptr_t)OCC - b);
+    spl_mem_region(&out->region[SPL_REGION_OCC], vec, pg, (uintptr_t)OCC - b, (uintptr_t)VALUES - b);
+    spl_mem_region(&out->region[SPL_REGION_VALUES], vec, pg, (uintptr_t)VALUES - b,
+                   (uintptr_t)VALUES - b + H->val_sz);
+#ifdef SPLINTER_EMBEDDINGS
+    // Embeddings are interleaved with the slots; count each page they touch once.
+    splinter_mem_region_t *er = &out->region[SPL_REGION_EMBEDDINGS];
+    uintptr_t last = UINTPTR_MAX;
+    for (size_t i = 0; i < H->slots; i++) {
+        uintptr_t lo = (uintptr_t)S[i].embedding - b, hi = lo + sizeof(S[i].embedding);
+        er->bytes += hi - lo;
+        for (uintptr_t p = lo / pg; p < (hi + pg - 1) / pg; p++) {
+            if (p == last) continue;
+            last = p;
+            er->pages++;
+            if (vec[p] & 1) er->resident++;
+        }
+    }
+#endif
+
+    uint32_t per = (uint32_t)((H->slots + SPLINTER_MEM_RANGES - 1) / SPLINTER_MEM_RANGES);
+    out->range_slots = per ? per : 1;
+    const size_t words = ((size_t)H->slots + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        uint64_t bits = atomic_load_explicit(&OCC[w], memory_order_acquire);
+        while (bits) {
+            size_t i = w * 64 + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i >= H->slots) break;
+
+            struct spl_mem_tally t = { vec, pg, (uintptr_t)VALUES - b, 0, 0 };
+            spl_slot_extents(&S[i], spl_mem_extent, &t);
+            uint64_t len = atomic_load_explicit(&S[i].val_len, memory_order_relaxed);
+            spl_mem_add(&out->all, len, &t);
+            spl_mem_add(&out->range[i / out->range_slots], len, &t);
+            uint64_t bloom = atomic_load_explicit(&S[i].bloom, memory_order_relaxed);
+            while (bloom) {
+                spl_mem_add(&out->label[__builtin_ctzll(bloom)], len, &t);
+                bloom &= bloom - 1;
+            }
+#ifdef SPLINTER_EMBEDDINGS
+            for (size_t d = 0; d < SPLINTER_EMBED_DIM; d++) {
+                if (S[i].embedding[d] != 0.0f) {
+                    out->embedded++;
+                    break;
+                }
+            }
+#endif
+        }
     }
+    free(vec);
+    return 0;
 }
@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include <stdatomic.h>
 #include <stdalign.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,7 +30,7 @@ extern "C" {
 #define SPLINTER_MAGIC 0x534C4E54
 
 /** @brief Version of the splinter data format (not the library version). */
-#define SPLINTER_VER   4   /* was 3: header now carries the shard bid table */
+#define SPLINTER_VER   16  /* was 15: scoped shard bids */
 /** @brief Maximum length of a key string, including null terminator. */
 #define SPLINTER_KEY_MAX        64
 /** @brief Nanoseconds per millisecond for time calculations. */
@@ -39,6 +40,15 @@ extern "C" {
 #define SPLINTER_EMBED_DIM    768
 #endif
 
+/** @brief Upper bound on value size classes: 64 bytes doubling through 4 GiB.
+ *  A store uses only the classes up to its own max_val_sz. */
+#define SPLINTER_SIZE_CLASSES 27
+
+/** @brief val_cls bit marking a chained value: the extent at val_off is then a
+ *  descriptor (top-class segment offsets as uint32_t counts of 64-byte
+ *  units), not the bytes. */
+#define SPLINTER_VAL_CHAINED  0x80u
+
 /** @brief The maximum number of watch signal groups for a slot */
 #define SPLINTER_MAX_GROUPS 64
 
@@ -66,11 +76,12 @@ typedef enum {
 /** @brief Number of 64-bit words in the event bus dirty mask */
 #define SPLINTER_EVENT_BUS_MASK_WORDS (SPLINTER_MAX_SLOTS / 64)
 
-/** @brief Reserved store system flags */
+/** @brief Reserved store system flags (KEY_INDEX: maintain the ordered key index,
+ *  EVICT: a full store reclaims a CLOCK victim instead of refusing the set) */
 #define SPL_SYS_AUTO_SCRUB     (1u << 0)
 #define SPL_SYS_HYBRID_SCRUB   (1u << 1)
-#define SPL_SYS_RESERVED_2     (1u << 2)
-#define SPL_SYS_RESERVED_3     (1u << 3)
+#define SPL_SYS_KEY_INDEX      (1u << 2)
+#define SPL_SYS_EVICT          (1u << 3)
 
 /** @brief User store flags for aliasing */
 #define SPL_SUSR1              (1u << 4)
@@ -147,12 +158,40 @@ struct splinter_event_bus {
     atomic_int_least32_t  owner_pid;
 };
 
+/** @brief Tower height of the ordered key index (skiplist, p = 1/4). 16 levels
+ *  cover 4^16 keys, far past any slot count a 32-bit header can describe. */
+#define SPLINTER_INDEX_LEVELS 16
+
+/**
+ * @brief One node of the ordered key index. There is exactly one node per
+ * slot (node i indexes slot i), so the index needs no allocator: a slot's
+ * key is threaded into the skiplist in place. Links hold (slot index + 1);
+ * 0 terminates a level. One node is exactly one cache line.
+ */
+struct splinter_index_node {
+    alignas(64) atomic_uint_least32_t next[SPLINTER_INDEX_LEVELS];
+};
+
+/**
+ * @brief Per-slot cache-residence state, kept in a side array (one per slot)
+ * so the 128-byte slot line is not disturbed. Only touched when a TTL is set
+ * or eviction is enabled.
+ */
+struct splinter_slot_aux {
+    atomic_uint_least32_t expires;  /**< seconds after H->ttl_base; 0 = never expires. */
+    atomic_uint_least8_t  ref;      /**< CLOCK reference bit (second chance). */
+    atomic_uint_least8_t  heat;     /**< tiering: touched bit, advised-cold bit, idle passes. */
+    atomic_uint_least8_t  tomb;     /**< 1 once the slot has been emptied; a set probes past it. */
+    atomic_uint_least8_t  _rsvd;    /**< explicit padding; keep layout stable. */
+    atomic_uint_least64_t scrubbed; /**< epoch purge last left the slot clean at; 0 = never. */
+};
+
 /**
  * @brief One cooperative-memory-scheduling bid. 32 of these live in the
- * header. Packed to ~32 bytes so all 32 fit in ~1 KB (intentionally NOT
- * individually cache-line aligned: claims/releases are rare and elections
- * are read-only, so false sharing on this table is a non-issue, and the
- * thesis budgets ~1 KB, not 2 KB).
+ * header. Packed to 48 bytes (32 plus the scope) so all 32 fit in 1.5 KB
+ * (intentionally NOT individually cache-line aligned: claims/releases are
+ * rare and elections are read-only, so false sharing on this table is a
+ * non-issue).
  */
 struct splinter_shard_bid {
     atomic_uint_least32_t shard_id;     /**< 0 = empty slot. Claimed via CAS. */
@@ -162,6 +201,64 @@ struct splinter_shard_bid {
     atomic_uint_least8_t  _pad[2];      /**< explicit padding; keep layout stable. */
     atomic_uint_least64_t duration_tsc; /**< declared window in splinter_now() ticks. */
     atomic_uint_least64_t claimed_at;   /**< splinter_now() at claim / last re-bid. */
+    atomic_uint_least32_t slot_lo;      /**< scope: slots [slot_lo, slot_hi); none if empty. */
+    atomic_uint_least32_t slot_hi;
+    atomic_uint_least64_t labels;       /**< scope: bloom label mask; 0 = none. */
+};
+
+/** @brief Operations counted by the stats stripes (see splinter_get_stats). */
+enum splinter_stat_op {
+    SPL_OP_GET    = 0,
+    SPL_OP_SET    = 1,
+    SPL_OP_UNSET  = 2,
+    SPL_OP_APPEND = 3,
+    SPL_OP_COUNT  = 4
+};
+
+/** @brief Counter stripes in the header; writers pick one by CPU. */
+#define SPLINTER_STATS_STRIPES 16
+/** @brief Probe-length buckets: 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+ */
+#define SPLINTER_PROBE_BUCKETS 8
+
+/**
+ * @brief One stripe of operation counters. Each stripe owns whole cache
+ * lines, so threads on different CPUs never write the same line.
+ */
+struct splinter_stats_stripe {
+    alignas(64) atomic_uint_least64_t ops[SPL_OP_COUNT];
+    atomic_uint_least64_t misses;         /**< get/unset/append of an absent key. */
+    atomic_uint_least64_t eagain;         /**< calls that returned EAGAIN. */
+    atomic_uint_least64_t retries;        /**< set probes past a slot held mid-write. */
+    atomic_uint_least64_t set_full;       /**< sets refused with ENOSPC. */
+    atomic_uint_least64_t eventfd_writes; /**< event bus wake-ups written. */
+    atomic_uint_least64_t probe[SPLINTER_PROBE_BUCKETS];
+    /* Added after the probe buckets, in what was padding, so older stores
+     * read them as zero. */
+    atomic_uint_least64_t eventfd_reads;     /**< wake-ups consumed by bus waiters. */
+    atomic_uint_least64_t sovereign_changes; /**< elections that crowned a new shard. */
+    atomic_uint_least64_t madvise_defers;    /**< madvise calls that were not sovereign. */
+};
+
+/** @brief Calls timed by the latency histograms (see splinter_get_latency). */
+enum splinter_lat_op {
+    SPL_LAT_GET           = 0,
+    SPL_LAT_SET           = 1,
+    SPL_LAT_APPEND        = 2,
+    SPL_LAT_SET_EMBEDDING = 3,
+    SPL_LAT_INTEGER_OP    = 4,
+    SPL_LAT_MADVISE       = 5,
+    SPL_LAT_OPS           = 6
+};
+
+/** @brief Log-linear buckets: exact below 32 ticks, then 16 per power of two
+ *  up to 2^35 ticks (about 6% wide); slower calls share the last bucket. */
+#define SPLINTER_LAT_SUB_BITS 4
+#define SPLINTER_LAT_BUCKETS  512
+
+/** @brief Latency histogram for one call, in splinter_now() ticks. */
+struct splinter_latency_hist {
+    alignas(64) atomic_uint_least64_t max;
+    atomic_uint_least64_t buckets[SPLINTER_LAT_BUCKETS];
 };
 
 /**
@@ -188,10 +285,10 @@ struct splinter_header {
     atomic_uint_least8_t core_flags;
     /** @brief User-defined feature flags */
     atomic_uint_least8_t user_flags;
-    /** @brief Track the next-available value region */
-    atomic_uint_least32_t val_brk;
-    /** @brief Running total size of the arena */
-    uint32_t val_sz;
+    /** @brief Bump pointer: bytes of the value arena ever carved into extents */
+    atomic_uint_least64_t val_brk;
+    /** @brief Size of the value arena in bytes */
+    uint64_t val_sz;
     /** @brief Memory alignment (e.g  64) */
     uint32_t alignment;
 
@@ -213,6 +310,86 @@ struct splinter_header {
     // Placed last so prior field offsets are undisturbed. The whole array is
     // 64-byte aligned (one fresh cache line) but records inside are packed.
     alignas(64) struct splinter_shard_bid shard_bids[SPLINTER_MAX_SHARDS];
+
+    // Ordered key index (SPL_SYS_KEY_INDEX). index_seq is an index-wide
+    // seqlock: writers splicing a node hold it odd, scanners validate against
+    // it. index_stale is raised when a writer could not take the lock in
+    // bounded time; scans then refuse (ESTALE) until splinter_index_rebuild().
+    // index_owner is the pid holding the lock (0 = none), so a rebuild only
+    // breaks a lock whose holder has died.
+    alignas(64) atomic_uint_least64_t index_seq;
+    atomic_uint_least32_t index_count;
+    atomic_uint_least8_t  index_stale;
+    atomic_int_least32_t  index_owner;
+    alignas(64) struct splinter_index_node index_head;
+
+    // Cache residence: TTL stamps in the aux region count seconds from
+    // ttl_base (CLOCK_REALTIME at create). clock_hand is the shared CLOCK
+    // sweep position; ttl_live counts slots carrying a TTL, so a full probe
+    // only sweeps when something could be freed; expired/evicted count
+    // reclaimed slots for the stats.
+    alignas(64) uint64_t ttl_base;
+    atomic_uint_least32_t clock_hand;
+    atomic_uint_least32_t ttl_live;
+    atomic_uint_least64_t expired;
+    atomic_uint_least64_t evicted;
+
+    // Value arena allocator. Class c hands out extents of 64 << c bytes,
+    // except the top class (val_classes - 1), which is exactly max_val_sz
+    // rounded up to 64 (val_top_sz). Extents are carved from val_brk and,
+    // once freed, pushed on their class's lock-free stack and never split or
+    // merged. A stack head packs (extent offset / 64 + 1) in the low 32 bits
+    // (0 = empty) and an ABA tag, bumped on every push and pop, in the high 32.
+    alignas(64) atomic_uint_least64_t val_free[SPLINTER_SIZE_CLASSES];
+    uint32_t val_classes;
+    uint32_t val_top_sz;
+    atomic_uint_least64_t val_inuse;
+    // Nonzero lets set/append chain values past max_val_sz (see splinter_set_chaining).
+    atomic_uint_least8_t val_chain;
+    // Nonzero has accesses mark the aux heat byte (see splinter_set_tiering).
+    atomic_uint_least8_t tier_on;
+
+    // Online resize (splinter_resize). resizing is held by the one process
+    // migrating this store. Slots below resize_front have been copied: they
+    // still serve reads, but writes to them fail (EAGAIN) until the move.
+    // moved is raised once the replacement has been renamed into place:
+    // attached processes remap on their next call. resize_owner is the pid
+    // doing the copy and resize_held the slot it holds odd (index + 1, 0 =
+    // none), so a resize whose copier died can be settled.
+    alignas(64) atomic_uint_least8_t resizing;
+    atomic_uint_least8_t moved;
+    atomic_uint_least32_t resize_front;
+    atomic_int_least32_t  resize_owner;
+    atomic_uint_least32_t resize_held;
+
+    // Operation counters (splinter_set_stats). Summed across stripes on read.
+    // sovereign_last (in the padding after stats_on) is the last election
+    // winner seen while counting, for sovereign_changes.
+    alignas(64) atomic_uint_least8_t stats_on;
+    atomic_uint_least32_t sovereign_last;
+    struct splinter_stats_stripe stats[SPLINTER_STATS_STRIPES];
+
+    // Latency histograms (splinter_set_latency_sampling): every lat_every-th
+    // call per thread is timed; 0 = off.
+    alignas(64) atomic_uint_least32_t lat_every;
+    struct splinter_latency_hist latency[SPL_LAT_OPS];
+
+    // splinter_now() ticks per second on this host; 0 until first measured
+    // (see splinter_tick_hz).
+    alignas(64) atomic_uint_least64_t tick_hz;
+
+    // Shard election cache, in the padding after tick_hz. shard_gen is
+    // bumped by every claim, re-bid and release. The last election's winner
+    // (shard_id << 8 | intent, bit 63 set if any bid was scoped) holds while
+    // shard_gen still equals elect_gen and fewer than elect_span ticks have
+    // passed since elect_at, the next tick at which some bid starts or
+    // expires. elect_seq is odd while the cache is being rewritten.
+    atomic_uint_least64_t shard_gen;
+    atomic_uint_least64_t elect_seq;
+    atomic_uint_least64_t elect_gen;
+    atomic_uint_least64_t elect_at;
+    atomic_uint_least64_t elect_span;
+    atomic_uint_least64_t elect_win;
 };
 
 
@@ -231,14 +408,18 @@ struct splinter_slot {
     alignas(64) atomic_uint_least64_t hash;
     /** @brief Per-slot epoch, incremented on write to this slot. Used for polling. */
     atomic_uint_least64_t epoch;
-    /** @brief Offset into the VALUES region where the value data is stored. */
-    uint32_t val_off;
+    /** @brief Offset into the VALUES region of this slot's extent. Only
+     *  meaningful while val_cls != 0; it moves when a value changes class. */
+    uint64_t val_off;
     /** @brief The actual length of the stored value data (atomic). */
     atomic_uint_least32_t val_len;
     /** @brief The type-naming flags for slot typing */
     atomic_uint_least8_t type_flag;
     /** @brief The user-defined flags for slot features */
     atomic_uint_least8_t user_flag;
+    /** @brief Size class of the extent at val_off, plus one; 0 = no extent.
+     *  SPLINTER_VAL_CHAINED is or'd in when that extent is a chain descriptor. */
+    atomic_uint_least8_t val_cls;
     /** @brief Watcher signal group for multi-watching */
     atomic_uint_least64_t watcher_mask;
     /** @brief The time a slot was created (optional; must be set by the client) */
@@ -277,6 +458,20 @@ typedef struct splinter_header_snapshot {
     /* Diagnostics: counts of parse failures reported by clients / harnesses */
     uint64_t parse_failures;
     uint64_t last_failure_epoch;
+
+    /** @brief Keys reclaimed because their TTL lapsed */
+    uint64_t expired;
+    /** @brief Keys reclaimed by CLOCK eviction to make room */
+    uint64_t evicted;
+
+    /** @brief Size of the value arena in bytes */
+    uint64_t arena_sz;
+    /** @brief Arena bytes carved into extents so far (high-water mark) */
+    uint64_t arena_brk;
+    /** @brief Arena bytes held by live values' extents */
+    uint64_t arena_inuse;
+    /** @brief Longest value splinter_set() accepts when chaining is on */
+    uint64_t chain_max;
 } splinter_header_snapshot_t;
 
 /**
@@ -297,7 +492,7 @@ typedef struct splinter_slot_snapshot {
     /** @brief Per-slot epoch, incremented on write to this slot. Used for polling. */
     uint64_t epoch;
     /** @brief Offset into the VALUES region where the value data is stored. */
-    uint32_t val_off;
+    uint64_t val_off;
     /** @brief The actual length of the stored value data (atomic). */
     uint32_t val_len;
     /** @brief The slot type flags */
@@ -329,9 +524,24 @@ struct splinter_shard_bid_snapshot {
     uint64_t duration_tsc;
     uint64_t claimed_at;
     int      expired;   /**< computed at snapshot time vs splinter_now() */
-    int      sovereign; /**< 1 if this record won the election at snapshot time */
+    int      sovereign; /**< 1 if this record won the election over its scope */
+    uint32_t slot_lo;   /**< scope slot range [slot_lo, slot_hi); empty if none */
+    uint32_t slot_hi;
+    uint64_t labels;    /**< scope label mask; 0 if none */
 };
 
+/**
+ * @struct splinter_shard_scope
+ * @brief The part of the store a bid advises: the slots in [slot_lo, slot_hi)
+ * plus every slot carrying one of the labels. Empty on both counts (all
+ * zero) means the whole store.
+ */
+typedef struct splinter_shard_scope {
+    uint32_t slot_lo;
+    uint32_t slot_hi;
+    uint64_t labels;
+} splinter_shard_scope_t;
+
 /**
  * @brief for atomic integer operations
  */
@@ -406,15 +616,19 @@ typedef enum {
  * NULL store, invalid argument). Do not retry. Fix the call.
  *
  * Other errno values you will meet are NOT contention and must not be retried
- * verbatim: EMSGSIZE (a value or append exceeds max_val_sz — a geometry
- * problem), ENOSPC (the store is full, or the 32-slot shard bid table is full),
- * and ETIMEDOUT (a bounded cooperative-madvise wait expired). Only EAGAIN
- * means "the same call will succeed once the writer leaves."
+ * verbatim: EMSGSIZE (a value or append exceeds max_val_sz, or chain_max
+ * when chaining is on — a geometry problem), ENOSPC (the store is full, or the 32-slot shard bid table is full),
+ * ENOENT (the key's TTL lapsed; it is gone, not busy), ESTALE (the ordered
+ * key index needs a rebuild), and ETIMEDOUT (a bounded cooperative-madvise
+ * wait expired). Only EAGAIN means "the same call will succeed once the
+ * writer leaves."
  *
  * RISK TOPOLOGY — KNOW BEFORE YOU CALL
  * --------------------------------------
  * DESTRUCTIVE (epoch reset/rewind, data or vectors zeroed, watchers pulsed):
  *   splinter_unset()         — frees the slot, zeroes key+value, clears labels
+ *   splinter_set_ttl()       — schedules the same destruction for later
+ *   splinter_expire_sweep()  — reclaims every key whose TTL has lapsed
  *   splinter_retrain_slot()  — scrubs the embedding, drives the epoch *backward*
  *   splinter_purge()         — sweeps stale bytes past val_len across every slot
  *
@@ -423,6 +637,9 @@ typedef enum {
  *   splinter_watch_label_register(), splinter_bump_slot(),
  *   splinter_pulse_keygroup(), splinter_set_as_system(),
  *   splinter_madvise()       — issues a real posix_madvise() if you win the election
+ *   splinter_tier_pass()     — pages out values nobody has touched lately
+ *   splinter_resize()        — replaces the store; writes to a key stall
+ *                              (EAGAIN) from its copy until processes remap
  *
  * MEDIUM (value overwrite, epoch advance, watchers pulsed):
  *   splinter_set(), splinter_append(), splinter_set_embedding(),
@@ -430,7 +647,13 @@ typedef enum {
  *   splinter_set_slot_time(), splinter_client_set_tandem()
  *
  * CONFIG (mutate store or shard policy, not slot data — own them deliberately):
- *   splinter_set_mop(), splinter_event_bus_init(),
+ *   splinter_set_mop(), splinter_set_key_index(), splinter_index_rebuild(),
+ *   splinter_set_eviction()  — once on, any splinter_set() may reclaim a
+ *                              cold, unlabelled key that is not yours,
+ *   splinter_set_chaining()  — lets values outgrow max_val_sz; raw pointers
+ *                              then fail on long values (use the iovec view),
+ *   splinter_set_tiering(),
+ *   splinter_event_bus_init(),
  *   splinter_shard_claim(), splinter_shard_claim_ex(),
  *   splinter_shard_rebid(), splinter_shard_release()
  *
@@ -438,7 +661,11 @@ typedef enum {
  *   splinter_get(), splinter_get_epoch(), splinter_get_embedding(),
  *   splinter_get_raw_ptr(), splinter_list(), splinter_poll(),
  *   splinter_get_signal_count(), splinter_get_header_snapshot(),
+ *   splinter_mem_report(),
  *   splinter_get_slot_snapshot(), splinter_get_mop(),
+ *   splinter_get_key_index(), splinter_scan_prefix(), splinter_scan_range(),
+ *   splinter_get_ttl(), splinter_get_eviction(), splinter_get_tiering(),
+ *   splinter_get_iov(), splinter_get_chaining(),
  *   splinter_shard_election(), splinter_shard_is_sovereign(),
  *   splinter_shard_table_snapshot(),
  *   splinter_event_bus_open(), splinter_event_bus_wait(),
@@ -481,6 +708,12 @@ typedef enum {
  * where (slot->bloom & mask) == mask. This is O(slots), not O(1).
  * Use it for batch operations, not hot-path queries.
  *
+ * Key names are the other routing axis. With the ordered key index enabled
+ * (splinter_set_key_index(1)), splinter_scan_prefix() and splinter_scan_range()
+ * walk keys in byte order in O(log n + matches), which is the right way to list
+ * a namespace ("tenant/a/") on a big store. A scan that returns -1/ESTALE means
+ * the index lost a writer; splinter_index_rebuild() repairs it.
+ *
  * Labels are persistent until explicitly cleared with splinter_unset_label().
  * splinter_unset() clears them as part of slot destruction.
  *
@@ -490,31 +723,60 @@ typedef enum {
  *   Sidecar clears SERVICING, sets READY → consumer reads result
  * Never skip a label transition. Governance observes the bloom directly.
  *
- * GEOMETRY AND MEMORY — WHAT YOU CANNOT CHANGE AT RUNTIME
- * ---------------------------------------------------------
- * Splinter has static geometry. Slot count and max value size are fixed
- * at creation (splinter_create()). You cannot resize a live store.
- * If you fill the store, splinter_set() returns -1. There is no eviction.
- * Plan your keyspace before you write your first key.
- *
- * max_val_sz is a hard ceiling per slot. splinter_append() will return
+ * GEOMETRY AND MEMORY — WHAT CHANGES ONLY BY RESIZE
+ * ----------------------------------------------------
+ * Slot count and max value size are set at creation (splinter_create()) and
+ * change only through splinter_resize(), which copies every live key into a
+ * replacement store and renames it over the old one while the store stays up.
+ * Reads carry on throughout; a write to a key that has already been copied
+ * fails with -1 (EAGAIN) until the switch, so retry it. Only one resize runs
+ * at a time: a second caller gets -1 (EBUSY). Other processes remap on their
+ * next call. If you fill the store, splinter_set() returns -1 (ENOSPC). By
+ * default there is no eviction: plan your keyspace, or resize before you run
+ * out.
+ *
+ * Cache-residence stores can opt in to eviction with splinter_set_eviction(1):
+ * a full store then reclaims a CLOCK (second-chance) victim. Odd-epoch and
+ * labelled slots are never evicted, so a bloom label is also a pin. Keys may
+ * carry a TTL (splinter_set_ttl()); an expired key reads as absent (-1,
+ * ENOENT) and its slot is reclaimed lazily. Expired and evicted totals are in
+ * the header snapshot. If a key you wrote vanished, check those first.
+ *
+ * max_val_sz is a hard ceiling per slot unless chaining is on (then
+ * chain_max is). splinter_append() will return
  * -1 with errno == EMSGSIZE if an append would overflow. Check before
  * appending in a loop. splinter_get_header_snapshot() gives you the
  * geometry without risk.
  *
- * The store is a flat arena of (slots × max_val_sz) bytes plus a header.
+ * The store is a header, the slot array, one 64-byte ordered-index node and
+ * one 8-byte aux record (TTL, CLOCK and tiering bits) per slot, an occupancy
+ * bitmap (one bit per slot, set while it holds a key), then the value arena.
+ * Values do not own fixed lanes: each lives in an extent from a size class
+ * (64 bytes doubling up to max_val_sz), so val_off moves when a value grows
+ * or shrinks across a class boundary. The arena defaults to slots ×
+ * max_val_sz but can be sized smaller with splinter_create_ex(); when it runs
+ * out, splinter_set() fails with ENOSPC (or evicts, if eviction is on).
+ * Freed extents are reused within their class but never split or merged, so a
+ * workload that shifts sizes drastically may need a restart.
+ * With splinter_set_chaining(1), set and append accept values up to chain_max
+ * (header snapshot) by chaining top-class extents behind one slot; the seqlock
+ * still covers the whole value. splinter_get() reassembles it, splinter_get_iov()
+ * hands back the segments in place, and splinter_get_raw_ptr() refuses it.
  * 64-byte alignment is mandatory for slot structures. If you modify slot
  * geometry in a fork, verify alignment with the provided test before use.
  *
  * STALE BYTES BEYOND val_len — THE MOP
  * --------------------------------------
- * A slot's value region is max_val_sz wide but only val_len bytes are live.
+ * A slot's extent is usually wider than its value; only val_len bytes are live.
  * splinter_get() always honors val_len, but splinter_get_raw_ptr() does not —
  * the bytes past out_sz may be leftovers from a previous, longer write to the
  * same slot. The store's "mop" mode governs scrubbing: 0 = off, 1 = hybrid
  * (default; clears the new length plus a 64-byte-aligned slop region so SIMD
- * loads can't see stale data), 2 = full boil (zeroes the whole slot, costlier).
- * Query it with splinter_get_mop(). If you read raw and contamination matters
+ * loads can't see stale data), 2 = full boil (zeroes the whole extent, costlier).
+ * Query it with splinter_get_mop(). Whatever the mode, an extent is zeroed
+ * when it is freed (unset, expiry, eviction, or a value moving to another
+ * class), so old values never linger in free arena space; the mode only
+ * governs the tail of a live extent. If you read raw and contamination matters
  * (LLM memory, forensics, verifiable research) do not trust bytes beyond out_sz,
  * and consider splinter_purge() during a quiescent maintenance window.
  *
@@ -539,12 +801,27 @@ typedef enum {
  * Backfills/sweeps: SEQUENTIAL, low priority, non-blocking, and accept deferral
  * as the correct outcome rather than fighting a live completer.
  *
+ * A bid may be scoped to a slot range and/or a label mask with
+ * splinter_shard_claim_scoped(). A scoped bid only competes with bids whose
+ * scope overlaps its own, so a completer holding WILLNEED on one slot and a
+ * backfill sweeping another range are both sovereign at once. Unscoped bids
+ * overlap everything. splinter_shard_election() still names the single winner
+ * over the whole table; ask splinter_shard_is_sovereign() about your own region.
+ *
+ * Tiering is a maintenance shard built on the same rules. With
+ * splinter_set_tiering(1), every access marks its slot; a periodic
+ * splinter_tier_pass() (the CLI's "tier run") ages the marks, pages out the
+ * values of slots idle for a few passes and prefetches the ones that come
+ * back, all through splinter_madvise() under a low-priority bid of its own,
+ * so a live completer always outranks it. Run one tier pass per store.
+ *
  * WHAT SPLINTER IS NOT DESIGNED FOR
  * -----------------------------------
  * - Multi-machine replication (use a real database for that)
  * - Durable ACID transactions (seqlock is crash-consistent, not ACID)
  * - Dynamic schema evolution at runtime (geometry is fixed)
- * - High-cardinality keyspaces without pre-planned slot counts
+ * - High-cardinality keyspaces without pre-planned slot counts (unless the
+ *   store is a cache: enable eviction and accept that keys come and go)
  * - Any operation where you cannot tolerate EAGAIN and retry
  *
  * MECHANICAL SYMPATHY NOTE
@@ -601,6 +878,18 @@ typedef enum {
  *    tool for an ordinary refresh (use splinter_set / splinter_append instead).
  */
 
+/** @brief Snapshot field masks: which parts of a slot to copy. hash and epoch
+ *  are always filled in; fields left out are not touched. */
+#define SPL_SNAP_KEY        (1u << 0)   /* key */
+#define SPL_SNAP_VALUE      (1u << 1)   /* val_off, val_len */
+#define SPL_SNAP_TYPE       (1u << 2)   /* type_flag, user_flag */
+#define SPL_SNAP_TIME       (1u << 3)   /* ctime, atime */
+#define SPL_SNAP_BLOOM      (1u << 4)   /* bloom */
+#define SPL_SNAP_EMBEDDING  (1u << 5)   /* embedding (SPLINTER_EMBEDDINGS builds) */
+#define SPL_SNAP_META       (SPL_SNAP_KEY | SPL_SNAP_VALUE | SPL_SNAP_TYPE | \
+                             SPL_SNAP_TIME | SPL_SNAP_BLOOM)
+#define SPL_SNAP_ALL        (SPL_SNAP_META | SPL_SNAP_EMBEDDING)
+
 /**
  * @brief Copy the current atomic Splinter slot header to a corresponding client
  * structure.
@@ -609,6 +898,49 @@ typedef enum {
  */
 int splinter_get_slot_snapshot(const char *key, splinter_slot_snapshot_t *snapshot);
 
+/**
+ * @brief Like splinter_get_slot_snapshot(), but copies only the fields in fields.
+ * Metadata reads (epoch, length, type) should pass a narrow mask: the full
+ * snapshot includes the embedding, several KB per call in embedding builds.
+ * @param key The key to look up.
+ * @param snapshot Receives the slot; fields outside the mask are not written.
+ * @param fields SPL_SNAP_* mask; hash and epoch are always copied.
+ * @return 0 on success, -1 if the key is absent (ENOENT when expired or
+ * removed mid-copy) or stayed mid-write for every attempt (EAGAIN), -2 on
+ * bad args.
+ */
+int splinter_get_slot_snapshot_ex(const char *key, splinter_slot_snapshot_t *snapshot,
+                                  unsigned fields);
+
+/**
+ * @struct splinter_cursor
+ * @brief Position of a splinter_iter_next() or splinter_purge_step() traversal.
+ * Zero it to start. Setting next and end splits a store into ranges that
+ * separate threads can walk.
+ */
+typedef struct splinter_cursor {
+    /** @brief Next slot index to examine; after a hit, next - 1 is its slot. */
+    uint64_t next;
+    /** @brief Slot index to stop before; 0 means the end of the store. */
+    uint64_t end;
+} splinter_cursor_t;
+
+/**
+ * @brief Visit the next occupied slot, in slot order, as a seqlock-consistent snapshot.
+ * Walks the occupancy bitmap, so a traversal costs O(occupied) plus one word
+ * per 64 slots, with no hashing or probing. Expired keys are skipped, and so is
+ * a slot that stays mid-write for the whole retry budget. A traversal that
+ * runs across a splinter_resize() continues by index in the new store, so it
+ * may miss or repeat keys.
+ * @param cursor Traversal position; zero-initialise before the first call,
+ * or set next/end to walk only that range of slots.
+ * @param snapshot Receives the slot; only the fields in fields are written.
+ * @param fields SPL_SNAP_* mask (SPL_SNAP_META skips the embedding copy).
+ * @return 1 if a slot was copied, 0 when the traversal is complete, -2 on bad args.
+ */
+int splinter_iter_next(splinter_cursor_t *cursor, splinter_slot_snapshot_t *snapshot,
+                       unsigned fields);
+
 /**
  * @brief Creates and initializes a new splinter store.
  * @param name_or_path The name of the shared memory object or path to the file.
@@ -628,6 +960,25 @@ int splinter_get_slot_snapshot(const char *key, splinter_slot_snapshot_t *snapsh
  */
 int splinter_create(const char *name_or_path, size_t slots, size_t max_value_sz);
 
+/**
+ * @brief Creates a new store with an explicitly sized value arena.
+ * Values live in variable-size extents drawn from size classes (64 bytes,
+ * doubling, up to max_value_sz), so the arena only has to hold the bytes your
+ * values actually use, not slots × max_value_sz. A store of counters with a
+ * 64 KB ceiling for the odd completion can be a small fraction of the size.
+ * @param name_or_path The name of the shared memory object or path to the file.
+ * @param slots The total number of key-value slots to allocate.
+ * @param max_value_sz The maximum size in bytes for any single value.
+ * @param arena_sz Value arena size in bytes; 0 means slots × max_value_sz
+ *        (rounded up to 64), the same capacity splinter_create() provides.
+ * @return 0 on success, -1 on failure, -2 on invalid geometry (errno EINVAL if
+ *         the arena cannot hold one max_value_sz value, EFBIG if it exceeds
+ *         256 GiB or max_value_sz exceeds 4 GiB).
+ * @note Same creation semantics (O_EXCL, umask handling) as splinter_create().
+ */
+int splinter_create_ex(const char *name_or_path, size_t slots, size_t max_value_sz,
+                       size_t arena_sz);
+
 /**
  * @brief Opens an existing splinter store.
  * @param name_or_path The name of the shared memory object or path to the file.
@@ -669,7 +1020,8 @@ void splinter_close(void);
 
 // About Splinter "Mop" Modes
 // Because splinter has static geometry, there's no 'row level' cleanup required.
-// We only have key -> value, where value can be up to max_val_sz.
+// We only have key -> value, where value can be up to max_val_sz and lives in
+// a size-class extent at least as wide as the value.
 //
 // 99.999% of people will never have to think about this. Unless you're doing LLM 
 // training, high-signal runtimes, or verifiable scientific research, you can 
@@ -691,7 +1043,7 @@ void splinter_close(void);
 //    "slop" region. This prevents SIMD/Vectorized loads from seeing stale 
 //    data without the cost of a full boil.
 //
-// 2. Full (Boil): Zero out the entire max_val_sz assigned to that slot. 
+// 2. Full (Boil): Zero out the entire extent assigned to that slot. 
 //    This ensures absolute hygiene for LLM memory and forensics, but 
 //    it "squats" on the seqlock longer.
 //
@@ -700,7 +1052,7 @@ void splinter_close(void);
 // if you ABSOLUTELY require verifiable zero-contamination.
 //
 // Purge: Can be run during backfill runs or maintenance to zero out lingering 
-// orphan data in empty slots or active tails. This doesn't reclaim space; 
+// data in active tails (freed extents are zeroed as they are freed). This doesn't reclaim space; 
 // it only ensures the manifold is clean.
 
 /**
@@ -724,12 +1076,29 @@ int splinter_get_mop(void);
  */
 void splinter_purge(void);
 
+/**
+ * @brief Run splinter_purge() over part of the store, stopping when a time
+ * budget runs out so a sweep can be spread over a maintenance window.
+ * Slots a previous purge left clean, and that have not been written since,
+ * are skipped without taking the seqlock. Large extents are zeroed with
+ * non-temporal stores where the CPU has them, so a sweep does not flush the
+ * cache that readers are using. Callers can split the store across threads by
+ * giving each one a cursor with its own next/end range.
+ * @param cursor Sweep position; zero it to sweep the whole store.
+ * @param budget_ns Time to spend before returning; 0 = run to the end.
+ * @return 1 if slots remain (call again with the same cursor), 0 when the
+ * range is done, -2 on bad args.
+ */
+int splinter_purge_step(splinter_cursor_t *cursor, uint64_t budget_ns);
+
 /**
  * @brief Sets or updates a key-value pair in the store.
  * @param key The null-terminated key string.
  * @param val Pointer to the value data.
- * @param len The length of the value data. Must not exceed `max_val_sz`.
- * @return 0 on success, -1 on failure (e.g., store is full).
+ * @param len The length of the value data. Must not exceed `max_val_sz`
+ * (`chain_max` when chaining is on; see splinter_set_chaining()).
+ * @return 0 on success, -1 on failure (e.g., store is full, errno ENOSPC;
+ * value too long, errno EMSGSIZE).
  */
 int splinter_set(const char *key, const void *val, size_t len);
 
@@ -756,6 +1125,9 @@ int splinter_get(const char *key, void *buf, size_t buf_sz, size_t *out_sz);
 
 /**
  * @brief Lists all keys currently in the store.
+ * Only occupied slots are visited (see the occupancy bitmap), but the keys are
+ * pointers into shared memory that a writer may rewrite under you; prefer
+ * splinter_iter_next(), which copies them out under the slot seqlock.
  * @param out_keys An array of `char*` to be filled with pointers to the keys.
  * @param max_keys The maximum number of keys to write to `out_keys`.
  * @param out_count Pointer to a size_t to store the number of keys found.
@@ -763,11 +1135,400 @@ int splinter_get(const char *key, void *buf, size_t buf_sz, size_t *out_sz);
  */
 int splinter_list(char **out_keys, size_t max_keys, size_t *out_count);
 
+/**
+ * @brief Turn the ordered key index on or off.
+ * Enabling (re)builds the index from the live slots, so it is safe to call on
+ * a populated store. Disabling stops maintenance; the index region is left
+ * as-is and is rebuilt on the next enable.
+ * @param on 1 to maintain the index on set/unset, 0 to stop.
+ * @return 0 on success, -1 if disabling could not take the index lock in
+ * bounded time (errno EAGAIN; the index is marked stale), -2 if there is no store.
+ */
+int splinter_set_key_index(unsigned int on);
+
+/**
+ * @brief Query whether the ordered key index is maintained.
+ * @return 1 if enabled, 0 if not, -2 if there is no store.
+ */
+int splinter_get_key_index(void);
+
+/**
+ * @brief Rebuild the ordered key index from the slot array.
+ * This is also the recovery path for an index marked stale (a writer gave up
+ * waiting for the index lock, or crashed holding it). After a bounded wait
+ * the lock is broken only if the process holding it no longer exists.
+ * @return number of keys indexed, -1 with errno EBUSY if a live process holds
+ * the index lock, -2 if there is no store.
+ */
+int splinter_index_rebuild(void);
+
+/**
+ * @brief Visit every key that begins with prefix, in byte order.
+ * Cost is O(log n + matches) rather than a sweep of every slot. Keys are
+ * copied out in small batches, each validated against the index seqlock
+ * before the callback sees it, so callbacks may freely call back into the
+ * store. A key inserted or removed while the scan runs may or may not be seen.
+ * @param prefix Key prefix; "" (or NULL) visits the whole store in order.
+ * @param callback Invoked with each key and its slot epoch at copy time.
+ * @param user_data Opaque pointer for the callback.
+ * @return number of keys visited, -1 if the index is disabled (errno ENOTSUP)
+ * or stale (errno ESTALE), -2 on NULL store or callback.
+ */
+int splinter_scan_prefix(const char *prefix,
+    void (*callback)(const char *key, uint64_t epoch, void *data), void *user_data);
+
+/**
+ * @brief Visit every key k with lo <= k < hi, in byte order.
+ * Same cost and consistency guarantees as splinter_scan_prefix().
+ * @param lo Inclusive lower bound; NULL starts at the first key.
+ * @param hi Exclusive upper bound; NULL runs to the last key.
+ * @param callback Invoked with each key and its slot epoch at copy time.
+ * @param user_data Opaque pointer for the callback.
+ * @return number of keys visited, -1 if the index is disabled (errno ENOTSUP)
+ * or stale (errno ESTALE), -2 on NULL store or callback.
+ */
+int splinter_scan_range(const char *lo, const char *hi,
+    void (*callback)(const char *key, uint64_t epoch, void *data), void *user_data);
+
+/**
+ * @brief Give a key a time-to-live. Once it lapses the key reads as absent
+ * and its slot is reclaimed lazily (on lookup, by a CLOCK sweep when the
+ * store is full, or by splinter_expire_sweep()). Overwriting a live key keeps
+ * its TTL; re-arm it after a refresh if that is what you mean. The stamp is
+ * written under the slot's seqlock, so the slot epoch advances.
+ * @param key The null-terminated key string.
+ * @param ttl_sec Seconds from now; 0 removes the TTL.
+ * @return 0 on success, -1 if the key was not found or has expired (errno
+ * ENOENT) or is mid-write (errno EAGAIN), -2 on NULL key/store.
+ */
+int splinter_set_ttl(const char *key, uint32_t ttl_sec);
+
+/**
+ * @brief Read a key's remaining time-to-live.
+ * @param key The null-terminated key string.
+ * @return whole seconds left (rounded up), 0 if the key has no TTL, -1 with
+ * errno ENOENT if the key was not found (or has already expired), -2 on NULL
+ * key/store.
+ */
+int64_t splinter_get_ttl(const char *key);
+
+/**
+ * @brief Reclaim every key whose TTL has lapsed.
+ * @return number of keys reclaimed, -2 if there is no store.
+ */
+int splinter_expire_sweep(void);
+
+/**
+ * @brief Turn CLOCK eviction on or off.
+ * With eviction on, a splinter_set() that finds no free slot advances the
+ * shared CLOCK hand and reclaims the first slot that is stable (even epoch),
+ * carries no bloom labels, and has not been referenced since the hand last
+ * passed. Reads, writes and splinter_set_slot_time(ATIME) set the reference
+ * bit. Label a key to pin it. Expired keys are always reclaimed first,
+ * whether or not eviction is on.
+ * @param on 1 to evict when full, 0 to refuse (ENOSPC) as before.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_set_eviction(unsigned int on);
+
+/**
+ * @brief Query whether CLOCK eviction is enabled.
+ * @return 1 if enabled, 0 if not, -2 if there is no store.
+ */
+int splinter_get_eviction(void);
+
+/**
+ * @brief Allow or refuse values longer than max_val_sz.
+ * With chaining on, splinter_set() and splinter_append() accept up to
+ * chain_max bytes (see splinter_get_header_snapshot) by spreading the value
+ * over top-class extents listed in a per-slot descriptor. Readers see one
+ * value under one slot epoch. Turning chaining off refuses new long values
+ * (EMSGSIZE) but leaves existing ones readable.
+ * @param on 1 to chain, 0 to hold values to max_val_sz.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_set_chaining(unsigned int on);
+
+/**
+ * @brief Query whether chained values are enabled.
+ * @return 1 if enabled, 0 if not, -2 if there is no store.
+ */
+int splinter_get_chaining(void);
+
+/**
+ * @struct splinter_stats
+ * @brief Operation counters summed over every stripe (splinter_get_stats).
+ */
+typedef struct splinter_stats {
+    /** @brief 1 if counting is on. */
+    uint32_t enabled;
+    /** @brief Calls per operation, indexed by enum splinter_stat_op. */
+    uint64_t ops[SPL_OP_COUNT];
+    /** @brief get, unset and append calls that did not find the key. */
+    uint64_t misses;
+    /** @brief get, set, unset and append calls that returned EAGAIN. */
+    uint64_t eagain;
+    /** @brief Slots a set probed past because they were held mid-write. */
+    uint64_t retries;
+    /** @brief Sets refused with ENOSPC (no free slot or no arena space). */
+    uint64_t set_full;
+    /** @brief Writes to the event bus eventfd. */
+    uint64_t eventfd_writes;
+    /** @brief Slots probed past the home slot by successful gets and sets:
+     *  0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+. */
+    uint64_t probe[SPLINTER_PROBE_BUCKETS];
+    /** @brief Wake-ups read back by splinter_event_bus_wait(); eventfd_writes
+     *  minus this is what bus consumers have yet to see. */
+    uint64_t eventfd_reads;
+    /** @brief Shard elections whose winner differed from the previous one. */
+    uint64_t sovereign_changes;
+    /** @brief splinter_madvise() calls that had to defer to another sovereign. */
+    uint64_t madvise_defers;
+} splinter_stats_t;
+
+/**
+ * @brief Turn the operation counters on or off for every process using the store.
+ * While on, get, set, unset and append add to counters in the header. Each
+ * thread picks a stripe by the CPU it first counted on, so counting costs an
+ * uncontended atomic add rather than a shared hot line. Off, the cost is one
+ * flag load per call. Turning counting off keeps the totals.
+ * @param on 1 to count, 0 to stop.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_set_stats(unsigned int on);
+
+/**
+ * @brief Sum the operation counters into a snapshot.
+ * Counters are read one at a time while others may be adding to them, so
+ * totals taken under load are approximate, never torn.
+ * @param out Receives the totals.
+ * @return 0 on success, -2 if there is no store or out is NULL.
+ */
+int splinter_get_stats(splinter_stats_t *out);
+
+/**
+ * @brief Zero the operation counters.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_reset_stats(void);
+
+/**
+ * @struct splinter_latency
+ * @brief Percentiles of one call's latency histogram (splinter_get_latency).
+ * Times are splinter_now() ticks, reported as the top of their bucket.
+ */
+typedef struct splinter_latency {
+    /** @brief Current sampling interval; 0 = off. */
+    uint32_t every;
+    /** @brief Calls timed so far. */
+    uint64_t samples;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    /** @brief Slowest timed call (exact). */
+    uint64_t max;
+} splinter_latency_t;
+
+/**
+ * @brief Time one in every `every` calls to get, set, append, set_embedding,
+ * integer_op and madvise into histograms in the store.
+ * Each thread counts down its own interval, so an untimed call costs a flag
+ * load and a thread-local decrement. A timed call adds two splinter_now()
+ * reads and one atomic add. The histograms are shared, so any process sees
+ * percentiles merged across every process that uses the store.
+ * @param every 1 to time every call, N to time one in N, 0 to stop.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_set_latency_sampling(unsigned int every);
+
+/**
+ * @brief Read percentiles from one call's latency histogram.
+ * @param op SPL_LAT_* call to read.
+ * @param out Receives the percentiles; all zero if nothing was timed.
+ * @return 0 on success, -2 if there is no store, out is NULL or op is out of range.
+ */
+int splinter_get_latency(unsigned int op, splinter_latency_t *out);
+
+/**
+ * @brief Zero every latency histogram.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_reset_latency(void);
+
+/** @brief Regions of a store's mapping, in order (splinter_mem_report_t.region). */
+enum splinter_mem_region_id {
+    SPL_REGION_HEADER,
+    SPL_REGION_SLOTS,
+    SPL_REGION_EMBEDDINGS,  /**< pages of the slot array holding embeddings; 0 without them */
+    SPL_REGION_INDEX,
+    SPL_REGION_AUX,
+    SPL_REGION_OCC,
+    SPL_REGION_VALUES,
+    SPL_REGION_COUNT
+};
+
+/** @brief Slot-range buckets in splinter_mem_report_t.range. */
+#define SPLINTER_MEM_RANGES 16
+
+/** @brief Residency of one region of the mapping. */
+typedef struct splinter_mem_region {
+    uint64_t bytes;     /**< size of the region */
+    uint64_t pages;     /**< pages it touches (a page two regions share counts for both) */
+    uint64_t resident;  /**< of those, pages in memory */
+} splinter_mem_region_t;
+
+/** @brief Values of a set of slots: their bytes and how many are in memory. */
+typedef struct splinter_mem_values {
+    uint64_t keys;      /**< live keys */
+    uint64_t val_bytes; /**< sum of val_len */
+    uint64_t ext_bytes; /**< sum of the extents holding them */
+    uint64_t resident;  /**< extent bytes on resident pages */
+} splinter_mem_values_t;
+
+/**
+ * @struct splinter_mem_report
+ * @brief Where a store's memory goes (splinter_mem_report).
+ */
+typedef struct splinter_mem_report {
+    uint64_t page_size;
+    uint32_t slots;
+    uint32_t max_val_sz;
+    splinter_mem_region_t region[SPL_REGION_COUNT];
+    /** @brief Every live value. ext_bytes - val_bytes is size-class slack. */
+    splinter_mem_values_t all;
+    /** @brief Values carrying each bloom label bit (a value may count for several). */
+    splinter_mem_values_t label[64];
+    /** @brief Values by slot index: range[b] covers slots [b * range_slots, (b + 1) * range_slots). */
+    splinter_mem_values_t range[SPLINTER_MEM_RANGES];
+    uint32_t range_slots;
+    /** @brief Live keys with a nonzero embedding; 0 without embeddings. */
+    uint64_t embedded;
+} splinter_mem_report_t;
+
+/**
+ * @brief Measure how much of the store is resident, with mincore(), and
+ * how its value bytes are spent.
+ * Slots are read without their seqlock, so a report taken under writes is
+ * approximate. The value arena is walked once; the cost is O(slots) plus
+ * one byte per page of the mapping.
+ * @param out Receives the report.
+ * @return 0 on success, -1 if mincore() or the page vector failed (errno
+ * set), -2 if there is no store or out is NULL.
+ */
+int splinter_mem_report(splinter_mem_report_t *out);
+
+/**
+ * @enum splinter_trace_op
+ * @brief Calls a trace records (splinter_trace_record_t.op).
+ */
+enum splinter_trace_op {
+    SPL_TRACE_GET,
+    SPL_TRACE_SET,
+    SPL_TRACE_UNSET,
+    SPL_TRACE_APPEND,
+    SPL_TRACE_INTEGER_OP,
+    SPL_TRACE_OPS
+};
+
+/** @brief First bytes of every trace file. */
+#define SPLINTER_TRACE_MAGIC "SPLTRACE"
+/** @brief Trace file layout version. */
+#define SPLINTER_TRACE_VER 1
+
+/**
+ * @struct splinter_trace_header
+ * @brief Start of a trace file; records follow it back to back.
+ */
+typedef struct splinter_trace_header {
+    /** @brief SPLINTER_TRACE_MAGIC, not NUL-terminated. */
+    char magic[8];
+    uint32_t version;
+    /** @brief sizeof(splinter_trace_record_t) when written. */
+    uint32_t rec_size;
+    /** @brief splinter_tick_hz() of the tracing host, for record timestamps. */
+    uint64_t tick_hz;
+    /** @brief Geometry of the traced store. */
+    uint64_t slots;
+    uint64_t max_val_sz;
+    uint64_t pid;
+    /** @brief Records lost to a full ring; filled in by splinter_trace_stop(). */
+    uint64_t dropped;
+} splinter_trace_header_t;
+
+/**
+ * @struct splinter_trace_record
+ * @brief One traced call. Keys are kept as their hash only.
+ */
+typedef struct splinter_trace_record {
+    /** @brief splinter_now() when the call returned. */
+    uint64_t ts;
+    /** @brief FNV-1a hash of the key, as the store computes it. */
+    uint64_t key_hash;
+    uint32_t pid;
+    uint32_t tid;
+    /** @brief Bytes written (set, append) or found (get). */
+    uint32_t val_len;
+    /** @brief enum splinter_trace_op. */
+    uint8_t op;
+    /** @brief splinter_integer_op_t for SPL_TRACE_INTEGER_OP, else 0. */
+    uint8_t arg;
+    /** @brief 0 on success, else the call's negative return. */
+    int8_t result;
+    /** @brief errno when result is -1 (saturated at 255). */
+    uint8_t err;
+} splinter_trace_record_t;
+
+/**
+ * @brief Start tracing this process's get, set, unset, append and
+ * integer_op calls to a binary file (see splinter_replay).
+ * Calls append fixed-size records to a lock-free ring in process memory; the
+ * call that fills half of it writes that half to the file. A full ring drops
+ * records (counted in the header) rather than block a caller. Off, the cost is
+ * one flag load per call. Setting SPLINTER_TRACE=<path> in the environment
+ * starts tracing to <path>.<pid> on every create or open. A forked child does
+ * not inherit the trace; with SPLINTER_TRACE set it starts its own file.
+ * @param path File to create (truncated if it exists).
+ * @return 0 on success, -1 on error (errno EBUSY if already tracing, or the
+ * open/allocation error), -2 if there is no store or path is NULL.
+ */
+int splinter_trace_start(const char *path);
+
+/**
+ * @brief Write out whatever the trace ring holds now.
+ * @return 0 on success, -1 if not tracing (errno EINVAL).
+ */
+int splinter_trace_flush(void);
+
+/**
+ * @brief Flush and close the trace. splinter_close() calls this too.
+ * Calls still in flight on other threads may be missed.
+ * @return 0 on success, -1 if not tracing (errno EINVAL).
+ */
+int splinter_trace_stop(void);
+
+/**
+ * @brief Map a value, chained or not, as an iovec array without copying.
+ * Each entry points into shared memory, so treat it like splinter_get_raw_ptr():
+ * consume, then confirm splinter_get_epoch(key) still equals *out_epoch.
+ * @param key The null-terminated key string.
+ * @param iov Destination array; NULL to only ask how many entries are needed.
+ * @param iovcnt Capacity of iov.
+ * @param out_len Receives the value's total length. May be NULL.
+ * @param out_epoch Receives the (even) slot epoch the view belongs to. May be NULL.
+ * @return number of entries (filled, or needed when iov is NULL), -1 if the
+ * key was not found, is mid-write (errno EAGAIN), has expired (ENOENT) or
+ * needs more than iovcnt entries (EMSGSIZE), -2 on NULL key/store.
+ */
+int splinter_get_iov(const char *key, struct iovec *iov, int iovcnt,
+                     size_t *out_len, uint64_t *out_epoch);
+
 /**
  * @brief Waits for a key's value to be changed.
  * @param key The key to monitor for changes.
  * @param timeout_ms The maximum time to wait in milliseconds.
  * @return 0 if the value changed, -1 on timeout or if the key doesn't exist.
+ * A resize during the wait is followed; the key is watched in the new store.
  */
 int splinter_poll(const char *key, uint64_t timeout_ms);
 
@@ -892,6 +1653,35 @@ inline uint64_t splinter_now(void) {
 #endif
 }
 
+/**
+ * @brief splinter_now() ticks per second on this host.
+ * Taken from the counter's advertised frequency where the CPU reports one
+ * (cntfrq_el0, CPUID leaf 0x15), otherwise measured against
+ * CLOCK_MONOTONIC_RAW over about a millisecond. The first process to need it
+ * stores it in the header, so every process on the host shares one figure
+ * and only one pays for the measurement. Opening a store never re-measures:
+ * processes already attached keep counting at the rate they read, so a
+ * file-backed store keeps its figure until it is recreated. Works without a
+ * store (the figure is then kept per process).
+ * @return ticks per second (never 0).
+ */
+uint64_t splinter_tick_hz(void);
+
+/**
+ * @brief Convert a splinter_now() interval to nanoseconds.
+ * @param ticks Difference of two splinter_now() readings.
+ * @return the interval in nanoseconds.
+ */
+uint64_t splinter_ticks_to_ns(uint64_t ticks);
+
+/**
+ * @brief Convert nanoseconds to splinter_now() ticks, e.g. to declare a
+ * shard window (splinter_shard_claim) in real time.
+ * @param ns Interval in nanoseconds.
+ * @return the interval in splinter_now() ticks.
+ */
+uint64_t splinter_ns_to_ticks(uint64_t ns);
+
 /**
  * @brief Update a slot's ctime / atime
  * @param key Name of the key to change
@@ -919,7 +1709,8 @@ int splinter_integer_op(const char *key, splinter_integer_op_t op, const void *m
  * @param key The key to look up.
  * @param out_sz Pointer to receive the actual length of the value.
  * @param out_epoch Pointer to receive the epoch at the time of lookup.
- * @return A const pointer to the data in SHM, or NULL if not found.
+ * @return A const pointer to the data in SHM, or NULL if not found (or, with
+ * errno EMSGSIZE, if the value is chained — use splinter_get_iov()).
  */
 const void *splinter_get_raw_ptr(const char *key, size_t *out_sz, uint64_t *out_epoch);
 
@@ -951,19 +1742,21 @@ int splinter_bump_slot(const char *key);
  * not compiled in; in that case it simply resets the epoch and republishes.
  *
  * @param key Current key name associated with the slot.
- * @return 0 on success, -1 if key not found, -2 on bad arguments.
+ * @return 0 on success, -1 if key not found (or EAGAIN while a running
+ * resize has already copied it), -2 on bad arguments.
  */
 int splinter_retrain_slot(const char *key);
 
 /**
  * @brief Atomically apply a label mask to a slot's Bloom filter.
- * @return 0 on success, -1 if key not found.
+ * @return 0 on success, -1 if key not found, or (EAGAIN) if the slot stayed
+ * mid-write or a running resize has already copied it.
  */
 int splinter_set_label(const char *key, uint64_t mask);
 
 /**
  * @brief Atomically remove a previously applied bloom label
- * @return 0 on success, negative on failure
+ * @return 0 on success, negative on failure (EAGAIN as for splinter_set_label)
  */
 int splinter_unset_label(const char *key, uint64_t mask);
 
@@ -1099,9 +1892,37 @@ int splinter_set_as_system(const char *key);
  * @param data_len Number of bytes to append.
  * @param new_len  Output: set to the new total value length on success. May be NULL.
  * @return 0 on success, -1 if key not found or overflow, -2 if args invalid.
+ * With chaining on, a value may grow past max_val_sz up to chain_max.
  */
 int splinter_append(const char *key, const void *data, size_t data_len, size_t *new_len);
 
+/**
+ * @brief Grow (or shrink) the open store to new geometry without taking it down.
+ * A replacement store is built beside this one and every live key is copied
+ * over with its value, labels, type, times, TTL, embedding and epoch. A slot
+ * is held only while it is copied; after that it keeps serving reads, but
+ * writes to it (set, unset, append, labels, TTL, ...) fail with EAGAIN until
+ * the replacement is renamed over the store's name. So reads never stall, and
+ * writes to a key already copied stall for the rest of the walk, which grows
+ * with the store. Attached processes then remap on their next call; the
+ * caller is switched over at once.
+ * The old mapping is kept (not unmapped) until the next resize or
+ * splinter_close(), but raw pointers and iovecs still belong to the old store.
+ * Threads of one process follow a resize together: one remaps, the others
+ * wait for it. The copy runs in a forked child, so the caller's other threads
+ * stay on the old mapping during the call and follow the move afterwards.
+ * If the copier dies, the first writer or resizer to notice rolls the resize
+ * back (or publishes it, if the replacement was already renamed into place).
+ * @param new_slots Slot count of the replacement.
+ * @param new_max_val_sz Maximum value size of the replacement; its arena is
+ * the default new_slots × new_max_val_sz.
+ * @return 0 on success; -1 if the store was left unchanged: EBUSY (another
+ * resize is running, or a slot stayed mid-write), ENOSPC / EMSGSIZE (the live
+ * keys do not fit the new geometry), EIO (the copying child died), or the
+ * fork/create/rename error; -2 on no store or zero geometry (EINVAL).
+ */
+int splinter_resize(size_t new_slots, size_t new_max_val_sz);
+
 /* ---------------------------------------------------------------------------
  * Logic Shard Election & Voluntary Yield (cooperative memory advisement).
  *
@@ -1151,6 +1972,21 @@ int splinter_shard_claim_ex(uint32_t shard_id, uint32_t pid, uint8_t intent,
                             uint8_t priority, uint64_t duration_tsc,
                             uint64_t claimed_at);
 
+/**
+ * @brief Claim a bid over part of the store only.
+ *
+ * As splinter_shard_claim(), but the bid competes only with bids whose scope
+ * overlaps it. Two slot ranges overlap if they intersect, two label masks if
+ * they share a bit; a range and a label mask are assumed to overlap, since
+ * labels move between slots. splinter_shard_claim() and _ex() claim (or
+ * re-claim) the whole store; splinter_shard_rebid() keeps the scope.
+ * @param scope Slots and labels the bid covers; NULL or all zero for the
+ *        whole store. slot_hi is clamped to the slot count when advising.
+ * @return as splinter_shard_claim(); -2 also if slot_lo > slot_hi.
+ */
+int splinter_shard_claim_scoped(uint32_t shard_id, uint8_t intent, uint8_t priority,
+                                uint64_t duration_tsc, const splinter_shard_scope_t *scope);
+
 /**
  * @brief Refresh (re-bid) an existing claim's window. Updates claimed_at to
  * splinter_now() and optionally changes intent/priority/duration. This is the
@@ -1180,7 +2016,9 @@ int splinter_shard_release(uint32_t shard_id);
 uint32_t splinter_shard_election(uint8_t *out_intent);
 
 /**
- * @brief Convenience: is shard_id the current sovereign?
+ * @brief Is shard_id sovereign over its own scope? For an unscoped bid that
+ * is the whole-table election; a scoped bid need only beat the live bids
+ * that overlap it.
  * @return 1 if sovereign, 0 if not (including unknown/expired), -2 on no store.
  */
 int splinter_shard_is_sovereign(uint32_t shard_id);
@@ -1196,15 +2034,18 @@ int splinter_shard_table_snapshot(struct splinter_shard_bid_snapshot *out, size_
 /**
  * @brief Cooperative posix_madvise(): the voluntary-yield entry point.
  *
- * Runs the election. If shard_id is sovereign, issues posix_madvise(addr,len,advice)
- * immediately and returns its result. If not sovereign:
+ * Runs the election over shard_id's scope. If shard_id is sovereign there,
+ * issues posix_madvise(addr,len,advice) immediately and returns its result.
+ * If not sovereign:
  *   - timeout_ticks == 0          -> do NOT block; return -1, errno=EAGAIN (defer).
  *   - timeout_ticks == UINT64_MAX -> block until sovereign, then advise.
  *   - else                        -> block up to timeout_ticks, re-electing on each wake.
  * Blocking uses the eventfd broker when the bus owner has armed it
  * (splinter_event_bus_open/wait); otherwise a TSC-polled nanosleep fallback.
  *
- * If addr==NULL, advises the whole value arena (VALUES .. VALUES+arena_sz).
+ * If addr==NULL, advises the whole value arena (VALUES .. VALUES+arena_sz) for
+ * an unscoped bid, and for a scoped one the pages holding the values of the
+ * slots in its scope, one posix_madvise() per run of adjacent pages.
  *
  * @return 0 on success (advisement issued), -1 on EAGAIN/timeout/posix_madvise
  *         failure (errno set), -2 on bad args/no store/unknown shard_id.
@@ -1212,6 +2053,72 @@ int splinter_shard_table_snapshot(struct splinter_shard_bid_snapshot *out, size_
 int splinter_madvise(uint32_t shard_id, void *addr, size_t len,
                      int advice, uint64_t timeout_ticks);
 
+/**
+ * @struct splinter_tier_policy
+ * @brief Knobs for splinter_tier_pass(). Zero fields take the defaults.
+ */
+typedef struct splinter_tier_policy {
+    uint8_t  cold_passes;    /**< idle passes before a slot is cold (default 4, at most 63) */
+    uint8_t  priority;       /**< bid priority for the pass (default 0: yield to everyone) */
+    uint8_t  pageout;        /**< 1 to page cold values out (MADV_PAGEOUT), 0 for MADV_COLD */
+    uint64_t timeout_ticks;  /**< per splinter_madvise() call; 0 defers at once */
+} splinter_tier_policy_t;
+
+/**
+ * @struct splinter_tier_report
+ * @brief What one splinter_tier_pass() saw and did.
+ */
+typedef struct splinter_tier_report {
+    uint32_t scanned;        /**< occupied slots looked at */
+    uint32_t hot;            /**< touched since the last pass */
+    uint32_t cold;           /**< idle for cold_passes passes or more */
+    uint32_t rising;         /**< touched again after being advised cold */
+    uint64_t cold_bytes;     /**< bytes of pages advised cold */
+    uint64_t warm_bytes;     /**< bytes of pages advised back in */
+    uint32_t deferred;       /**< phases cut short by losing the election */
+} splinter_tier_report_t;
+
+/**
+ * @brief Have every access mark its slot for splinter_tier_pass().
+ * Reads, writes and splinter_set_slot_time(ATIME) set the slot's touched bit
+ * (one relaxed load when already set). Off by default.
+ * @param on 1 to mark accesses, 0 to stop.
+ * @return 0 on success, -2 if there is no store.
+ */
+int splinter_set_tiering(unsigned int on);
+
+/**
+ * @brief Query whether accesses are being marked for tiering.
+ * @return 1 if on, 0 if not, -2 if there is no store.
+ */
+int splinter_get_tiering(void);
+
+/**
+ * @brief One pass of the hot/cold page manager.
+ *
+ * Ages every occupied slot: a touched slot is hot, an untouched one gains an
+ * idle pass, and one idle for cold_passes is cold. The pages holding only
+ * newly cold values are advised MADV_COLD (or MADV_PAGEOUT); values touched
+ * again after that are advised MADV_POPULATE_READ (MADV_WILLNEED on kernels
+ * without it). A page shared with a value still in use is never advised cold.
+ *
+ * Every advice goes through splinter_madvise(): the pass claims shard_id,
+ * unscoped, as DONTNEED for the cold pages (so any overlapping WILLNEED or
+ * SEQUENTIAL bid bumps it) and as WILLNEED for the rising ones, and releases
+ * it when done. Use a shard_id of its own: an id that already has a bid is
+ * refused (EBUSY) rather than overwritten. A phase that loses the election
+ * stops and counts as deferred. A cold value is marked advised only once all
+ * of its pages were; one deferred, or sharing a page with a value still in
+ * use, is tried again next pass.
+ * @param pol Policy, or NULL for the defaults.
+ * @param out Receives the pass's report; may be NULL.
+ * @return 0 on success (deferral included), -1 if shard_id already has a bid
+ *         (EBUSY), claiming failed or madvise failed otherwise (errno set),
+ *         -2 on no store/shard_id 0.
+ */
+int splinter_tier_pass(uint32_t shard_id, const splinter_tier_policy_t *pol,
+                       splinter_tier_report_t *out);
+
 #ifdef __cplusplus
 }
 #endif
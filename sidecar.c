@@ -6,14 +6,17 @@
  *
  * Still very much a work-in-progress.
  *
- * Usage: sidecar [optional file to watch "tail -f" style]
+ * Usage: sidecar [-r ms] [optional file to watch "tail -f" style]
  * Then watch pretty graphs update while debug messages roll by.
  * To use with a splinter store (in memory) just prefix the 
  * name with spl: - e.g.
  * 
  * sidecar spl:my_bus
  * 
- * ... would attach it to /dev/shm/my_bus
+ * ... would attach it to /dev/shm/my_bus, and add a panel of the store's
+ * own counters (ops/s, EAGAIN, probe lengths, event bus, shards, signal
+ * groups), computed from splinter_get_stats() deltas without touching a
+ * slot. 'p' hides or shows it. -r sets the refresh interval (default 500).
  * 
  * sidecar /var/log/some_log.txt 
  * 
@@ -43,6 +46,7 @@
 
 #define HISTORY_HEIGHT 10
 #define REFRESH 500000
+#define STORE_PANEL_ROWS 6
 #define HISTORY_DIVISOR 4
 #define MAXW 512
 #define MAX_DEBUG_LINES 12
@@ -81,6 +85,16 @@ static char *debug_lines[MAX_DEBUG_LINES];
 static int debug_line_count = 0;
 static FILE *dbg_fp = NULL;
 
+static long refresh_us = REFRESH;
+static int show_store_panel = 1;
+static int stats_were_on = 1;
+
+// previous store sample, for rates
+static splinter_stats_t prev_st;
+static uint64_t prev_signals[SPLINTER_MAX_GROUPS];
+static struct timespec prev_st_ts;
+static int have_prev_st = 0;
+
 static unsigned int debug_signal_group = 63;
 static uint64_t debug_bloom = (0x800000000000000);
 static struct termios orig_termios;
@@ -377,6 +391,109 @@ static int parse_power_status(power_status_t *power) {
     return 0;
 }
 
+// put counting back the way we found it
+static void restore_store_stats() {
+    if (!stats_were_on) splinter_set_stats(0);
+}
+
+// 12.3k style rate into buf
+static const char *fmt_rate(char *buf, size_t sz, double v) {
+    if (v >= 1e6) snprintf(buf, sz, "%.1fM", v / 1e6);
+    else if (v >= 1e4) snprintf(buf, sz, "%.1fk", v / 1e3);
+    else snprintf(buf, sz, "%.0f", v);
+    return buf;
+}
+
+// store panel: one stats snapshot against the last, no slot scans
+static void draw_store_panel() {
+    splinter_stats_t st;
+    uint64_t sig[SPLINTER_MAX_GROUPS];
+    struct timespec now;
+    char a[16], b[16], c[16], d[16];
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (splinter_get_stats(&st) != 0) return;
+    for (int g = 0; g < SPLINTER_MAX_GROUPS; g++)
+        sig[g] = splinter_get_signal_count((uint8_t)g);
+
+    double dt = (now.tv_sec - prev_st_ts.tv_sec) + (now.tv_nsec - prev_st_ts.tv_nsec) / 1e9;
+    if (!have_prev_st || dt <= 0) {
+        prev_st = st;
+        memcpy(prev_signals, sig, sizeof(sig));
+        prev_st_ts = now;
+        have_prev_st = 1;
+        dt = 0;
+    }
+#define RATE(field) (dt > 0 ? (double)(st.field - prev_st.field) / dt : 0.0)
+
+    uint64_t dcalls = 0;
+    for (int op = 0; op < SPL_OP_COUNT; op++)
+        dcalls += st.ops[op] - prev_st.ops[op];
+    uint64_t deagain = st.eagain - prev_st.eagain;
+    uint64_t dmiss = st.misses - prev_st.misses;
+
+    printf(" > store: get %s/s | set %s/s | unset %s/s | append %s/s[K\n",
+           fmt_rate(a, sizeof(a), RATE(ops[SPL_OP_GET])),
+           fmt_rate(b, sizeof(b), RATE(ops[SPL_OP_SET])),
+           fmt_rate(c, sizeof(c), RATE(ops[SPL_OP_UNSET])),
+           fmt_rate(d, sizeof(d), RATE(ops[SPL_OP_APPEND])));
+    printf(" > eagain %.2f%% | miss %.2f%% | retries %s/s | full %s/s%s[K\n",
+           dcalls ? 100.0 * (double)deagain / (double)dcalls : 0.0,
+           dcalls ? 100.0 * (double)dmiss / (double)dcalls : 0.0,
+           fmt_rate(a, sizeof(a), RATE(retries)),
+           fmt_rate(b, sizeof(b), RATE(set_full)),
+           st.enabled ? "" : " (counting off)");
+
+    // probe lengths since the last refresh; mean uses each bucket's floor
+    uint64_t dp[SPLINTER_PROBE_BUCKETS], found = 0;
+    double mean = 0.0;
+    for (int k = 0; k < SPLINTER_PROBE_BUCKETS; k++) {
+        dp[k] = st.probe[k] - prev_st.probe[k];
+        found += dp[k];
+        mean += (double)dp[k] * (k ? (double)(1u << (k - 1)) : 0.0);
+    }
+    printf(" > probe: home %.1f%% | 1 %.1f%% | 2-7 %.1f%% | 8+ %.1f%% | mean>=%.2f[K\n",
+           found ? 100.0 * dp[0] / found : 0.0,
+           found ? 100.0 * dp[1] / found : 0.0,
+           found ? 100.0 * (dp[2] + dp[3]) / found : 0.0,
+           found ? 100.0 * (found - dp[0] - dp[1] - dp[2] - dp[3]) / found : 0.0,
+           found ? mean / found : 0.0);
+
+    printf(" > bus: wake %s/s | read %s/s | lag %ld[K\n",
+           fmt_rate(a, sizeof(a), RATE(eventfd_writes)),
+           fmt_rate(b, sizeof(b), RATE(eventfd_reads)),
+           (long)(st.eventfd_writes - st.eventfd_reads));
+    printf(" > shards: sovereign changes %s/s (%lu) | madvise defers %s/s (%lu)[K\n",
+           fmt_rate(a, sizeof(a), RATE(sovereign_changes)), st.sovereign_changes,
+           fmt_rate(b, sizeof(b), RATE(madvise_defers)), st.madvise_defers);
+
+    // busiest signal groups that fit on the line
+    int used = printf(" > signals:");
+    int shown = 0;
+    uint8_t taken[SPLINTER_MAX_GROUPS] = {0};
+    while (dt > 0) {
+        int best = -1;
+        for (int g = 0; g < SPLINTER_MAX_GROUPS; g++)
+            if (!taken[g] && sig[g] != prev_signals[g] &&
+                (best < 0 || sig[g] - prev_signals[g] > sig[best] - prev_signals[best]))
+                best = g;
+        if (best < 0) break;
+        taken[best] = 1;
+        char item[40];
+        int n = snprintf(item, sizeof(item), " g%d %s/s", best,
+                         fmt_rate(a, sizeof(a), (double)(sig[best] - prev_signals[best]) / dt));
+        if (used + n >= term_cols) break;
+        used += printf("%s", item);
+        shown++;
+    }
+    printf("%s[K\n", shown ? "" : " quiet");
+#undef RATE
+
+    prev_st = st;
+    memcpy(prev_signals, sig, sizeof(sig));
+    prev_st_ts = now;
+}
+
 static void draw_bar(const char *label, double percent) {
     int filled = (int)(percent / 100.0 * graph_width);
     printf("┌> ");
@@ -390,9 +507,21 @@ static void draw_bar(const char *label, double percent) {
 int main(int argc, char **argv) {
     char *store = NULL;
     const char *needle = "spl:";
-    
-    if (argc > 1) {
-        char *match = strstr(argv[1], needle);
+    const char *target = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        if (opt == 'r' && atol(optarg) > 0) {
+            refresh_us = atol(optarg) * 1000;
+        } else {
+            fprintf(stderr, "Usage: %s [-r ms] [file | spl:store]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (optind < argc) target = argv[optind];
+
+    if (target) {
+        char *match = strstr(target, needle);
         if (match != NULL) {
             store = match + strlen(needle);
             if (splinter_open_or_create(store, 1024, 4096) != 0) {
@@ -401,7 +530,14 @@ int main(int argc, char **argv) {
                 exit(1);
             }
             dbg_fp = NULL;
-        } else if (init_debug_file(argv[1]) != 0) {
+            // the store panel needs the counters; leave them as we found them
+            splinter_stats_t st;
+            if (splinter_get_stats(&st) == 0 && !st.enabled) {
+                stats_were_on = 0;
+                splinter_set_stats(1);
+                atexit(restore_store_stats);
+            }
+        } else if (init_debug_file(target) != 0) {
             dbg_fp = NULL; 
         }
     }
@@ -482,6 +618,9 @@ int main(int argc, char **argv) {
                         }
                     }
                 }
+            } else if (c == 'p' || c == 'P') {
+                show_store_panel = !show_store_panel;
+                resize_pending = 1;
             } else if (c == 'q' || c == 'Q') {
                 // ctrl-c can sometimes behave oddly in raw mode
                 printf("\033[2J\033[H");
@@ -539,15 +678,21 @@ int main(int argc, char **argv) {
             power.on_ac == 1 ? "on ac)  " : "on batt)");
         draw_bar("mem", mem);
 
+        int panel_rows = 0;
+        if (store && show_store_panel) {
+            draw_store_panel();
+            panel_rows = STORE_PANEL_ROWS;
+        }
+
         // how much do we have to work with? 
-        int used_above_debug = 1 + HISTORY_HEIGHT + 1 + (2*2) + 1;
+        int used_above_debug = 1 + HISTORY_HEIGHT + 1 + (2*2) + 1 + panel_rows;
         int used_below_debug = 2;
         int available = term_rows - used_above_debug - used_below_debug;
         int max_debug_rows = (available > 0 ? available : 0);
         
         // are we doing tail -f like behavior?
         if (dbg_fp) {
-            printf(" > tail: %s\n", argv[1]);
+            printf(" > tail: %s\n", target);
             int start = debug_line_count > max_debug_rows ?
                         debug_line_count - max_debug_rows : 0;
             for (int i = start; i < debug_line_count; i++) {
@@ -557,7 +702,7 @@ int main(int argc, char **argv) {
         
         // are we watching a bus ?
         if (store) {
-            printf(" > bus: %s\n", argv[1]);
+            printf(" > bus: %s\n", target);
             uint64_t new_signal_count = splinter_get_signal_count(debug_signal_group);
             if (new_signal_count != old_signal_count) {
                 splinter_enumerate_matches(debug_bloom, on_key_match, NULL);
@@ -585,7 +730,7 @@ int main(int argc, char **argv) {
         printf("\033[J");
 
         fflush(stdout);
-        struct timespec ts = {0, REFRESH * 1000};
+        struct timespec ts = {refresh_us / 1000000, (refresh_us % 1000000) * 1000};
         nanosleep(&ts, NULL);
     } while (1);
 
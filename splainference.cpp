@@ -33,6 +33,7 @@
 #include <chrono>
 #include <thread>
 #include <cstring>
+#include <cerrno>
 
 using atomic_uint_least64_t = std::atomic_uint_least64_t;
 using atomic_uint_least32_t = std::atomic_uint_least32_t;
@@ -55,7 +56,7 @@ using atomic_int_least32_t  = std::atomic_int_least32_t;
 // over the embedding sidecar (40) and any maintenance shard. Advisement is
 // always non-blocking: a live completer never blocks waiting on a hint.
 #define SHARD_ID         0x5F1Au   // "SP-lain"
-#define SHARD_DUR_LIVE   (1ULL << 30)  // splinter_now() ticks; re-bid frequently
+#define SHARD_DUR_LIVE   splinter_ns_to_ticks(350ULL * 1000000ULL)  // 350 ms; re-bid frequently
 #define SHARD_PRIO_LIVE  200
 // Re-bid every this many appended tokens at a flush boundary so the window
 // never lapses mid-request, without ever blocking on the advisement.
@@ -114,17 +115,21 @@ static bool is_word_boundary(const std::string &piece) {
 static std::string fetch_key_text(const char *key) {
     if (!key || !*key) return "";
 
-    splinter_header_snapshot_t hdr = {};
-    if (splinter_get_header_snapshot(&hdr) != 0 || hdr.max_val_sz == 0) {
-        return "";
-    }
-
-    std::vector<char> buf(hdr.max_val_sz);
-    size_t got = 0;
-    if (splinter_get(key, buf.data(), buf.size(), &got) != 0 || got == 0) {
-        return "";
+    // Size the buffer from the value itself; a writer growing it between the
+    // two calls costs another round (EMSGSIZE), not a chain_max allocation.
+    std::vector<char> buf;
+    for (int tries = 0; tries < 4; tries++) {
+        size_t len = 0, got = 0;
+        if (splinter_get(key, NULL, 0, &len) != 0 || len == 0) {
+            return "";
+        }
+        buf.resize(len);
+        if (splinter_get(key, buf.data(), buf.size(), &got) == 0) {
+            return got ? std::string(buf.data(), got) : "";
+        }
+        if (errno != EMSGSIZE && errno != EAGAIN) break;
     }
-    return std::string(buf.data(), got);
+    return "";
 }
 
 // Build the templated prompt. system_msg is optional — when empty, this is a
@@ -224,8 +229,10 @@ static uint64_t process_completion(
         size_t   warm_len = 0;
         uint64_t warm_ep  = 0;
         const void *warm = splinter_get_raw_ptr(key, &warm_len, &warm_ep);
-        splinter_madvise(SHARD_ID, (void *)warm, warm_len,
-                         POSIX_MADV_WILLNEED, /*timeout*/0);
+        // A chained prompt has no single range to warm.
+        if (warm)
+            splinter_madvise(SHARD_ID, (void *)warm, warm_len,
+                             POSIX_MADV_WILLNEED, /*timeout*/0);
     }
 
     // --- Label transition: waiting -> servicing ---
@@ -292,10 +299,12 @@ static uint64_t process_completion(
         return 0;
     }
 
-    // Get slot geometry so we know when to stop appending
+    // Get slot geometry so we know when to stop appending; a store that
+    // chains values lets the completion run on past max_val_sz.
     splinter_header_snapshot_t hdr = {};
     splinter_get_header_snapshot(&hdr);
-    const size_t max_val = hdr.max_val_sz;
+    const size_t max_val = (splinter_get_chaining() == 1 && hdr.chain_max > hdr.max_val_sz)
+                         ? (size_t)hdr.chain_max : hdr.max_val_sz;
 
     std::string   chunk_buf;       // accumulates pieces until flush
     size_t        written   = prompt.size(); // bytes already in the slot
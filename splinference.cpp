@@ -63,10 +63,11 @@ static bool vector_training = false;
 // completer always preempts it) and SEQUENTIAL during the backfill sweep.
 // Its bid is non-blocking — it never fights a higher-priority WILLNEED holder.
 #define SHARD_ID           0x5F10u   // "SP-embed"
-// Declared windows in splinter_now() ticks. Re-bid frequently, so the window
-// only needs to outlast one loop iteration; backfill gets a much longer window.
-#define SHARD_DUR_LIVE     (1ULL << 30)
-#define SHARD_DUR_BACKFILL (1ULL << 36)
+// Declared windows in real time, converted to splinter_now() ticks for this
+// host. Re-bid frequently, so the window only needs to outlast one loop
+// iteration; backfill gets a much longer window.
+#define SHARD_DUR_LIVE     splinter_ns_to_ticks(350ULL * 1000000ULL)     // 350 ms
+#define SHARD_DUR_BACKFILL splinter_ns_to_ticks(20ULL * 1000000000ULL)   // 20 s
 #define SHARD_PRIO_LIVE     40        // below the completer (200)
 #define SHARD_PRIO_BACKFILL 20        // below live
 
@@ -302,11 +303,14 @@ void perform_backfill(llama_context* ctx, const llama_vocab* vocab) {
 
     size_t embedded = 0, failed = 0;
     for (size_t i = 0; i < key_count; ++i) {
+        // Type first; only VARTEXT keys are worth copying the vector for.
         splinter_slot_snapshot_t snap = {};
-        if (splinter_get_slot_snapshot(keys[i], &snap) != 0) continue;
+        if (splinter_get_slot_snapshot_ex(keys[i], &snap, SPL_SNAP_TYPE) != 0) continue;
+        if (!(snap.type_flag & SPL_SLOT_TYPE_VARTEXT)) continue;
+        if (splinter_get_slot_snapshot_ex(keys[i], &snap, SPL_SNAP_EMBEDDING) != 0) continue;
 
-        // only process if it's explicitly VARTEXT and hasn't been embedded yet
-        if ((snap.type_flag & SPL_SLOT_TYPE_VARTEXT) && needs_embedding(snap.embedding, SPLINTER_EMBED_DIM)) {
+        // only process if it hasn't been embedded yet
+        if (needs_embedding(snap.embedding, SPLINTER_EMBED_DIM)) {
             std::cout << "Backfilling: " << keys[i] << "..." << std::flush;
             // process_key() returns 0 on any failure/skip (no embedding produced,
             // epoch raced, decode failed). Report the real outcome rather than
@@ -470,7 +474,8 @@ int main(int argc, char **argv) {
             std::cout << "[Startup]: Checking key: `" << keys[i] << "` ...\n" << std::flush;
 
             splinter_slot_snapshot_t snap = {};
-            if (splinter_get_slot_snapshot(keys[i], &snap) != 0) continue;
+            // Epoch and vector are all we need; skip the key and metadata copy.
+            if (splinter_get_slot_snapshot_ex(keys[i], &snap, SPL_SNAP_EMBEDDING) != 0) continue;
             if (snap.epoch == 0) continue;
 
             // Only baseline keys that already carry a vector. A key that still
@@ -533,7 +538,9 @@ int main(int argc, char **argv) {
                 auto duration = std::chrono::system_clock::now().time_since_epoch();
                 uint64_t unix_timestamp = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
                 int64_t tick_end = splinter_now();
-                size_t processing_delta = static_cast<size_t>(tick_end - tick_start);
+                // ctime is in seconds, so the backdate must be too.
+                size_t processing_delta = static_cast<size_t>(
+                    splinter_ticks_to_ns(static_cast<uint64_t>(tick_end) - tick_start) / 1000000000ULL);
                 splinter_set_slot_time(keys[i], SPL_TIME_CTIME, unix_timestamp, processing_delta);
                 processed_epochs[key_str] = observed_epoch;  // post-write epoch from process_key (slot's current even epoch)
                 // The vector is now committed (process_key confirmed the +2 epoch),
@@ -0,0 +1,1384 @@
+/**
+ * Splinter benchmarks.
+ *
+ * create: time splinter_create_ex() and the first write on a fresh store,
+ * with the page faults each one takes. Creation should cost the same no
+ * matter how many slots the store has: the mapping is zero-filled, and
+ * nothing touches a slot until a key lands in it.
+ *
+ * run: drive a fresh store with a weighted mix of operations from N threads
+ * and report throughput and latency percentiles per operation, as text,
+ * JSON or CSV. The named workloads a..f follow YCSB's core workloads:
+ *
+ *   a  50% read, 50% update                    zipfian
+ *   b  95% read,  5% update                    zipfian
+ *   c  100% read                               zipfian
+ *   d  95% read,  5% insert                    latest
+ *   e  95% scan,  5% insert                    zipfian (key index on)
+ *   f  50% read, 50% read-modify-write (incr)  zipfian
+ *
+ * --mix overrides the weights (and adds append and label, which YCSB has
+ * no analogue for); --dist overrides the key distribution. Counters for
+ * incr live under their own keys ("c%08lu"), typed BIGUINT.
+ *
+ * With --processes P, the store is loaded and then P children are forked;
+ * each closes the inherited mapping, attaches with splinter_open() and runs
+ * --threads workers. The run's control block (phase, insert counter) is a
+ * value in the store, and each child publishes its histograms back into the
+ * store ("__bench.res.<proc>.<op>") for the parent to merge, so everything
+ * the workers share crosses the same mapping production processes use.
+ *
+ * wake: how long a consumer in another process takes to notice a write.
+ * The writer stamps splinter_now() into a key; the consumer, parked in one
+ * notification mechanism, stamps the wake and records the difference:
+ *
+ *   signal  spin on splinter_get_signal_count() for the key's watch group
+ *   poll    splinter_poll() on the key
+ *   bus     splinter_event_bus_wait() on an fd from splinter_event_bus_open()
+ *
+ * --gap-us is how long the writer waits after the consumer arms, so that
+ * it is really asleep when the write lands. A round the consumer does not
+ * see within a second counts as missed.
+ *
+ * perf: the regression gate (ctest -L perf). Runs a fixed set of short,
+ * seeded, core-pinned cases with a warm-up and compares each case's ops/s
+ * and worst p99 against a baseline JSON; any case slower than --tolerance
+ * (or whose p99 grew past --p99-tolerance) fails the run. --update writes
+ * the baseline from this host instead. Baselines are per-host: refresh the
+ * checked-in one from the machine that runs the gate.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "splinter.h"
+#include "config.h"
+
+enum bench_op {
+    BOP_READ,
+    BOP_UPDATE,
+    BOP_INSERT,
+    BOP_SCAN,
+    BOP_APPEND,
+    BOP_INCR,
+    BOP_LABEL,
+    BOP_COUNT
+};
+
+static const char *const bop_names[BOP_COUNT] = {
+    "read", "update", "insert", "scan", "append", "incr", "label"
+};
+
+enum bench_dist { DIST_UNIFORM, DIST_ZIPF, DIST_LATEST };
+static const char *const dist_names[] = { "uniform", "zipf", "latest" };
+
+enum bench_format { FMT_TEXT, FMT_JSON, FMT_CSV };
+
+typedef struct {
+    const char *name;
+    unsigned mix[BOP_COUNT];
+    int dist;
+} workload_t;
+
+static const workload_t workloads[] = {
+    { "a", { [BOP_READ] = 50, [BOP_UPDATE] = 50 }, DIST_ZIPF },
+    { "b", { [BOP_READ] = 95, [BOP_UPDATE] = 5 },  DIST_ZIPF },
+    { "c", { [BOP_READ] = 100 },                   DIST_ZIPF },
+    { "d", { [BOP_READ] = 95, [BOP_INSERT] = 5 },  DIST_LATEST },
+    { "e", { [BOP_SCAN] = 95, [BOP_INSERT] = 5 },  DIST_ZIPF },
+    { "f", { [BOP_READ] = 50, [BOP_INCR] = 50 },   DIST_ZIPF },
+};
+
+typedef struct {
+    const char *store_name;
+    long slots;
+    long max_value_size;
+    long arena_mb;
+    int runs;
+    /* run */
+    const char *workload;
+    unsigned mix[BOP_COUNT];
+    int dist;
+    double theta;
+    long keys;
+    long value_min, value_max;
+    int scan_len;
+    int threads;
+    int processes;
+    long duration_ms;
+    long warmup_ms;
+    unsigned long long seed;
+    int format;
+    int pin;
+} cfg_t;
+
+/* One op's results; also the value a child publishes per op. Ticks. */
+typedef struct {
+    uint64_t ops;
+    uint64_t errors;
+    uint64_t retries;
+    uint64_t max;
+    uint64_t hist[SPLINTER_LAT_BUCKETS];
+} bench_op_result_t;
+
+/* Per-thread results; merged once the run stops. */
+typedef struct {
+    bench_op_result_t op[BOP_COUNT];
+} bench_result_t;
+
+#define BENCH_CTL_KEY "__bench.ctl"
+
+/* Shared by every worker, in every process: lives in the store. */
+typedef struct {
+    _Atomic uint64_t phase;     /* 0 warm-up, 1 measuring, 2 stop */
+    _Atomic uint64_t next_key;  /* keys 0..next_key-1 exist */
+    _Atomic uint64_t ready;     /* child processes attached */
+} bench_ctl_t;
+
+/* Gray et al.'s zipfian generator, as used by YCSB. */
+typedef struct {
+    uint64_t n;
+    double theta, alpha, zetan, eta, half_pow_theta;
+} zipf_t;
+
+typedef struct {
+    const cfg_t *cfg;
+    zipf_t zipf;
+    unsigned cum[BOP_COUNT];    /* cumulative mix weights */
+    unsigned total;
+    bench_ctl_t *ctl;
+} run_state_t;
+
+typedef struct {
+    run_state_t *rs;
+    unsigned id;
+    uint64_t rng;
+    bench_result_t res;
+} worker_t;
+
+static inline double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static inline long minor_faults(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt;
+}
+
+static void store_path(const char *name, char *path, size_t len) {
+#ifndef SPLINTER_PERSISTENT
+    snprintf(path, len, "/dev/shm/%s", name);
+#else
+    snprintf(path, len, "./%s", name);
+#endif /* SPLINTER_PERSISTENT */
+}
+
+static int bench_create(cfg_t *cfg) {
+    char path[128];
+    double best = 0, total = 0;
+    int i;
+
+    store_path(cfg->store_name, path, sizeof(path));
+    puts("===== CREATE BENCHMARK =====");
+    printf("Slots    : %ld\nMax Val  : %ld bytes\nArena    : %ld MB%s\nRuns     : %d\n\n",
+           cfg->slots, cfg->max_value_size, cfg->arena_mb,
+           cfg->arena_mb ? "" : " (slots x max value)", cfg->runs);
+    puts("run   create_us   create_faults   first_set_us   first_set_faults");
+
+    for (i = 0; i < cfg->runs; i++) {
+        unlink(path);
+        long f0 = minor_faults();
+        double t0 = now_us();
+        if (splinter_create_ex(cfg->store_name, (size_t)cfg->slots, (size_t)cfg->max_value_size,
+                               (size_t)cfg->arena_mb << 20) != 0) {
+            perror("splinter_create_ex");
+            return 1;
+        }
+        double t1 = now_us();
+        long f1 = minor_faults();
+        if (splinter_set("bench", "first", 5) != 0) {
+            perror("splinter_set");
+            splinter_close();
+            unlink(path);
+            return 1;
+        }
+        double t2 = now_us();
+        long f2 = minor_faults();
+        splinter_close();
+        unlink(path);
+
+        double us = t1 - t0;
+        total += us;
+        if (i == 0 || us < best) best = us;
+        printf("%3d   %9.1f   %13ld   %12.1f   %16ld\n", i, us, f1 - f0, t2 - t1, f2 - f1);
+    }
+    printf("\nCreate   : best %.1f us, mean %.1f us\n", best, total / cfg->runs);
+    return 0;
+}
+
+static inline uint64_t xorshift64(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+static inline double rand_unit(uint64_t *s) {
+    return (double)(xorshift64(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline uint64_t fnv64(uint64_t v) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (int i = 0; i < 8; i++) {
+        h ^= v & 0xff;
+        h *= 0x100000001b3ull;
+        v >>= 8;
+    }
+    return h;
+}
+
+static void zipf_init(zipf_t *z, uint64_t n, double theta) {
+    double zeta2 = 1.0 + pow(0.5, theta);
+    z->n = n;
+    z->theta = theta;
+    z->zetan = 0;
+    for (uint64_t i = 1; i <= n; i++) z->zetan += 1.0 / pow((double)i, theta);
+    z->alpha = 1.0 / (1.0 - theta);
+    z->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / z->zetan);
+    z->half_pow_theta = 1.0 + pow(0.5, theta);
+}
+
+/* Rank 0 is the most popular item. */
+static inline uint64_t zipf_next(const zipf_t *z, uint64_t *rng) {
+    double u = rand_unit(rng);
+    double uz = u * z->zetan;
+    if (uz < 1.0) return 0;
+    if (uz < z->half_pow_theta) return 1;
+    uint64_t r = (uint64_t)((double)z->n * pow(z->eta * u - z->eta + 1.0, z->alpha));
+    return r < z->n ? r : z->n - 1;
+}
+
+static inline unsigned lat_bucket(uint64_t v) {
+    const unsigned k = SPLINTER_LAT_SUB_BITS;
+    if (v < (2ull << k)) return (unsigned)v;
+    unsigned e = 63u - (unsigned)__builtin_clzll(v);
+    unsigned b = (e - k) * (1u << k) + (unsigned)(v >> (e - k));
+    return b < SPLINTER_LAT_BUCKETS ? b : SPLINTER_LAT_BUCKETS - 1;
+}
+
+static uint64_t lat_bucket_top(unsigned b) {
+    const unsigned k = SPLINTER_LAT_SUB_BITS;
+    if (b < (2u << k)) return b;
+    unsigned shift = b / (1u << k) - 1;
+    uint64_t m = (b % (1u << k)) + (1u << k);
+    return ((m + 1) << shift) - 1;
+}
+
+/* Percentile q of one op's histogram, in nanoseconds (clamped to max). */
+static uint64_t lat_pct_ns(const bench_op_result_t *r, double q) {
+    uint64_t want, seen = 0;
+    if (!r->ops) return 0;
+    want = (uint64_t)ceil(q * (double)r->ops);
+    if (want < 1) want = 1;
+    for (unsigned b = 0; b < SPLINTER_LAT_BUCKETS; b++) {
+        seen += r->hist[b];
+        if (seen >= want) {
+            uint64_t top = lat_bucket_top(b);
+            return splinter_ticks_to_ns(top < r->max ? top : r->max);
+        }
+    }
+    return splinter_ticks_to_ns(r->max);
+}
+
+static inline void key_name(char *buf, size_t len, char prefix, uint64_t k) {
+    snprintf(buf, len, "%c%08llu", prefix, (unsigned long long)k);
+}
+
+/* Pick an existing key under the configured distribution. */
+static uint64_t pick_key(worker_t *w) {
+    run_state_t *rs = w->rs;
+    uint64_t live = atomic_load_explicit(&rs->ctl->next_key, memory_order_relaxed);
+    uint64_t r, inflight;
+
+    switch (rs->cfg->dist) {
+    case DIST_UNIFORM:
+        return xorshift64(&w->rng) % live;
+    case DIST_LATEST:
+        /* skip the newest few: their inserts may still be in flight */
+        inflight = (uint64_t)rs->cfg->threads * (uint64_t)rs->cfg->processes;
+        if (live > (uint64_t)rs->cfg->keys + inflight)
+            live -= inflight;
+        r = zipf_next(&rs->zipf, &w->rng);
+        return r < live ? live - 1 - r : 0;
+    default:
+        /* scrambled, so the hot keys are not neighbours in the hash table */
+        return fnv64(zipf_next(&rs->zipf, &w->rng)) % (uint64_t)rs->cfg->keys;
+    }
+}
+
+static size_t pick_value_size(worker_t *w) {
+    const cfg_t *cfg = w->rs->cfg;
+    if (cfg->value_max <= cfg->value_min) return (size_t)cfg->value_min;
+    return (size_t)(cfg->value_min +
+                    (long)(xorshift64(&w->rng) % (uint64_t)(cfg->value_max - cfg->value_min + 1)));
+}
+
+static void scan_cb(const char *key, uint64_t epoch, void *data) {
+    (void)key;
+    (void)epoch;
+    (*(unsigned *)data)++;
+}
+
+/*
+ * One operation; 0 on success. EAGAIN is retried and counted separately;
+ * anything else (a read of a key whose insert is still in flight, a full
+ * store) counts as an error.
+ */
+static int do_op(worker_t *w, int op, char *val, char *buf, uint64_t *retries) {
+    const cfg_t *cfg = w->rs->cfg;
+    char key[SPLINTER_KEY_MAX], hi[SPLINTER_KEY_MAX];
+    uint64_t k, one = 1;
+    size_t got = 0;
+    unsigned seen = 0;
+    int rc;
+
+    switch (op) {
+    case BOP_INSERT:
+        k = atomic_fetch_add_explicit(&w->rs->ctl->next_key, 1, memory_order_relaxed);
+        key_name(key, sizeof(key), 'k', k);
+        break;
+    case BOP_INCR:
+        key_name(key, sizeof(key), 'c', pick_key(w) % (uint64_t)cfg->keys);
+        break;
+    default:
+        key_name(key, sizeof(key), 'k', pick_key(w));
+        break;
+    }
+
+    for (;;) {
+        errno = 0;  /* a miss returns -1 without setting errno */
+        switch (op) {
+        case BOP_READ:
+            rc = splinter_get(key, buf, (size_t)cfg->max_value_size, &got);
+            break;
+        case BOP_UPDATE:
+        case BOP_INSERT:
+            rc = splinter_set(key, val, pick_value_size(w));
+            break;
+        case BOP_SCAN:
+            k = strtoull(key + 1, NULL, 10);
+            key_name(hi, sizeof(hi), 'k', k + 1 + xorshift64(&w->rng) % (uint64_t)cfg->scan_len);
+            rc = splinter_scan_range(key, hi, scan_cb, &seen) < 0 ? -1 : 0;
+            break;
+        case BOP_APPEND:
+            rc = splinter_append(key, val, 32, NULL);
+            if (rc < 0 && errno == EMSGSIZE)
+                rc = splinter_set(key, val, pick_value_size(w));
+            break;
+        case BOP_INCR:
+            rc = splinter_integer_op(key, SPL_OP_INC, &one);
+            break;
+        default:
+            rc = splinter_set_label(key, 1ull << (xorshift64(&w->rng) & 63));
+            break;
+        }
+        if (rc == 0 || errno != EAGAIN) return rc;
+        (*retries)++;
+    }
+}
+
+/* Pin the calling thread to the n-th CPU it is allowed to run on. */
+static void pin_self(unsigned n) {
+    cpu_set_t allowed, one;
+    int cpu, count;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    count = CPU_COUNT(&allowed);
+    if (count < 1) return;
+    n %= (unsigned)count;
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed) || n--) continue;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+        return;
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    run_state_t *rs = w->rs;
+    const cfg_t *cfg = rs->cfg;
+    char *val = malloc((size_t)cfg->max_value_size);
+    char *buf = malloc((size_t)cfg->max_value_size);
+    int phase;
+
+    if (!val || !buf) {
+        free(val);
+        free(buf);
+        return NULL;
+    }
+    memset(val, 'a' + (int)(w->id % 26), (size_t)cfg->max_value_size);
+    if (cfg->pin) pin_self(w->id);
+
+    while ((phase = (int)atomic_load_explicit(&rs->ctl->phase, memory_order_relaxed)) < 2) {
+        unsigned pick = (unsigned)(xorshift64(&w->rng) % rs->total);
+        uint64_t retries = 0;
+        int op = 0;
+        while (pick >= rs->cum[op]) op++;
+
+        uint64_t t0 = splinter_now();
+        int rc = do_op(w, op, val, buf, &retries);
+        uint64_t d = splinter_now() - t0;
+
+        if (phase != 1) continue;
+        bench_op_result_t *r = &w->res.op[op];
+        r->retries += retries;
+        if (rc != 0) {
+            r->errors++;
+            continue;
+        }
+        r->ops++;
+        r->hist[lat_bucket(d)]++;
+        if (d > r->max) r->max = d;
+    }
+    free(val);
+    free(buf);
+    return NULL;
+}
+
+static void merge_op_result(bench_op_result_t *dst, const bench_op_result_t *src) {
+    dst->ops += src->ops;
+    dst->errors += src->errors;
+    dst->retries += src->retries;
+    if (src->max > dst->max) dst->max = src->max;
+    for (unsigned b = 0; b < SPLINTER_LAT_BUCKETS; b++)
+        dst->hist[b] += src->hist[b];
+}
+
+/* Start the threads of one process; returns how many started. */
+static int start_workers(run_state_t *rs, worker_t *w, pthread_t *tids, unsigned base) {
+    const cfg_t *cfg = rs->cfg;
+    int i;
+
+    for (i = 0; i < cfg->threads; i++) {
+        w[i].rs = rs;
+        w[i].id = base + (unsigned)i;
+        w[i].rng = cfg->seed + 0x9e3779b97f4a7c15ull * (uint64_t)(w[i].id + 1);
+        if (!w[i].rng) w[i].rng = 1;
+        if (pthread_create(&tids[i], NULL, worker_main, &w[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+    }
+    return i;
+}
+
+static void join_workers(worker_t *w, pthread_t *tids, int started, bench_result_t *out) {
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+        for (int op = 0; op < BOP_COUNT; op++) merge_op_result(&out->op[op], &w[i].res.op[op]);
+    }
+}
+
+/* The control block is written in place through its raw pointer. */
+static bench_ctl_t *ctl_attach(void) {
+    return (bench_ctl_t *)(uintptr_t)splinter_get_raw_ptr(BENCH_CTL_KEY, NULL, NULL);
+}
+
+static void result_key(char *buf, size_t len, int proc, int op) {
+    snprintf(buf, len, "__bench.res.%d.%s", proc, bop_names[op]);
+}
+
+/* Body of a forked worker process; never returns. */
+static void child_main(run_state_t *rs, int proc) {
+    const cfg_t *cfg = rs->cfg;
+    worker_t *w = calloc((size_t)cfg->threads, sizeof(*w));
+    pthread_t *tids = calloc((size_t)cfg->threads, sizeof(*tids));
+    bench_result_t *res = calloc(1, sizeof(*res));
+    char key[SPLINTER_KEY_MAX];
+    int started, op;
+
+    /* drop the parent's mapping and attach the way an unrelated process would */
+    splinter_close();
+    if (!w || !tids || !res || splinter_open(cfg->store_name) != 0 || !(rs->ctl = ctl_attach()))
+        _exit(1);
+    atomic_fetch_add(&rs->ctl->ready, 1);
+
+    started = start_workers(rs, w, tids, (unsigned)(proc * cfg->threads));
+    join_workers(w, tids, started, res);
+    if (started != cfg->threads) _exit(1);
+
+    for (op = 0; op < BOP_COUNT; op++) {
+        if (!cfg->mix[op]) continue;
+        result_key(key, sizeof(key), proc, op);
+        if (splinter_set(key, &res->op[op], sizeof(res->op[op])) != 0) _exit(1);
+    }
+    splinter_close();
+    _exit(0);
+}
+
+/* Populate keys 0..keys-1 (and the incr counters, if the mix uses them). */
+static int load_keys(const cfg_t *cfg) {
+    char key[SPLINTER_KEY_MAX];
+    char *val = malloc((size_t)cfg->max_value_size);
+    uint64_t rng = cfg->seed, zero = 0;
+
+    if (!val) return -1;
+    memset(val, 'x', (size_t)cfg->max_value_size);
+    for (long k = 0; k < cfg->keys; k++) {
+        size_t len = (size_t)cfg->value_min;
+        if (cfg->value_max > cfg->value_min)
+            len += xorshift64(&rng) % (uint64_t)(cfg->value_max - cfg->value_min + 1);
+        key_name(key, sizeof(key), 'k', (uint64_t)k);
+        if (splinter_set(key, val, len) != 0) {
+            perror("splinter_set");
+            free(val);
+            return -1;
+        }
+        if (!cfg->mix[BOP_INCR]) continue;
+        key_name(key, sizeof(key), 'c', (uint64_t)k);
+        if (splinter_set(key, &zero, sizeof(zero)) != 0 ||
+            splinter_set_named_type(key, SPL_SLOT_TYPE_BIGUINT) != 0) {
+            perror("splinter_set");
+            free(val);
+            return -1;
+        }
+    }
+    free(val);
+    return 0;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+
+static void report(const cfg_t *cfg, const bench_result_t *res, double secs, double load_ms) {
+    static const double q[4] = { 0.50, 0.90, 0.99, 0.999 };
+    const bench_op_result_t *r;
+    uint64_t all = 0, errs = 0, retries = 0;
+    char mix[128] = { 0 };
+    size_t off = 0;
+    int op, first = 1;
+
+    for (op = 0; op < BOP_COUNT; op++) {
+        all += res->op[op].ops;
+        errs += res->op[op].errors;
+        retries += res->op[op].retries;
+        if (cfg->mix[op] && off < sizeof(mix))
+            off += (size_t)snprintf(mix + off, sizeof(mix) - off, "%s%s=%u",
+                                    off ? "," : "", bop_names[op], cfg->mix[op]);
+    }
+
+    if (cfg->format == FMT_JSON) {
+        printf("{\"workload\":\"%s\",\"mix\":\"%s\",\"dist\":\"%s\",\"theta\":%.2f,"
+               "\"keys\":%ld,\"value_min\":%ld,\"value_max\":%ld,\"processes\":%d,\"threads\":%d,"
+               "\"duration_s\":%.3f,\"load_ms\":%.1f,\"ops\":%llu,\"errors\":%llu,"
+               "\"retries\":%llu,\"ops_per_sec\":%.0f,\"tick_hz\":%llu,\"results\":[",
+               cfg->workload, mix, dist_names[cfg->dist], cfg->theta, cfg->keys,
+               cfg->value_min, cfg->value_max, cfg->processes, cfg->threads, secs, load_ms,
+               (unsigned long long)all, (unsigned long long)errs,
+               (unsigned long long)retries, all / secs,
+               (unsigned long long)splinter_tick_hz());
+        for (op = 0; op < BOP_COUNT; op++) {
+            if (!cfg->mix[op]) continue;
+            r = &res->op[op];
+            printf("%s{\"op\":\"%s\",\"ops\":%llu,\"errors\":%llu,\"ops_per_sec\":%.0f,"
+                   "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,"
+                   "\"retries\":%llu,\"max_ns\":%llu}",
+                   first ? "" : ",", bop_names[op], (unsigned long long)r->ops,
+                   (unsigned long long)r->errors, r->ops / secs,
+                   (unsigned long long)lat_pct_ns(r, q[0]),
+                   (unsigned long long)lat_pct_ns(r, q[1]),
+                   (unsigned long long)lat_pct_ns(r, q[2]),
+                   (unsigned long long)lat_pct_ns(r, q[3]),
+                   (unsigned long long)r->retries,
+                   (unsigned long long)splinter_ticks_to_ns(r->max));
+            first = 0;
+        }
+        puts("]}");
+        return;
+    }
+
+    if (cfg->format == FMT_CSV) {
+        puts("workload,dist,processes,threads,keys,op,ops,errors,retries,ops_per_sec,"
+             "p50_ns,p90_ns,p99_ns,p999_ns,max_ns");
+        for (op = 0; op < BOP_COUNT; op++) {
+            if (!cfg->mix[op]) continue;
+            r = &res->op[op];
+            printf("%s,%s,%d,%d,%ld,%s,%llu,%llu,%llu,%.0f,%llu,%llu,%llu,%llu,%llu\n",
+                   cfg->workload, dist_names[cfg->dist], cfg->processes, cfg->threads, cfg->keys,
+                   bop_names[op], (unsigned long long)r->ops, (unsigned long long)r->errors,
+                   (unsigned long long)r->retries, r->ops / secs,
+                   (unsigned long long)lat_pct_ns(r, q[0]),
+                   (unsigned long long)lat_pct_ns(r, q[1]),
+                   (unsigned long long)lat_pct_ns(r, q[2]),
+                   (unsigned long long)lat_pct_ns(r, q[3]),
+                   (unsigned long long)splinter_ticks_to_ns(r->max));
+        }
+        return;
+    }
+
+    puts("===== RUN BENCHMARK =====");
+    printf("Workload : %s (%s)\nKeys     : %ld (%s", cfg->workload, mix, cfg->keys,
+           dist_names[cfg->dist]);
+    if (cfg->dist != DIST_UNIFORM) printf(", theta %.2f", cfg->theta);
+    printf(")\nValues   : %ld-%ld bytes\nWorkers  : %d process%s x %d thread%s\n"
+           "Load     : %.1f ms\nDuration : %.3f s\n\n", cfg->value_min, cfg->value_max,
+           cfg->processes, cfg->processes == 1 ? "" : "es", cfg->threads,
+           cfg->threads == 1 ? "" : "s", load_ms, secs);
+    puts("op        ops/sec      errors     p50_ns     p90_ns     p99_ns    p999_ns     max_ns");
+    for (op = 0; op < BOP_COUNT; op++) {
+        if (!cfg->mix[op]) continue;
+        r = &res->op[op];
+        printf("%-8s %10.0f  %10llu %10llu %10llu %10llu %10llu %10llu\n",
+               bop_names[op], r->ops / secs, (unsigned long long)r->errors,
+               (unsigned long long)lat_pct_ns(r, q[0]),
+               (unsigned long long)lat_pct_ns(r, q[1]),
+               (unsigned long long)lat_pct_ns(r, q[2]),
+               (unsigned long long)lat_pct_ns(r, q[3]),
+               (unsigned long long)splinter_ticks_to_ns(r->max));
+    }
+    printf("\nTotal    : %.0f ops/sec, %llu errors, %llu EAGAIN retries\n",
+           all / secs, (unsigned long long)errs, (unsigned long long)retries);
+}
+
+/* Warm up, then open and close the measured window; returns its length in s. */
+static double drive(run_state_t *rs) {
+    const cfg_t *cfg = rs->cfg;
+    if (cfg->warmup_ms) sleep_ms(cfg->warmup_ms);
+    double t0 = now_us();
+    atomic_store(&rs->ctl->phase, 1);
+    sleep_ms(cfg->duration_ms);
+    atomic_store(&rs->ctl->phase, 2);
+    return (now_us() - t0) / 1e6;
+}
+
+/* --processes 1: every worker is a thread of this process. */
+static int run_threads(run_state_t *rs, bench_result_t *total, double *secs) {
+    const cfg_t *cfg = rs->cfg;
+    worker_t *w = calloc((size_t)cfg->threads, sizeof(*w));
+    pthread_t *tids = calloc((size_t)cfg->threads, sizeof(*tids));
+    int started = 0, rc = -1;
+
+    if (!w || !tids) {
+        perror("calloc");
+        goto out;
+    }
+    started = start_workers(rs, w, tids, 0);
+    if (started == cfg->threads) {
+        *secs = drive(rs);
+        rc = 0;
+    } else {
+        atomic_store(&rs->ctl->phase, 2);
+    }
+    join_workers(w, tids, started, total);
+out:
+    free(tids);
+    free(w);
+    return rc;
+}
+
+/* --processes P: fork P children, then merge what they publish. */
+static int run_processes(run_state_t *rs, bench_result_t *total, double *secs) {
+    const cfg_t *cfg = rs->cfg;
+    bench_op_result_t *opr = malloc(sizeof(*opr));
+    char key[SPLINTER_KEY_MAX];
+    pid_t *pids = calloc((size_t)cfg->processes, sizeof(*pids));
+    int p, op, status, spawned = 0, failed = 0;
+    size_t got;
+
+    if (!opr || !pids) {
+        perror("calloc");
+        free(opr);
+        free(pids);
+        return -1;
+    }
+    fflush(NULL);
+    for (p = 0; p < cfg->processes; p++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            failed = 1;
+            break;
+        }
+        if (pid == 0) child_main(rs, p);
+        pids[spawned++] = pid;
+    }
+
+    /* wait for every child to attach, or for one to die trying */
+    while (!failed && atomic_load(&rs->ctl->ready) < (uint64_t)cfg->processes) {
+        for (p = 0; p < spawned; p++) {
+            if (pids[p] && waitpid(pids[p], &status, WNOHANG) == pids[p]) {
+                pids[p] = 0;
+                failed = 1;
+            }
+        }
+        sleep_ms(1);
+    }
+    if (!failed)
+        *secs = drive(rs);
+    else
+        atomic_store(&rs->ctl->phase, 2);
+
+    for (p = 0; p < spawned; p++) {
+        if (!pids[p]) continue;
+        if (waitpid(pids[p], &status, 0) != pids[p] || !WIFEXITED(status) || WEXITSTATUS(status))
+            failed = 1;
+    }
+    if (failed) {
+        fprintf(stderr, "a worker process failed\n");
+    } else {
+        for (p = 0; p < cfg->processes && !failed; p++) {
+            for (op = 0; op < BOP_COUNT; op++) {
+                if (!cfg->mix[op]) continue;
+                result_key(key, sizeof(key), p, op);
+                if (splinter_get(key, opr, sizeof(*opr), &got) != 0 || got != sizeof(*opr)) {
+                    fprintf(stderr, "missing results from worker process %d\n", p);
+                    failed = 1;
+                    break;
+                }
+                merge_op_result(&total->op[op], opr);
+            }
+        }
+    }
+    free(pids);
+    free(opr);
+    return failed ? -1 : 0;
+}
+
+/* Create and load a store, run the workers, merge their results into total. */
+static int bench_measure(const cfg_t *cfg, bench_result_t *total, double *secs, double *load_ms) {
+    char path[128];
+    run_state_t *rs;
+    bench_ctl_t ctl = { 0 };
+    int i, rc = 1;
+
+    store_path(cfg->store_name, path, sizeof(path));
+    unlink(path);
+    if (splinter_create_ex(cfg->store_name, (size_t)cfg->slots, (size_t)cfg->max_value_size,
+                           (size_t)cfg->arena_mb << 20) != 0) {
+        perror("splinter_create_ex");
+        return 1;
+    }
+
+    rs = calloc(1, sizeof(*rs));
+    if (!rs) {
+        perror("calloc");
+        goto out;
+    }
+    rs->cfg = cfg;
+    for (i = 0; i < BOP_COUNT; i++) {
+        rs->total += cfg->mix[i];
+        rs->cum[i] = rs->total;
+    }
+    if (cfg->dist != DIST_UNIFORM) zipf_init(&rs->zipf, (uint64_t)cfg->keys, cfg->theta);
+    if (cfg->mix[BOP_SCAN] && splinter_set_key_index(1) < 0) {
+        perror("splinter_set_key_index");
+        goto out;
+    }
+
+    double t0 = now_us();
+    if (load_keys(cfg) != 0) goto out;
+    *load_ms = (now_us() - t0) / 1e3;
+
+    atomic_init(&ctl.next_key, (uint64_t)cfg->keys);
+    if (splinter_set(BENCH_CTL_KEY, &ctl, sizeof(ctl)) != 0 || !(rs->ctl = ctl_attach())) {
+        perror("splinter_set");
+        goto out;
+    }
+
+    if (cfg->processes > 1 ? run_processes(rs, total, secs) : run_threads(rs, total, secs))
+        goto out;
+    rc = 0;
+
+out:
+    free(rs);
+    splinter_close();
+    unlink(path);
+    return rc;
+}
+
+static int bench_run(const cfg_t *cfg) {
+    bench_result_t *total = calloc(1, sizeof(*total));
+    double secs = 0, load_ms = 0;
+    int rc = 1;
+
+    if (!total) {
+        perror("calloc");
+        return 1;
+    }
+    if (bench_measure(cfg, total, &secs, &load_ms) == 0) {
+        report(cfg, total, secs, load_ms);
+        rc = 0;
+    }
+    free(total);
+    return rc;
+}
+
+enum wake_mech { WAKE_SIGNAL, WAKE_POLL, WAKE_BUS, WAKE_MECHS };
+static const char *const wake_names[WAKE_MECHS] = { "signal", "poll", "bus" };
+
+#define WAKE_KEY "__bench.wake"
+#define WAKE_CTL_KEY "__bench.wake.ctl"
+#define WAKE_GROUP 7
+#define WAKE_TIMEOUT_MS 1000
+
+/* What the writer stores in WAKE_KEY each round. */
+typedef struct {
+    uint64_t round;
+    uint64_t stamp;     /* splinter_now() just before the set */
+} wake_ping_t;
+
+/* Handshake between writer and consumer; lives in the store. */
+typedef struct {
+    _Atomic uint64_t armed;     /* last round the consumer is waiting for */
+    _Atomic uint64_t status;    /* 0 running, 1 mechanism unavailable */
+    uint64_t missed;            /* rounds the consumer slept through */
+} wake_ctl_t;
+
+/* Consumer: arm, wait with one mechanism, stamp the wake. Never returns. */
+static void wake_consumer(const cfg_t *cfg, int mech, long rounds) {
+    bench_op_result_t *res = calloc(1, sizeof(*res));
+    char key[SPLINTER_KEY_MAX];
+    wake_ctl_t *ctl;
+    wake_ping_t ping;
+    size_t got;
+    int fd = -1;
+
+    splinter_close();
+    if (!res || splinter_open(cfg->store_name) != 0 ||
+        !(ctl = (wake_ctl_t *)(uintptr_t)splinter_get_raw_ptr(WAKE_CTL_KEY, NULL, NULL)))
+        _exit(1);
+    if (mech == WAKE_BUS && (fd = splinter_event_bus_open()) < 0) {
+        atomic_store(&ctl->status, 1);
+        _exit(0);
+    }
+
+    for (long i = 1; i <= rounds; i++) {
+        uint64_t seen = splinter_get_signal_count(WAKE_GROUP);
+        int rc = -1;
+
+        if (fd >= 0)
+            while (splinter_event_bus_wait(fd, 0) == 0)
+                ;
+        atomic_store(&ctl->armed, (uint64_t)i);
+
+        switch (mech) {
+        case WAKE_SIGNAL: {
+            uint64_t deadline = splinter_now() + splinter_ns_to_ticks(WAKE_TIMEOUT_MS * 1000000ull);
+            while (splinter_get_signal_count(WAKE_GROUP) == seen && splinter_now() < deadline)
+                ;
+            rc = splinter_get_signal_count(WAKE_GROUP) == seen ? -1 : 0;
+            break;
+        }
+        case WAKE_POLL:
+            rc = splinter_poll(WAKE_KEY, WAKE_TIMEOUT_MS);
+            break;
+        default:
+            rc = splinter_event_bus_wait(fd, WAKE_TIMEOUT_MS);
+            break;
+        }
+        uint64_t now = splinter_now();
+
+        if (rc != 0 || splinter_get(WAKE_KEY, &ping, sizeof(ping), &got) != 0 ||
+            got != sizeof(ping) || ping.round != (uint64_t)i) {
+            ctl->missed++;
+            continue;
+        }
+        uint64_t d = now - ping.stamp;
+        res->ops++;
+        res->hist[lat_bucket(d)]++;
+        if (d > res->max) res->max = d;
+    }
+    if (fd >= 0) splinter_event_bus_close(fd);
+
+    snprintf(key, sizeof(key), "__bench.res.wake.%s", wake_names[mech]);
+    if (splinter_set(key, res, sizeof(*res)) != 0) _exit(1);
+    splinter_close();
+    _exit(0);
+}
+
+/* Writer side of one mechanism's ping-pong; fills res. 1 if unavailable. */
+static int wake_one(const cfg_t *cfg, int mech, long rounds, long gap_us,
+                    bench_op_result_t *res, uint64_t *missed) {
+    wake_ctl_t zero = { 0 }, *ctl;
+    wake_ping_t ping = { 0, 0 };
+    char key[SPLINTER_KEY_MAX];
+    size_t got;
+    int status;
+    pid_t pid;
+
+    if (splinter_set(WAKE_CTL_KEY, &zero, sizeof(zero)) != 0 ||
+        !(ctl = (wake_ctl_t *)(uintptr_t)splinter_get_raw_ptr(WAKE_CTL_KEY, NULL, NULL)) ||
+        splinter_set(WAKE_KEY, &ping, sizeof(ping)) != 0) {
+        perror("splinter_set");
+        return -1;
+    }
+
+    fflush(NULL);
+    if ((pid = fork()) < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) wake_consumer(cfg, mech, rounds);
+
+    for (long i = 1; i <= rounds && !atomic_load(&ctl->status); i++) {
+        while (atomic_load(&ctl->armed) < (uint64_t)i && !atomic_load(&ctl->status)) {
+            if (waitpid(pid, &status, WNOHANG) == pid) {
+                fprintf(stderr, "wake consumer exited early\n");
+                return -1;
+            }
+            sched_yield();
+        }
+        /* give the consumer time to actually park in its wait */
+        if (gap_us) {
+            struct timespec ts = { gap_us / 1000000, (gap_us % 1000000) * 1000 };
+            nanosleep(&ts, NULL);
+        }
+        ping.round = (uint64_t)i;
+        ping.stamp = splinter_now();
+        splinter_set(WAKE_KEY, &ping, sizeof(ping));
+    }
+
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status)) {
+        fprintf(stderr, "wake consumer failed\n");
+        return -1;
+    }
+    if (atomic_load(&ctl->status)) return 1;
+    *missed = ctl->missed;
+    snprintf(key, sizeof(key), "__bench.res.wake.%s", wake_names[mech]);
+    if (splinter_get(key, res, sizeof(*res), &got) != 0 || got != sizeof(*res)) {
+        fprintf(stderr, "missing results from wake consumer\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int bench_wake(cfg_t *cfg, unsigned mechs, long rounds, long gap_us) {
+    static const double q[4] = { 0.50, 0.90, 0.99, 0.999 };
+    bench_op_result_t *res = calloc(1, sizeof(*res));
+    char path[128];
+    int m, rc = 1, first = 1;
+
+    store_path(cfg->store_name, path, sizeof(path));
+    unlink(path);
+    if (!res || splinter_create_ex(cfg->store_name, 1024, sizeof(*res), 0) != 0) {
+        perror("splinter_create_ex");
+        free(res);
+        return 1;
+    }
+    /* the writer owns the bus; its sets pulse WAKE_GROUP and the eventfd */
+    if (splinter_set(WAKE_KEY, "", 1) != 0 || splinter_watch_register(WAKE_KEY, WAKE_GROUP) != 0 ||
+        splinter_event_bus_init() != 0) {
+        perror("wake setup");
+        goto out;
+    }
+
+    if (cfg->format == FMT_JSON)
+        printf("{\"rounds\":%ld,\"gap_us\":%ld,\"tick_hz\":%llu,\"results\":[",
+               rounds, gap_us, (unsigned long long)splinter_tick_hz());
+    else if (cfg->format == FMT_CSV)
+        puts("mechanism,rounds,woken,missed,p50_ns,p90_ns,p99_ns,p999_ns,max_ns");
+    else
+        printf("===== WAKE BENCHMARK =====\nRounds   : %ld per mechanism\nGap      : %ld us\n\n"
+               "mech         woken   missed     p50_ns     p90_ns     p99_ns    p999_ns     max_ns\n",
+               rounds, gap_us);
+
+    for (m = 0; m < WAKE_MECHS; m++) {
+        uint64_t missed = 0;
+        int r;
+        if (!(mechs & (1u << m))) continue;
+        memset(res, 0, sizeof(*res));
+        if ((r = wake_one(cfg, m, rounds, gap_us, res, &missed)) < 0) goto out;
+        if (r == 1) {
+            if (cfg->format == FMT_TEXT) printf("%-8s  (unavailable)\n", wake_names[m]);
+            continue;
+        }
+        uint64_t p[4];
+        for (int k = 0; k < 4; k++) p[k] = lat_pct_ns(res, q[k]);
+        if (cfg->format == FMT_JSON) {
+            printf("%s{\"mechanism\":\"%s\",\"woken\":%llu,\"missed\":%llu,\"p50_ns\":%llu,"
+                   "\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}",
+                   first ? "" : ",", wake_names[m], (unsigned long long)res->ops,
+                   (unsigned long long)missed, (unsigned long long)p[0], (unsigned long long)p[1],
+                   (unsigned long long)p[2], (unsigned long long)p[3],
+                   (unsigned long long)splinter_ticks_to_ns(res->max));
+        } else if (cfg->format == FMT_CSV) {
+            printf("%s,%ld,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", wake_names[m], rounds,
+                   (unsigned long long)res->ops, (unsigned long long)missed,
+                   (unsigned long long)p[0], (unsigned long long)p[1], (unsigned long long)p[2],
+                   (unsigned long long)p[3], (unsigned long long)splinter_ticks_to_ns(res->max));
+        } else {
+            printf("%-8s %10llu %8llu %10llu %10llu %10llu %10llu %10llu\n", wake_names[m],
+                   (unsigned long long)res->ops, (unsigned long long)missed,
+                   (unsigned long long)p[0], (unsigned long long)p[1], (unsigned long long)p[2],
+                   (unsigned long long)p[3], (unsigned long long)splinter_ticks_to_ns(res->max));
+        }
+        first = 0;
+    }
+    if (cfg->format == FMT_JSON) puts("]}");
+    rc = 0;
+
+out:
+    free(res);
+    splinter_close();
+    unlink(path);
+    return rc;
+}
+
+/* Set mix and distribution from a named workload; -1 if there is none. */
+static int apply_workload(cfg_t *cfg, const char *name) {
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        if (!strcmp(name, workloads[i].name)) {
+            memcpy(cfg->mix, workloads[i].mix, sizeof(cfg->mix));
+            cfg->dist = workloads[i].dist;
+            cfg->workload = workloads[i].name;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+typedef struct {
+    const char *name;
+    const char *workload;
+    int threads;
+} perf_case_t;
+
+/* Short on purpose: the whole gate should stay well under a minute. */
+static const perf_case_t perf_cases[] = {
+    { "c-read-1t",   "c", 1 },
+    { "b-mostly-2t", "b", 2 },
+    { "a-update-2t", "a", 2 },
+    { "d-insert-1t", "d", 1 },
+    { "f-incr-2t",   "f", 2 },
+};
+
+#define PERF_CASES (sizeof(perf_cases) / sizeof(perf_cases[0]))
+
+typedef struct {
+    double ops_per_sec;
+    double p99_ns;
+    int found;
+} perf_point_t;
+
+/*
+ * Read a baseline written by --update: one {"case":...} object per line.
+ * Returns 0, or -1 if the file cannot be opened.
+ */
+static int perf_load(const char *path, perf_point_t *base) {
+    char line[256], name[64];
+    double ops, p99;
+    FILE *f = fopen(path, "r");
+
+    if (!f) return -1;
+    while (fgets(line, sizeof(line), f)) {
+        const char *obj = strstr(line, "{\"case\":");
+        if (!obj || sscanf(obj, "{\"case\":\"%63[^\"]\",\"ops_per_sec\":%lf,\"p99_ns\":%lf",
+                           name, &ops, &p99) != 3)
+            continue;
+        for (size_t i = 0; i < PERF_CASES; i++) {
+            if (strcmp(name, perf_cases[i].name)) continue;
+            base[i].ops_per_sec = ops;
+            base[i].p99_ns = p99;
+            base[i].found = 1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+static int perf_save(const char *path, const perf_point_t *cur) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "{\"splinter_bench_perf\":1,\"tick_hz\":%llu,\"cases\":[\n",
+            (unsigned long long)splinter_tick_hz());
+    for (size_t i = 0; i < PERF_CASES; i++)
+        fprintf(f, "{\"case\":\"%s\",\"ops_per_sec\":%.0f,\"p99_ns\":%.0f}%s\n", perf_cases[i].name,
+                cur[i].ops_per_sec, cur[i].p99_ns, i + 1 < PERF_CASES ? "," : "");
+    fputs("]}\n", f);
+    return fclose(f);
+}
+
+static int bench_perf(const cfg_t *base_cfg, const char *baseline, double tol, double p99_tol,
+                      int update) {
+    perf_point_t base[PERF_CASES] = { { 0 } }, cur[PERF_CASES] = { { 0 } };
+    bench_result_t *res = malloc(sizeof(*res));
+    int failed = 0;
+
+    if (!res) {
+        perror("malloc");
+        return 1;
+    }
+    if (!update && perf_load(baseline, base) != 0) {
+        fprintf(stderr, "cannot read baseline %s: %s (run with --update to create it)\n",
+                baseline, strerror(errno));
+        free(res);
+        return 1;
+    }
+
+    printf("===== PERF GATE =====\nBaseline : %s%s\nAllowed  : ops/s -%.0f%%, p99 +%.0f%%\n\n",
+           baseline, update ? " (updating)" : "", tol * 100, p99_tol * 100);
+    puts("case              ops/sec    baseline   change      p99_ns    baseline   change");
+
+    for (size_t i = 0; i < PERF_CASES; i++) {
+        cfg_t cfg = *base_cfg;
+        double secs = 0, load_ms = 0;
+        uint64_t all = 0;
+        const char *verdict = "ok";
+
+        apply_workload(&cfg, perf_cases[i].workload);
+        cfg.threads = perf_cases[i].threads;
+        memset(res, 0, sizeof(*res));
+        if (bench_measure(&cfg, res, &secs, &load_ms) != 0) {
+            free(res);
+            return 1;
+        }
+        for (int op = 0; op < BOP_COUNT; op++) {
+            double p99;
+            if (!cfg.mix[op]) continue;
+            all += res->op[op].ops;
+            p99 = (double)lat_pct_ns(&res->op[op], 0.99);
+            if (p99 > cur[i].p99_ns) cur[i].p99_ns = p99;
+        }
+        cur[i].ops_per_sec = all / secs;
+
+        if (update) {
+            verdict = "saved";
+        } else if (!base[i].found) {
+            verdict = "no baseline";
+        } else if (cur[i].ops_per_sec < base[i].ops_per_sec * (1.0 - tol) ||
+                   cur[i].p99_ns > base[i].p99_ns * (1.0 + p99_tol)) {
+            verdict = "FAIL";
+            failed = 1;
+        }
+        printf("%-14s %10.0f  %10.0f  %+6.1f%%  %10.0f  %10.0f  %+6.1f%%   %s\n",
+               perf_cases[i].name, cur[i].ops_per_sec, base[i].ops_per_sec,
+               base[i].found ? (cur[i].ops_per_sec / base[i].ops_per_sec - 1.0) * 100 : 0.0,
+               cur[i].p99_ns, base[i].p99_ns,
+               base[i].found && base[i].p99_ns ? (cur[i].p99_ns / base[i].p99_ns - 1.0) * 100 : 0.0,
+               verdict);
+        fflush(stdout);
+    }
+    free(res);
+
+    if (update && perf_save(baseline, cur) != 0) {
+        perror(baseline);
+        return 1;
+    }
+    if (failed) puts("\nPerformance regressed past the allowed tolerance.");
+    return failed;
+}
+
+/* "read=50,update=50" -> cfg->mix; 0 on success. */
+static int parse_mix(cfg_t *cfg, const char *spec) {
+    char tmp[256], *save = NULL, *tok;
+    unsigned sum = 0;
+
+    snprintf(tmp, sizeof(tmp), "%s", spec);
+    memset(cfg->mix, 0, sizeof(cfg->mix));
+    for (tok = strtok_r(tmp, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        int op;
+        if (!eq) return -1;
+        *eq = '\0';
+        for (op = 0; op < BOP_COUNT && strcmp(tok, bop_names[op]); op++)
+            ;
+        if (op == BOP_COUNT) return -1;
+        cfg->mix[op] = (unsigned)strtoul(eq + 1, NULL, 10);
+        sum += cfg->mix[op];
+    }
+    return sum ? 0 : -1;
+}
+
+static int parse_dist(const char *s) {
+    for (int d = 0; d < 3; d++)
+        if (!strcmp(s, dist_names[d])) return d;
+    return -1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "\nUsage: %s create [arguments]\nWhere arguments are:\n"
+        "\t  [--slots S] [--max-value B] [--arena-mb M] [--runs R] [--store NAME]\n"
+        "\n       %s run [arguments]\nWhere arguments are:\n"
+        "\t  [--workload a|b|c|d|e|f] [--mix op=W,...] [--dist uniform|zipf|latest]\n"
+        "\t  [--theta T] [--keys K] [--value-size N|MIN-MAX] [--scan-len L]\n"
+        "\t  [--threads T] [--processes P] [--pin] [--duration-ms D] [--warmup-ms W] [--seed S]\n"
+        "\t  [--format text|json|csv] [--slots S] [--max-value B] [--arena-mb M] [--store NAME]\n"
+        "\tops: read update insert scan append incr label\n"
+        "\n       %s wake [arguments]\nWhere arguments are:\n"
+        "\t  [--mech signal,poll,bus] [--rounds N] [--gap-us U] [--format text|json|csv]\n"
+        "\t  [--store NAME]\n"
+        "\n       %s perf [arguments]\nWhere arguments are:\n"
+        "\t  [--baseline FILE] [--tolerance F] [--p99-tolerance F] [--update]\n"
+        "\t  [--duration-ms D] [--warmup-ms W] [--keys K] [--store NAME]\n", prog, prog, prog, prog);
+}
+
+int main(int argc, char **argv) {
+    char store[64] = { 0 };
+    const char *mix = NULL, *dist = NULL;
+    unsigned mechs = (1u << WAKE_MECHS) - 1;
+    long rounds = 200, gap_us = 200;
+    const char *baseline = "perf_baseline.json";
+    double tol = 0.25, p99_tol = 1.0;
+    int i, run, wake, perf, update = 0;
+
+    snprintf(store, sizeof(store) - 1, "bench_%u", (unsigned)getpid());
+    cfg_t cfg = {
+        .store_name = store,
+        .slots = 1000000,
+        .max_value_size = 4096,
+        .arena_mb = 0,
+        .runs = 5,
+        .workload = "a",
+        .theta = 0.99,
+        .keys = 100000,
+        .value_min = 100,
+        .value_max = 100,
+        .scan_len = 100,
+        .threads = 4,
+        .processes = 1,
+        .duration_ms = 5000,
+        .warmup_ms = 0,
+        .seed = 0x5eed,
+        .format = FMT_TEXT,
+    };
+
+    if (argc < 2 || (strcmp(argv[1], "create") != 0 && strcmp(argv[1], "run") != 0 &&
+                     strcmp(argv[1], "wake") != 0 && strcmp(argv[1], "perf") != 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+    run = !strcmp(argv[1], "run");
+    wake = !strcmp(argv[1], "wake");
+    perf = !strcmp(argv[1], "perf");
+    if (run || perf) cfg.slots = 0;
+    if (perf) {
+        /* fixed, seeded and pinned so that runs compare */
+        cfg.keys = 50000;
+        cfg.duration_ms = 1000;
+        cfg.warmup_ms = 250;
+        cfg.pin = 1;
+    }
+    for (i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--slots") && i+1 < argc) cfg.slots = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--max-value") && i+1 < argc) cfg.max_value_size = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--arena-mb") && i+1 < argc) cfg.arena_mb = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--runs") && i+1 < argc) cfg.runs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--store") && i+1 < argc) cfg.store_name = argv[++i];
+        else if (wake && !strcmp(argv[i], "--rounds") && i+1 < argc) rounds = atol(argv[++i]);
+        else if (wake && !strcmp(argv[i], "--gap-us") && i+1 < argc) gap_us = atol(argv[++i]);
+        else if (wake && !strcmp(argv[i], "--mech") && i+1 < argc) {
+            char tmp[64], *save = NULL, *tok;
+            snprintf(tmp, sizeof(tmp), "%s", argv[++i]);
+            mechs = 0;
+            for (tok = strtok_r(tmp, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+                int m;
+                for (m = 0; m < WAKE_MECHS && strcmp(tok, wake_names[m]); m++)
+                    ;
+                if (m == WAKE_MECHS) { usage(argv[0]); return 2; }
+                mechs |= 1u << m;
+            }
+        }
+        else if (perf && !strcmp(argv[i], "--baseline") && i+1 < argc) baseline = argv[++i];
+        else if (perf && !strcmp(argv[i], "--tolerance") && i+1 < argc) tol = atof(argv[++i]);
+        else if (perf && !strcmp(argv[i], "--p99-tolerance") && i+1 < argc) p99_tol = atof(argv[++i]);
+        else if (perf && !strcmp(argv[i], "--update")) update = 1;
+        else if (perf && !strcmp(argv[i], "--duration-ms") && i+1 < argc) cfg.duration_ms = atol(argv[++i]);
+        else if (perf && !strcmp(argv[i], "--warmup-ms") && i+1 < argc) cfg.warmup_ms = atol(argv[++i]);
+        else if (perf && !strcmp(argv[i], "--keys") && i+1 < argc) cfg.keys = atol(argv[++i]);
+        else if (!run && !wake) { usage(argv[0]); return 2; }
+        else if (!strcmp(argv[i], "--format") && i+1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "json")) cfg.format = FMT_JSON;
+            else if (!strcmp(argv[i], "csv")) cfg.format = FMT_CSV;
+            else if (!strcmp(argv[i], "text")) cfg.format = FMT_TEXT;
+            else { usage(argv[0]); return 2; }
+        }
+        else if (!run) { usage(argv[0]); return 2; }
+        else if (!strcmp(argv[i], "--workload") && i+1 < argc) cfg.workload = argv[++i];
+        else if (!strcmp(argv[i], "--mix") && i+1 < argc) mix = argv[++i];
+        else if (!strcmp(argv[i], "--dist") && i+1 < argc) dist = argv[++i];
+        else if (!strcmp(argv[i], "--theta") && i+1 < argc) cfg.theta = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--keys") && i+1 < argc) cfg.keys = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--value-size") && i+1 < argc) {
+            char *end;
+            cfg.value_min = cfg.value_max = strtol(argv[++i], &end, 10);
+            if (*end == '-') cfg.value_max = strtol(end + 1, NULL, 10);
+        }
+        else if (!strcmp(argv[i], "--scan-len") && i+1 < argc) cfg.scan_len = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i+1 < argc) cfg.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--processes") && i+1 < argc) cfg.processes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--pin")) cfg.pin = 1;
+        else if (!strcmp(argv[i], "--duration-ms") && i+1 < argc) cfg.duration_ms = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--warmup-ms") && i+1 < argc) cfg.warmup_ms = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i+1 < argc) cfg.seed = strtoull(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+    if (cfg.runs < 1) cfg.runs = 1;
+    if (wake) {
+        if (rounds < 1 || gap_us < 0 || !mechs) { usage(argv[0]); return 2; }
+        return bench_wake(&cfg, mechs, rounds, gap_us);
+    }
+    if (perf) {
+        if (tol <= 0 || tol >= 1 || p99_tol <= 0 || cfg.keys < 1 || cfg.duration_ms < 1) {
+            usage(argv[0]);
+            return 2;
+        }
+        cfg.slots = cfg.keys * 4 < 65536 ? 65536 : cfg.keys * 4;
+        return bench_perf(&cfg, baseline, tol, p99_tol, update);
+    }
+    if (!run) return bench_create(&cfg);
+
+    int named = apply_workload(&cfg, cfg.workload) == 0;
+    if (mix) {
+        if (parse_mix(&cfg, mix) != 0) {
+            fprintf(stderr, "%s: bad --mix '%s'\n", argv[0], mix);
+            return 2;
+        }
+        if (!named) cfg.dist = DIST_ZIPF;
+        cfg.workload = "custom";
+    } else if (!named) {
+        fprintf(stderr, "%s: unknown workload '%s'\n", argv[0], cfg.workload);
+        return 2;
+    }
+    if (dist && (cfg.dist = parse_dist(dist)) < 0) {
+        fprintf(stderr, "%s: unknown distribution '%s'\n", argv[0], dist);
+        return 2;
+    }
+    if (cfg.keys < 1 || cfg.threads < 1 || cfg.threads > 256 || cfg.processes < 1 ||
+        cfg.processes > 256 || cfg.duration_ms < 1 ||
+        cfg.scan_len < 1 || cfg.theta <= 0 || cfg.theta >= 1 || cfg.value_min < 1 ||
+        cfg.value_max < cfg.value_min || cfg.value_max > cfg.max_value_size) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!cfg.seed) cfg.seed = 1;
+    /* children publish one histogram per op as a single value */
+    if (cfg.processes > 1 && cfg.max_value_size < (long)sizeof(bench_op_result_t))
+        cfg.max_value_size = (long)sizeof(bench_op_result_t);
+    /* room for the loaded keys, the incr counters and a run's worth of inserts */
+    if (!cfg.slots) cfg.slots = cfg.keys * 4 < 65536 ? 65536 : cfg.keys * 4;
+
+    return bench_run(&cfg);
+}
@@ -79,6 +79,9 @@ char *cli_rejoin_args(char *const src[]);
 void cli_show_modules(void);
 void cli_show_key_config(const char *key, const char *caller);
 int cli_safer_atoi(const char *string);
+int cli_parse_size(const char *string, unsigned long *out);
+void setup_terminal(void);
+void restore_terminal(void);
 char * cli_show_key_type(unsigned short flags);
 uint16_t cli_type_to_bitmask(const char *type);
 unsigned int cli_key_is_printable_unserialized(unsigned short flags);
@@ -162,6 +165,27 @@ void help_cmd_caps(unsigned int level);
 int cmd_shard(int argc, char *argv[]);
 void help_cmd_shard(unsigned int level);
 
+int cmd_scan(int argc, char *argv[]);
+void help_cmd_scan(unsigned int level);
+
+int cmd_ttl(int argc, char *argv[]);
+void help_cmd_ttl(unsigned int level);
+
+int cmd_resize(int argc, char *argv[]);
+void help_cmd_resize(unsigned int level);
+
+int cmd_purge(int argc, char *argv[]);
+void help_cmd_purge(unsigned int level);
+
+int cmd_stats(int argc, char *argv[]);
+void help_cmd_stats(unsigned int level);
+
+int cmd_tier(int argc, char *argv[]);
+void help_cmd_tier(unsigned int level);
+
+int cmd_mem(int argc, char *argv[]);
+void help_cmd_mem(unsigned int level);
+
 #ifdef HAVE_EMBEDDINGS
 int cmd_search(int argc, char *argv[]);
 void help_cmd_search(unsigned int level);
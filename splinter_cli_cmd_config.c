@@ -17,12 +17,13 @@ void help_cmd_config(unsigned int level) {
     (void) level;
     printf("Usage: %s\n       %s [feature_flag] [flag_value]\n", modname, modname);
     printf("If no other arguments are given, %s displays the current bus settings.\n", modname);
-    printf("Supported flags:\n\t\"mop\" -> 0, 1 or 2\n\n");
+    printf("Supported flags:\n\t\"mop\" -> 0, 1 or 2\n\t\"index\" -> 0 or 1 (ordered key index)\n\t\"evict\" -> 0 or 1 (CLOCK eviction when full)\n\t\"chain\" -> 0 or 1 (values past max_val_sz)\n\n");
     return;
 }
 
 static void show_bus_config(void) {
     splinter_header_snapshot_t snap = {0};
+    splinter_stats_t st = {0};
 
     splinter_get_header_snapshot(&snap);
 
@@ -31,8 +32,17 @@ static void show_bus_config(void) {
     printf("slots:       %u\n", snap.slots);
     printf("alignment:   %zu\n", alignof(struct splinter_slot));
     printf("max_val_sz:  %u\n", snap.max_val_sz);
+    printf("arena:       %lu (brk %lu, in use %lu)\n", snap.arena_sz, snap.arena_brk, snap.arena_inuse);
     printf("epoch:       %lu\n", snap.epoch);
     printf("auto_scrub : %u\n", (snap.core_flags & SPL_SYS_AUTO_SCRUB) == 1 ? 1 : 0);
+    printf("key_index:   %u\n", (snap.core_flags & SPL_SYS_KEY_INDEX) ? 1 : 0);
+    printf("evict:       %u\n", (snap.core_flags & SPL_SYS_EVICT) ? 1 : 0);
+    printf("chain:       %d (max %lu)\n", splinter_get_chaining(), snap.chain_max);
+    printf("stats:       %u\n", splinter_get_stats(&st) == 0 ? st.enabled : 0);
+    printf("tier:        %d\n", splinter_get_tiering());
+    printf("tick_hz:     %lu\n", splinter_tick_hz());
+    printf("expired:     %lu\n", snap.expired);
+    printf("evicted:     %lu\n", snap.evicted);
     puts("");
     
     return;
@@ -57,6 +67,24 @@ int cmd_config(int argc, char *argv[]) {
                 return 1;
             }
             return splinter_set_mop(opt);
+        } else if (!strncmp(argv[1], "index", 5)) {
+            if (opt > 1 || opt < 0) {
+                fprintf(stderr, "Invalid setting flag (0 = off, 1 = on)\n");
+                return 1;
+            }
+            return splinter_set_key_index(opt);
+        } else if (!strncmp(argv[1], "evict", 5)) {
+            if (opt > 1 || opt < 0) {
+                fprintf(stderr, "Invalid setting flag (0 = off, 1 = on)\n");
+                return 1;
+            }
+            return splinter_set_eviction(opt);
+        } else if (!strncmp(argv[1], "chain", 5)) {
+            if (opt > 1 || opt < 0) {
+                fprintf(stderr, "Invalid setting flag (0 = off, 1 = on)\n");
+                return 1;
+            }
+            return splinter_set_chaining(opt);
         } else {
             fprintf(stderr, "Invalid configuration token: %s\n", argv[1]);
             return 1;
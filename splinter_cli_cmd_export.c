@@ -150,10 +150,9 @@ int cmd_export(int argc, char *argv[]) {
     };
 
     splinter_slot_snapshot_t *slots = NULL;
-    char **keynames = NULL;
-    size_t entry_count = 0;
+    splinter_cursor_t cursor = { 0 };
     size_t max_keys = 0;
-    int rc = -1, i, x = 0;
+    int rc = -1, x = 0;
 
     if (argc > 2) {
         help_cmd_list(1);
@@ -169,62 +168,41 @@ int cmd_export(int argc, char *argv[]) {
         return -1;
     }
 
-    keynames = (char **)calloc(max_keys, sizeof(char *));
-    if (keynames == NULL) {
-        fprintf(stderr, "%s: unable to allocate memory for key names.\n", modname);
-        errno = ENOMEM;
-        return -1;
-    }
-
     slots = (splinter_slot_snapshot_t *)calloc(max_keys, sizeof(splinter_slot_snapshot_t));
     if (slots == NULL) {
         fprintf(stderr, "%s: unable to allocate memory for slot snapshots.\n", modname);
         errno = ENOMEM;
-        free(keynames);
         return -1;
     }
 
-    rc = splinter_list(keynames, max_keys, &entry_count);
-    if (rc == 0) {
-        g = grawk_init();
-        if (g == NULL) {
-            fprintf(stderr, "%s: unable to allocate memory to filter keys.\n", modname);
-            errno = ENOMEM;
-            rc = -1;
-            goto cleanup;
-        }
-        
-        grawk_set_options(g, &opts);
-        if (argc == 2) {
-            filter = grawk_build_pattern(argv[1]);
-            grawk_set_pattern(g, filter);
-        }
+    g = grawk_init();
+    if (g == NULL) {
+        fprintf(stderr, "%s: unable to allocate memory to filter keys.\n", modname);
+        errno = ENOMEM;
+        rc = -1;
+        goto cleanup;
+    }
+    
+    grawk_set_options(g, &opts);
+    if (argc == 2) {
+        filter = grawk_build_pattern(argv[1]);
+        grawk_set_pattern(g, filter);
+    }
 
-        for (i = 0; keynames[i]; i++) {
-            if (keynames[i][0] != '\0') {
-                // if there's no filter, just add it
-                if (filter == NULL) {
-                    splinter_get_slot_snapshot(keynames[i], &slots[x]);
-                    x++;
-                } else {
-                    // only add if filter matches
-                    if (grawk_match(g, keynames[i])) {
-                        splinter_get_slot_snapshot(keynames[i], &slots[x]);
-                        x++;
-                    }
-                }
-            }
-        }
+    // Walk occupied slots only; the snapshot already carries the key.
+    while ((size_t)x < max_keys &&
+           splinter_iter_next(&cursor, &slots[x], SPL_SNAP_META) == 1) {
+        if (filter == NULL || grawk_match(g, slots[x].key)) x++;
+    }
 
-        qsort(slots, x, sizeof(splinter_slot_snapshot_t), compare_slots_by_epoch);
-        
-        // TODO: Other formats / arguments
-        print_json(slots, x, &snap);
+    qsort(slots, x, sizeof(splinter_slot_snapshot_t), compare_slots_by_epoch);
+    
+    // TODO: Other formats / arguments
+    print_json(slots, x, &snap);
 
-        // Empty line is intentional (and uniform throughout commands) 
-        puts("");
-        rc = 0;
-    }
+    // Empty line is intentional (and uniform throughout commands) 
+    puts("");
+    rc = 0;
 
 cleanup:
     // Free grawk resources
@@ -236,9 +214,5 @@ cleanup:
         free(slots);
     }
     
-    if (keynames != NULL) {
-        free(keynames);
-    }
-
     return rc;
 }
@@ -44,7 +44,7 @@ int cmd_get(int argc, char *argv[]) {
     }
 
     // 2. Get the type metadata
-    if (splinter_get_slot_snapshot(key, &snap) != 0) {
+    if (splinter_get_slot_snapshot_ex(key, &snap, SPL_SNAP_TYPE) != 0) {
         // Fallback to string if snapshot fails
         printf("%s\n", buf);
     } else {
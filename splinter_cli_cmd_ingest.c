@@ -62,7 +62,8 @@ void help_cmd_ingest(unsigned int level) {
     if (level) {
         puts("");
         puts("Key name defaults to basename(file). For stdin --key is required.");
-        puts("Chunk size is derived from the store's max_val_sz at runtime.");
+        puts("Chunk size is derived from the store's max_val_sz at runtime,");
+        puts("or its chain_max when the store chains long values.");
         puts("Keys longer than 56 chars will be truncated to leave room for");
         puts("the order accessor suffix (.<N> up to .999).");
         puts("");
@@ -266,8 +267,11 @@ int cmd_ingest(int argc, char *argv[]) {
     /*
      * Leave a small safety margin below max_val_sz so we don't race
      * the slot boundary. 64 bytes is enough for any incidental bookkeeping.
+     * A store that chains values takes whole documents up to chain_max.
      */
     size_t chunk_sz = (snap.max_val_sz > 64) ? snap.max_val_sz - 64 : snap.max_val_sz;
+    if (splinter_get_chaining() == 1 && snap.chain_max > chunk_sz)
+        chunk_sz = (size_t)snap.chain_max;
 
     char  *chunk_buf = malloc(chunk_sz);
     if (!chunk_buf) {
@@ -28,8 +28,10 @@ void help_cmd_init(unsigned int level)
 {
 
     (void)level;
-    printf("Usage: %s [store_name] [--slots num_slots] [--maxlen max_val_len]\n", modname);
+    printf("Usage: %s [store_name] [--slots num_slots] [--maxlen max_val_len] [--arena bytes]\n", modname);
     printf("%s creates a Splinter store to default or specific geometry.\n", modname);
+    puts("Values share one arena; --arena sizes it (default: slots x max_val_len).");
+    puts("Sizes take k, M, G or T suffixes (binary units), e.g. --arena 8G.");
     puts("If arguments are omitted, these compiled-in defaults are used:");
     printf("\nname: %s\nslots: %lu\nmaxlen: %lu\nalignment: %zu\n",
            DEFAULT_BUS,
@@ -45,7 +47,8 @@ int cmd_init(int argc, char *argv[])
     char save[64] = {0}, store[64] = {0};
     int rc = 0;
     unsigned int prev_conn = 0;
-    unsigned long max_slots = DEFAULT_SLOTS, max_val = DEFAULT_VAL_MAXLEN;
+    unsigned long max_slots = DEFAULT_SLOTS, max_val = DEFAULT_VAL_MAXLEN, arena = 0;
+    const char *slots_arg = NULL, *val_arg = NULL, *arena_arg = NULL;
 
     if (thisuser.store_conn) {
         strncpy(save, thisuser.store, 64);
@@ -54,8 +57,9 @@ int cmd_init(int argc, char *argv[])
 
     struct argparse_option options[] = {
         OPT_HELP(),
-        OPT_INTEGER('s', "slots", &max_slots, "Maximum Slots", NULL, 0, 0),
-        OPT_INTEGER('l', "length", &max_val, "Maximum Value Length", NULL, 0, 0),
+        OPT_STRING('s', "slots", &slots_arg, "Maximum Slots", NULL, 0, 0),
+        OPT_STRING('l', "length", &val_arg, "Maximum Value Length", NULL, 0, 0),
+        OPT_STRING('a', "arena", &arena_arg, "Value Arena Bytes (0 = slots x length)", NULL, 0, 0),
         OPT_END(),
     };
 
@@ -64,6 +68,13 @@ int cmd_init(int argc, char *argv[])
     argparse_describe(&argparse, "\nInitialize a store", "\nCreates a new store to the specified geometry.");
     argc = argparse_parse(&argparse, argc, (const char **)argv);
 
+    if ((slots_arg && cli_parse_size(slots_arg, &max_slots) != 0) ||
+        (val_arg && cli_parse_size(val_arg, &max_val) != 0) ||
+        (arena_arg && cli_parse_size(arena_arg, &arena) != 0)) {
+        fprintf(stderr, "%s: sizes are whole numbers, optionally with a k, M, G or T suffix.\n", modname);
+        return -1;
+    }
+
     if (argc != 0)
         snprintf(store, sizeof(store) - 1, "%s", argv[argc-1]);
 
@@ -71,8 +82,12 @@ int cmd_init(int argc, char *argv[])
         snprintf(store, sizeof(store) - 1, DEFAULT_BUS);
 
     size_t slot_sz = sizeof(struct splinter_slot);
-    size_t arena_sz = max_slots * max_val;
-    size_t total_est = sizeof(struct splinter_header) + (max_slots * slot_sz) + arena_sz;
+    size_t arena_sz = arena ? arena : max_slots * ((max_val + 63) & ~63ul);
+    size_t total_est = sizeof(struct splinter_header) + (max_slots * slot_sz)
+                     + (max_slots * sizeof(struct splinter_index_node))
+                     + ((max_slots * sizeof(struct splinter_slot_aux) + 63) & ~(size_t)63)
+                     + (((max_slots + 63) / 64 * sizeof(uint64_t) + 63) & ~(size_t)63)
+                     + arena_sz;
 
     printf("Initializing store: %s\n", store);
     printf(" - Slots: %lu (%zu bytes each, %zu byte alignment)\n",
@@ -83,10 +98,10 @@ int cmd_init(int argc, char *argv[])
            arena_sz,
            total_est,
            (double)total_est / 1048576.0);
-    rc = splinter_create(store, max_slots, max_val);
+    rc = splinter_create_ex(store, max_slots, max_val, arena);
 
     if (rc < 0)
-        perror("splinter_create");
+        perror("splinter_create_ex");
 
     splinter_close();
     goto restore_conn;
@@ -46,8 +46,7 @@ int cmd_list(int argc, char *argv[]) {
     };
 
     splinter_slot_snapshot_t *slots = NULL;
-    char **keynames = NULL;
-    size_t entry_count = 0;
+    splinter_cursor_t cursor = { 0 };
     size_t max_keys = 0;
     int rc = -1, i, x = 0;
 
@@ -65,77 +64,56 @@ int cmd_list(int argc, char *argv[]) {
         return -1;
     }
 
-    keynames = (char **)calloc(max_keys, sizeof(char *));
-    if (keynames == NULL) {
-        fprintf(stderr, "%s: unable to allocate memory for key names.\n", modname);
-        errno = ENOMEM;
-        return -1;
-    }
-
     slots = (splinter_slot_snapshot_t *)calloc(max_keys, sizeof(splinter_slot_snapshot_t));
     if (slots == NULL) {
         fprintf(stderr, "%s: unable to allocate memory for slot snapshots.\n", modname);
         errno = ENOMEM;
-        free(keynames);
         return -1;
     }
 
-    rc = splinter_list(keynames, max_keys, &entry_count);
-    if (rc == 0) {
-        g = grawk_init();
-        if (g == NULL) {
-            fprintf(stderr, "%s: unable to allocate memory to filter keys.\n", modname);
-            errno = ENOMEM;
-            rc = -1;
-            goto cleanup;
-        }
-        
-        grawk_set_options(g, &opts);
-        if (argc == 2) {
-            filter = grawk_build_pattern(argv[1]);
-            grawk_set_pattern(g, filter);
-        }
-
-        for (i = 0; keynames[i]; i++) {
-            if (keynames[i][0] != '\0') {
-                // if there's no filter, just add it
-                if (filter == NULL) {
-                    splinter_get_slot_snapshot(keynames[i], &slots[x]);
-                    x++;
-                } else {
-                    // only add if filter matches
-                    if (grawk_match(g, keynames[i])) {
-                        splinter_get_slot_snapshot(keynames[i], &slots[x]);
-                        x++;
-                    }
-                }
-            }
-        }
-
-        // Sort so the most-updated keys are at the top of the list
-        qsort(slots, x, sizeof(splinter_slot_snapshot_t), compare_slots_by_epoch);
-
-        printf("%-44s %-6s %-6s %s\n",
-            "Name",
-            "Epoch",
-            "Len",
-            "Type"
+    g = grawk_init();
+    if (g == NULL) {
+        fprintf(stderr, "%s: unable to allocate memory to filter keys.\n", modname);
+        errno = ENOMEM;
+        rc = -1;
+        goto cleanup;
+    }
+    
+    grawk_set_options(g, &opts);
+    if (argc == 2) {
+        filter = grawk_build_pattern(argv[1]);
+        grawk_set_pattern(g, filter);
+    }
+
+    // Walk occupied slots only; the snapshot already carries the key.
+    while ((size_t)x < max_keys &&
+           splinter_iter_next(&cursor, &slots[x], SPL_SNAP_META) == 1) {
+        if (filter == NULL || grawk_match(g, slots[x].key)) x++;
+    }
+
+    // Sort so the most-updated keys are at the top of the list
+    qsort(slots, x, sizeof(splinter_slot_snapshot_t), compare_slots_by_epoch);
+
+    printf("%-44s %-6s %-6s %s\n",
+        "Name",
+        "Epoch",
+        "Len",
+        "Type"
+    );
+    
+    for (i = 0; i < x && slots[i].epoch > 0; i++) {
+        printf("%-44s %-6lu %-6u %s\n", 
+            slots[i].key,
+            slots[i].epoch,
+            slots[i].val_len,
+            cli_show_key_type(slots[i].type_flag)
         );
-        
-        for (i = 0; i < x && slots[i].epoch > 0; i++) {
-            printf("%-44s %-6lu %-6u %s\n", 
-                slots[i].key,
-                slots[i].epoch,
-                slots[i].val_len,
-                cli_show_key_type(slots[i].type_flag)
-            );
-        }
-
-        // Empty line is intentional (and uniform throughout commands) 
-        puts("");
-        rc = 0;
     }
 
+    // Empty line is intentional (and uniform throughout commands) 
+    puts("");
+    rc = 0;
+
 cleanup:
     // Free grawk resources
     if (g != NULL) {
@@ -146,9 +124,5 @@ cleanup:
         free(slots);
     }
     
-    if (keynames != NULL) {
-        free(keynames);
-    }
-
     return rc;
 }
@@ -153,7 +153,7 @@ static int lua_splinter_get(lua_State *L) {
     }
 
     // 2. Determine semantic type via snapshot
-    if (splinter_get_slot_snapshot(key, &snap) == 0) {
+    if (splinter_get_slot_snapshot_ex(key, &snap, SPL_SNAP_TYPE) == 0) {
         if (snap.type_flag & SPL_SLOT_TYPE_BIGUINT) {
             // Return as a Lua integer for math
             uint64_t val = *(uint64_t *)buf;
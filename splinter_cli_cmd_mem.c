@@ -0,0 +1,138 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_mem.c
+ * @brief Implements the CLI 'mem' command: residency and footprint.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "splinter_cli.h"
+
+static const char *modname = "mem";
+
+static const char *const region_labels[SPL_REGION_COUNT] = {
+    "header", "slots", "embeddings", "index", "aux", "occupancy", "values"
+};
+
+#define MEM_BAR_WIDTH 32
+
+void help_cmd_mem(unsigned int level) {
+    (void) level;
+    printf("Usage: %s\n", modname);
+    printf("%s shows how much of the store is in memory, region by region (from\n", modname);
+    printf("mincore()), and where the value arena goes: bytes stored, bytes lost to\n");
+    printf("size-class slack and to the max_val_sz lane, by label and by slot range.\n");
+    printf("Slots are read without locking, so figures taken under writes are approximate.\n");
+    return;
+}
+
+static double pct(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static const char *label_name(int bit) {
+    for (int i = 0; i < thisuser.label_count; i++)
+        if (thisuser.labels[i].mask == (1ULL << bit)) return thisuser.labels[i].name;
+    return NULL;
+}
+
+static void print_values(const char *name, const splinter_mem_values_t *v) {
+    printf("  %-16s %8lu %12lu %12lu %12lu %6.1f%%\n", name, v->keys, v->val_bytes,
+           v->ext_bytes, v->resident, pct(v->resident, v->ext_bytes));
+}
+
+int cmd_mem(int argc, char *argv[]) {
+    splinter_mem_report_t rep;
+    splinter_header_snapshot_t snap = { 0 };
+    char name[40];
+
+    (void) argv;
+    if (!thisuser.store_conn) {
+        fprintf(stderr, "%s: not connected to a store.\n", modname);
+        return -1;
+    }
+    if (argc > 1) {
+        help_cmd_mem(1);
+        return -1;
+    }
+    if (splinter_mem_report(&rep) != 0) {
+        fprintf(stderr, "%s: unable to read residency: %s\n", modname, strerror(errno));
+        return -1;
+    }
+    splinter_get_header_snapshot(&snap);
+
+    uint64_t total = 0, total_res = 0;
+    printf("%-12s %12s %8s %8s %7s\n", "region", "bytes", "pages", "resident", "");
+    for (int r = 0; r < SPL_REGION_COUNT; r++) {
+        const splinter_mem_region_t *g = &rep.region[r];
+        if (r == SPL_REGION_EMBEDDINGS && !g->bytes) continue;
+        printf("%-12s %12lu %8lu %8lu %6.1f%%\n", region_labels[r], g->bytes, g->pages,
+               g->resident, pct(g->resident, g->pages));
+        // Embedding pages are also slot pages; don't count them twice.
+        if (r != SPL_REGION_EMBEDDINGS) {
+            total += g->pages;
+            total_res += g->resident;
+        }
+    }
+    printf("%-12s %12lu %8lu %8lu %6.1f%%\n", "total", total * rep.page_size, total,
+           total_res, pct(total_res, total));
+    printf("page size %lu; pages two regions share are counted in both.\n\n", rep.page_size);
+
+    uint64_t lane = rep.all.keys * rep.max_val_sz;
+    printf("values:      %lu keys, %lu bytes in %lu bytes of extents\n",
+           rep.all.keys, rep.all.val_bytes, rep.all.ext_bytes);
+    printf("class slack: %lu bytes (%.1f%% of extents)\n", rep.all.ext_bytes - rep.all.val_bytes,
+           pct(rep.all.ext_bytes - rep.all.val_bytes, rep.all.ext_bytes));
+    printf("lane slack:  %lu bytes (max_val_sz %u - val_len, summed)\n",
+           lane > rep.all.val_bytes ? lane - rep.all.val_bytes : 0, rep.max_val_sz);
+    printf("arena:       %lu in use of %lu, %lu free below the break\n",
+           snap.arena_inuse, snap.arena_sz,
+           snap.arena_brk > snap.arena_inuse ? snap.arena_brk - snap.arena_inuse : 0);
+    printf("resident:    %lu of %lu extent bytes (%.1f%%)\n", rep.all.resident, rep.all.ext_bytes,
+           pct(rep.all.resident, rep.all.ext_bytes));
+    if (rep.region[SPL_REGION_EMBEDDINGS].bytes)
+        printf("embeddings:  %lu of %lu live keys (%.1f%%)\n", rep.embedded, rep.all.keys,
+               pct(rep.embedded, rep.all.keys));
+
+    int any = 0;
+    for (int b = 0; b < 64; b++) {
+        if (!rep.label[b].keys) continue;
+        if (!any++) printf("\n  %-16s %8s %12s %12s %12s %7s\n", "label", "keys", "val bytes",
+                           "extents", "resident", "");
+        const char *ln = label_name(b);
+        if (ln) snprintf(name, sizeof(name), "%s", ln);
+        else snprintf(name, sizeof(name), "bit %d", b);
+        print_values(name, &rep.label[b]);
+    }
+
+    uint64_t peak = 0;
+    for (int b = 0; b < SPLINTER_MEM_RANGES; b++)
+        if (rep.range[b].ext_bytes > peak) peak = rep.range[b].ext_bytes;
+    printf("\n  %-16s %8s %12s %12s %12s %7s\n", "slots", "keys", "val bytes", "extents", "resident", "");
+    for (int b = 0; b < SPLINTER_MEM_RANGES; b++) {
+        uint64_t lo = (uint64_t)b * rep.range_slots;
+        if (lo >= rep.slots) break;
+        uint64_t hi = lo + rep.range_slots > rep.slots ? rep.slots : lo + rep.range_slots;
+        snprintf(name, sizeof(name), "%lu-%lu", lo, hi - 1);
+        print_values(name, &rep.range[b]);
+    }
+    // Each bar is a range's extents against the fullest range; '#' is resident, '.' is not.
+    if (peak) {
+        putchar('\n');
+        for (int b = 0; b < SPLINTER_MEM_RANGES; b++) {
+            if ((uint64_t)b * rep.range_slots >= rep.slots) break;
+            const splinter_mem_values_t *v = &rep.range[b];
+            int w = (int)(v->ext_bytes * MEM_BAR_WIDTH / peak);
+            int res = v->ext_bytes ? (int)(v->resident * (uint64_t)w / v->ext_bytes) : 0;
+            printf("  %2d |", b);
+            for (int c = 0; c < w; c++) putchar(c < res ? '#' : '.');
+            putchar('\n');
+        }
+    }
+    putchar('\n');
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_purge.c
+ * @brief Implements the CLI 'purge' command.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "splinter_cli.h"
+#include "argparse.h"
+
+static const char *modname = "purge";
+
+#define PURGE_MAX_THREADS 64
+
+static const char *const usages[] = {
+    "purge [--threads num] [--budget ms] [--pause ms]",
+    NULL,
+};
+
+typedef struct {
+    splinter_cursor_t cursor;
+    uint64_t budget_ns;
+    long pause_ms;
+    unsigned long steps;
+} purge_job_t;
+
+void help_cmd_purge(unsigned int level) {
+    (void) level;
+    printf("%s zeroes stale bytes past each value's length in the current store.\n", modname);
+    printf("Usage: %s [--threads num] [--budget ms] [--pause ms]\n", modname);
+    printf("The slots are split between --threads workers. Each works in slices of\n");
+    printf("--budget ms and sleeps --pause ms between them, so readers and writers are\n");
+    printf("never stalled for longer than one slice. Slots that are still clean from\n");
+    printf("the last purge are skipped.\n");
+    return;
+}
+
+static void *purge_worker(void *arg) {
+    purge_job_t *job = arg;
+    struct timespec pause = {
+        .tv_sec = job->pause_ms / 1000,
+        .tv_nsec = (job->pause_ms % 1000) * 1000000L
+    };
+
+    for (;;) {
+        job->steps++;
+        if (splinter_purge_step(&job->cursor, job->budget_ns) != 1)
+            break;
+        if (job->pause_ms)
+            nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+int cmd_purge(int argc, char *argv[]) {
+    splinter_header_snapshot_t snap = { 0 };
+    purge_job_t jobs[PURGE_MAX_THREADS];
+    pthread_t th[PURGE_MAX_THREADS];
+    int started[PURGE_MAX_THREADS] = { 0 };
+    // OPT_INTEGER stores an int: the options must be ints, not longs.
+    int threads = 1, budget_ms = 10, pause_ms = 0;
+    unsigned long steps = 0, i;
+    struct timespec t0, t1;
+
+    if (splinter_get_header_snapshot(&snap) != 0) {
+        fprintf(stderr, "%s: no store is open.\n", modname);
+        return -1;
+    }
+
+    struct argparse_option options[] = {
+        OPT_HELP(),
+        OPT_INTEGER('t', "threads", &threads, "Worker threads (1-64)", NULL, 0, 0),
+        OPT_INTEGER('b', "budget", &budget_ms, "Milliseconds per slice (0 = no limit)", NULL, 0, 0),
+        OPT_INTEGER('p', "pause", &pause_ms, "Milliseconds to sleep between slices", NULL, 0, 0),
+        OPT_END(),
+    };
+
+    struct argparse argparse;
+    argparse_init(&argparse, options, usages, 0);
+    argparse_describe(&argparse, "\nPurge the current store", "\nZeroes stale value bytes in bounded slices.");
+    argc = argparse_parse(&argparse, argc, (const char **)argv);
+    if (argc != 0 || threads < 1 || threads > PURGE_MAX_THREADS || budget_ms < 0 || pause_ms < 0) {
+        help_cmd_purge(1);
+        return -1;
+    }
+    if ((unsigned)threads > snap.slots) threads = snap.slots ? (int)snap.slots : 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < (unsigned long)threads; i++) {
+        jobs[i].cursor.next = (uint64_t)snap.slots * i / threads;
+        jobs[i].cursor.end = (uint64_t)snap.slots * (i + 1) / threads;
+        jobs[i].budget_ns = (uint64_t)budget_ms * 1000000ull;
+        jobs[i].pause_ms = (long)pause_ms;
+        jobs[i].steps = 0;
+        if (jobs[i].cursor.next == jobs[i].cursor.end)
+            continue;
+        if (pthread_create(&th[i], NULL, purge_worker, &jobs[i]) == 0)
+            started[i] = 1;
+        else
+            purge_worker(&jobs[i]); // sweep this range here rather than skip it
+    }
+    for (i = 0; i < (unsigned long)threads; i++) {
+        if (started[i])
+            pthread_join(th[i], NULL);
+        steps += jobs[i].steps;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    printf("Purged %u slots with %d thread%s in %lu slice%s (%.1f ms)\n",
+           snap.slots, threads, threads == 1 ? "" : "s", steps, steps == 1 ? "" : "s",
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+
+    // Empty line is intentional (and uniform throughout commands)
+    puts("");
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_resize.c
+ * @brief Implements the CLI 'resize' command.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "splinter_cli.h"
+#include "argparse.h"
+
+static const char *modname = "resize";
+
+static const char *const usages[] = {
+    "resize [--slots num_slots] [--length max_val_len]",
+    NULL,
+};
+
+void help_cmd_resize(unsigned int level) {
+    (void) level;
+    printf("%s moves the current store to new geometry while it stays in use.\n", modname);
+    printf("Usage: %s [--slots num_slots] [--length max_val_len]\n", modname);
+    printf("Omitted options keep the current value. Reads carry on throughout;\n");
+    printf("writes to keys already copied answer EAGAIN until the move completes.\n");
+    printf("Sizes take k, M, G or T suffixes (binary units), e.g. --length 64k.\n");
+    return;
+}
+
+int cmd_resize(int argc, char *argv[]) {
+    splinter_header_snapshot_t snap = { 0 };
+    unsigned long slots = 0, max_val = 0;
+    const char *slots_arg = NULL, *val_arg = NULL;
+
+    if (splinter_get_header_snapshot(&snap) != 0) {
+        fprintf(stderr, "%s: no store is open.\n", modname);
+        return -1;
+    }
+
+    struct argparse_option options[] = {
+        OPT_HELP(),
+        OPT_STRING('s', "slots", &slots_arg, "Slots in the resized store", NULL, 0, 0),
+        OPT_STRING('l', "length", &val_arg, "Maximum Value Length", NULL, 0, 0),
+        OPT_END(),
+    };
+
+    struct argparse argparse;
+    argparse_init(&argparse, options, usages, 0);
+    argparse_describe(&argparse, "\nResize the current store", "\nCopies every key into a store of the new geometry.");
+    argc = argparse_parse(&argparse, argc, (const char **)argv);
+    if (argc != 0 ||
+        (slots_arg && cli_parse_size(slots_arg, &slots) != 0) ||
+        (val_arg && cli_parse_size(val_arg, &max_val) != 0)) {
+        help_cmd_resize(1);
+        return -1;
+    }
+
+    if (!slots) slots = snap.slots;
+    if (!max_val) max_val = snap.max_val_sz;
+
+    printf("Resizing: %u x %u -> %lu x %lu\n", snap.slots, snap.max_val_sz, slots, max_val);
+    if (splinter_resize(slots, max_val) != 0) {
+        fprintf(stderr, "%s: %s\n", modname,
+            errno == EBUSY ? "another resize is running, or a slot stayed busy" :
+            errno == ENOSPC ? "the live keys do not fit that geometry" :
+            strerror(errno));
+        return -1;
+    }
+
+    // Empty line is intentional (and uniform throughout commands)
+    puts("");
+    return 0;
+}
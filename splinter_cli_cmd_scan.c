@@ -0,0 +1,65 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_scan.c
+ * @brief Implements the CLI 'scan' command (ordered prefix / range listing).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "splinter_cli.h"
+
+static const char *modname = "scan";
+
+void help_cmd_scan(unsigned int level) {
+    (void) level;
+    printf("%s lists keys in byte order using the store's ordered key index.\n", modname);
+    printf("Usage: %s [prefix]\n       %s <from> <to>\n", modname, modname);
+    printf("With no prefix, SPLINTER_NS_PREFIX (if set) is used as the prefix.\n");
+    printf("The range form lists keys from <from> (inclusive) up to <to> (exclusive).\n");
+    printf("Enable the index first with: config index 1\n");
+    return;
+}
+
+static void print_key(const char *key, uint64_t epoch, void *data) {
+    (void) data;
+    printf("%-44s %-6lu\n", key, epoch);
+}
+
+int cmd_scan(int argc, char *argv[]) {
+    const char *prefix = getenv("SPLINTER_NS_PREFIX");
+    int rc;
+
+    if (argc > 3) {
+        help_cmd_scan(1);
+        return -1;
+    }
+
+    if (splinter_get_key_index() != 1) {
+        fprintf(stderr, "%s: the ordered key index is off (enable with 'config index 1').\n", modname);
+        return -1;
+    }
+
+    printf("%-44s %-6s\n", "Name", "Epoch");
+
+    if (argc == 3) {
+        rc = splinter_scan_range(argv[1], argv[2], print_key, NULL);
+    } else {
+        if (argc == 2) prefix = argv[1];
+        rc = splinter_scan_prefix(prefix == NULL ? "" : prefix, print_key, NULL);
+    }
+
+    if (rc < 0) {
+        fprintf(stderr, "%s: scan failed: %s%s\n", modname, strerror(errno),
+            errno == ESTALE ? " (rebuild with 'config index 1')" : "");
+        return -1;
+    }
+
+    // Empty line is intentional (and uniform throughout commands)
+    puts("");
+    return 0;
+}
@@ -333,19 +333,6 @@ int cmd_search(int argc, char *argv[]) {
         goto cleanup;
     }
 
-    /* Store traversal */
-    if (bloom_mask != 0) {
-        enum_ctx_t ctx = { keynames, 0, max_keys };
-        splinter_enumerate_matches(bloom_mask, enum_callback, &ctx);
-        entry_count = ctx.count;
-    } else {
-        rc = splinter_list(keynames, max_keys, &entry_count);
-        if (rc != 0) {
-            fprintf(stderr, "%s: failed to list keys.\n", modname);
-            goto cleanup;
-        }
-    }
-
     /* Set up grawk for optional regex filtering */
     g = grawk_init();
     if (g == NULL) {
@@ -361,13 +348,27 @@ int cmd_search(int argc, char *argv[]) {
         grawk_set_pattern(g, filter);
     }
 
-    /* Build slot snapshot array, skipping scratch key and applying regex */
-    for (i = 0; keynames[i] && (size_t)i < max_keys; i++) {
-        if (keynames[i][0] == '\0') continue;
-        if (strncmp(keynames[i], scratch_key, SPLINTER_KEY_MAX) == 0) continue;
-        if (filter != NULL && !grawk_match(g, keynames[i])) continue;
-        splinter_get_slot_snapshot(keynames[i], &slots[x]);
-        x++;
+    /* Store traversal: build the slot snapshot array, skipping the scratch
+     * key and applying the regex */
+    if (bloom_mask != 0) {
+        enum_ctx_t ctx = { keynames, 0, max_keys };
+        splinter_enumerate_matches(bloom_mask, enum_callback, &ctx);
+        entry_count = ctx.count;
+        for (i = 0; (size_t)i < entry_count && keynames[i]; i++) {
+            if (keynames[i][0] == '\0') continue;
+            if (strncmp(keynames[i], scratch_key, SPLINTER_KEY_MAX) == 0) continue;
+            if (filter != NULL && !grawk_match(g, keynames[i])) continue;
+            splinter_get_slot_snapshot_ex(keynames[i], &slots[x], SPL_SNAP_META);
+            x++;
+        }
+    } else {
+        splinter_cursor_t cursor = { 0 };
+        while ((size_t)x < max_keys &&
+               splinter_iter_next(&cursor, &slots[x], SPL_SNAP_META) == 1) {
+            if (strncmp(slots[x].key, scratch_key, SPLINTER_KEY_MAX) == 0) continue;
+            if (filter != NULL && !grawk_match(g, slots[x].key)) continue;
+            x++;
+        }
     }
 
     /* Score each candidate slot */
@@ -50,6 +50,47 @@ static int shard_advice_for(uint8_t intent) {
     }
 }
 
+/* Ticks as given, or ns/us/ms/s converted at this host's tick rate. */
+static uint64_t shard_parse_duration(const char *arg) {
+    char *end = NULL;
+    uint64_t v = (uint64_t)strtoull(arg, &end, 0);
+    if (!end || !*end) return v;
+    if (!strcmp(end, "ns")) return splinter_ns_to_ticks(v);
+    if (!strcmp(end, "us")) return splinter_ns_to_ticks(v * 1000ULL);
+    if (!strcmp(end, "ms")) return splinter_ns_to_ticks(v * 1000000ULL);
+    if (!strcmp(end, "s"))  return splinter_ns_to_ticks(v * 1000000000ULL);
+    return v;
+}
+
+/* Read "slots=lo-hi" or "labels=mask" into scope; 0 if it was one of them. */
+static int shard_parse_scope(const char *arg, splinter_shard_scope_t *scope) {
+    char *end = NULL;
+    if (!strncmp(arg, "slots=", 6)) {
+        scope->slot_lo = (uint32_t)strtoul(arg + 6, &end, 0);
+        if (!end || *end != '-') return -1;
+        scope->slot_hi = (uint32_t)strtoul(end + 1, &end, 0);
+        return (end && !*end && scope->slot_lo < scope->slot_hi) ? 0 : -1;
+    }
+    if (!strncmp(arg, "labels=", 7)) {
+        scope->labels = (uint64_t)strtoull(arg + 7, &end, 0);
+        return (end && !*end && scope->labels) ? 0 : -1;
+    }
+    return -1;
+}
+
+/* "slots 0-63 labels 0x4", or "all" for an unscoped bid. */
+static const char *shard_scope_str(const struct splinter_shard_bid_snapshot *b,
+                                   char *buf, size_t sz) {
+    int n = 0;
+    buf[0] = '\0';
+    if (b->slot_lo < b->slot_hi)
+        n = snprintf(buf, sz, "slots %u-%u", b->slot_lo, b->slot_hi);
+    if (b->labels && n >= 0 && (size_t)n < sz)
+        snprintf(buf + n, sz - (size_t)n, "%slabels 0x%llx", n ? " " : "",
+                 (unsigned long long)b->labels);
+    return buf[0] ? buf : "all";
+}
+
 void help_cmd_shard(unsigned int level) {
     (void) level;
     printf("%s inspects and seeds the Logic Shard bid table (cooperative\n", modname);
@@ -57,13 +98,16 @@ void help_cmd_shard(unsigned int level) {
     printf("Usage:\n");
     printf("  %s table                         pretty-print all 32 bid slots\n", modname);
     printf("  %s who                           print current sovereign + intent\n", modname);
-    printf("  %s claim   <id> <intent> <prio> <dur_ticks>\n", modname);
-    printf("  %s rebid   <id> <intent> <prio> <dur_ticks>\n", modname);
+    printf("  %s claim   <id> <intent> <prio> <dur> [slots=lo-hi] [labels=mask]\n", modname);
+    printf("  %s rebid   <id> <intent> <prio> <dur>\n", modname);
     printf("  %s release <id>\n", modname);
-    printf("  %s advise  <id> <intent> [nowait]   cooperative madvise on the whole arena\n", modname);
+    printf("  %s advise  <id> <intent> [nowait]   cooperative madvise over the bid's scope\n", modname);
     printf("\n");
     printf("  intent: willneed | sequential | random | dontneed\n");
     printf("  ids are non-zero hex or decimal (e.g. 0x5F1A or 24346).\n");
+    printf("  dur is splinter_now() ticks, or real time with a ns/us/ms/s suffix (e.g. 250ms).\n");
+    printf("  slots= and labels= scope a claim to slots [lo, hi) and/or a label mask;\n");
+    printf("  a scoped bid only competes with bids that overlap it.\n");
     printf("\n");
     printf("NOTE: the CLI is a single short-lived process, so claim/release in one\n");
     printf("invocation do NOT persist across invocations (the bid is released when the\n");
@@ -79,18 +123,20 @@ static int shard_cmd_table(void) {
         return -1;
     }
 
-    printf("%-4s %-10s %-8s %-11s %-4s %-20s %-20s %-7s %-9s\n",
+    printf("%-4s %-10s %-8s %-11s %-4s %-20s %-20s %-7s %-9s %s\n",
            "slot", "shard_id", "pid", "intent", "prio",
-           "claimed_at", "duration", "expired", "sovereign");
+           "claimed_at", "duration", "expired", "sovereign", "scope");
     for (int b = 0; b < n; b++) {
+        char scope[64];
         if (snap[b].shard_id == 0) continue;
-        printf("%-4d 0x%-8x %-8u %-11s %-4u %-20llu %-20llu %-7s %-9s\n",
+        printf("%-4d 0x%-8x %-8u %-11s %-4u %-20llu %-20llu %-7s %-9s %s\n",
                b, snap[b].shard_id, snap[b].pid,
                shard_intent_name(snap[b].intent), snap[b].priority,
                (unsigned long long)snap[b].claimed_at,
                (unsigned long long)snap[b].duration_tsc,
                snap[b].expired ? "yes" : "no",
-               snap[b].sovereign ? "yes" : "no");
+               snap[b].sovereign ? "yes" : "no",
+               shard_scope_str(&snap[b], scope, sizeof(scope)));
     }
     return 0;
 }
@@ -139,10 +185,17 @@ int cmd_shard(int argc, char *argv[]) {
             return 1;
         }
         uint8_t  prio = (uint8_t)strtoul(argv[4], NULL, 0);
-        uint64_t dur  = (uint64_t)strtoull(argv[5], NULL, 0);
+        uint64_t dur  = shard_parse_duration(argv[5]);
+        splinter_shard_scope_t scope = {0};
+        for (int a = 6; a < argc; a++) {
+            if (strcmp(sub, "claim") != 0 || shard_parse_scope(argv[a], &scope) != 0) {
+                fprintf(stderr, "%s: bad scope '%s'.\n", modname, argv[a]);
+                return 1;
+            }
+        }
 
         int rc = (strcmp(sub, "claim") == 0)
-            ? splinter_shard_claim(id, (uint8_t)intent, prio, dur)
+            ? splinter_shard_claim_scoped(id, (uint8_t)intent, prio, dur, &scope)
             : splinter_shard_rebid(id, (uint8_t)intent, prio, dur);
         if (rc != 0) {
             fprintf(stderr, "%s %s failed (rc=%d, errno=%s)\n",
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_stats.c
+ * @brief Implements the CLI 'stats' command.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+#include "splinter_cli.h"
+
+static const char *modname = "stats";
+
+static const char *const lat_labels[SPL_LAT_OPS] = {
+    "get", "set", "append", "set_embedding", "integer_op", "madvise"
+};
+
+static const char *const probe_labels[SPLINTER_PROBE_BUCKETS] = {
+    "0", "1", "2-3", "4-7", "8-15", "16-31", "32-63", "64+"
+};
+
+void help_cmd_stats(unsigned int level) {
+    (void) level;
+    printf("Usage: %s [on | off | reset | sample N | sample off]\n", modname);
+    printf("%s shows the store's operation counters: calls per operation, misses,\n", modname);
+    printf("EAGAIN returns, set retries and ENOSPC refusals, event bus writes and a\n");
+    printf("histogram of probe lengths. Counting is off until '%s on'.\n", modname);
+    printf("'%s sample N' times one in N calls (N >= 1) into latency histograms;\n", modname);
+    printf("'%s sample off' stops. ", modname);
+    printf("Percentiles are in nanoseconds. 'reset' clears both.\n");
+    return;
+}
+
+static void show_stats(void) {
+    splinter_stats_t st = { 0 };
+    uint64_t calls = 0;
+
+    splinter_get_stats(&st);
+    for (int op = 0; op < SPL_OP_COUNT; op++)
+        calls += st.ops[op];
+
+    printf("counting:    %s\n", st.enabled ? "on" : "off");
+    printf("get:         %lu\n", st.ops[SPL_OP_GET]);
+    printf("set:         %lu\n", st.ops[SPL_OP_SET]);
+    printf("unset:       %lu\n", st.ops[SPL_OP_UNSET]);
+    printf("append:      %lu\n", st.ops[SPL_OP_APPEND]);
+    printf("misses:      %lu\n", st.misses);
+    printf("eagain:      %lu (%.3f%% of calls)\n", st.eagain,
+           calls ? 100.0 * (double)st.eagain / (double)calls : 0.0);
+    printf("retries:     %lu\n", st.retries);
+    printf("set_full:    %lu\n", st.set_full);
+    printf("eventfd:     %lu written, %lu read\n", st.eventfd_writes, st.eventfd_reads);
+    printf("sovereign:   %lu changes\n", st.sovereign_changes);
+    printf("madv defer:  %lu\n", st.madvise_defers);
+    puts("probe length:");
+    for (int b = 0; b < SPLINTER_PROBE_BUCKETS; b++)
+        printf("  %-6s     %lu\n", probe_labels[b], st.probe[b]);
+}
+
+static void show_latency(void) {
+    splinter_latency_t lat = { 0 };
+
+    splinter_get_latency(SPL_LAT_GET, &lat);
+    if (!lat.every) {
+        puts("latency:     off");
+        return;
+    }
+    printf("latency:     1 in %u calls, ns (%lu ticks/s)\n", lat.every, splinter_tick_hz());
+    printf("  %-14s %10s %10s %10s %10s %10s %10s\n",
+           "call", "samples", "p50", "p90", "p99", "p99.9", "max");
+    for (unsigned op = 0; op < SPL_LAT_OPS; op++) {
+        splinter_get_latency(op, &lat);
+        if (!lat.samples)
+            continue;
+        printf("  %-14s %10lu %10lu %10lu %10lu %10lu %10lu\n", lat_labels[op], lat.samples,
+               splinter_ticks_to_ns(lat.p50), splinter_ticks_to_ns(lat.p90),
+               splinter_ticks_to_ns(lat.p99), splinter_ticks_to_ns(lat.p999),
+               splinter_ticks_to_ns(lat.max));
+    }
+}
+
+int cmd_stats(int argc, char *argv[]) {
+    int rc = 0;
+
+    if (argc > 3 || (argc == 3 && strcmp(argv[1], "sample"))) {
+        help_cmd_stats(1);
+        return -1;
+    }
+
+    if (argc == 3) {
+        unsigned long every = 0;
+        if (strcmp(argv[2], "off")) {
+            char *end;
+            errno = 0;
+            long n = strtol(argv[2], &end, 10);
+            // A count of 0 or less would wrap to a huge unsigned rate.
+            if (errno || end == argv[2] || *end || n <= 0 || (unsigned long)n > UINT_MAX) {
+                help_cmd_stats(1);
+                return -1;
+            }
+            every = (unsigned long)n;
+        }
+        rc = splinter_set_latency_sampling((unsigned)every);
+        if (rc != 0) {
+            fprintf(stderr, "%s: no store is open.\n", modname);
+            return -1;
+        }
+    } else if (argc == 2) {
+        if (!strcmp(argv[1], "on")) {
+            rc = splinter_set_stats(1);
+        } else if (!strcmp(argv[1], "off")) {
+            rc = splinter_set_stats(0);
+        } else if (!strcmp(argv[1], "reset")) {
+            rc = splinter_reset_stats();
+            if (rc == 0) rc = splinter_reset_latency();
+        } else {
+            help_cmd_stats(1);
+            return -1;
+        }
+        if (rc != 0) {
+            fprintf(stderr, "%s: no store is open.\n", modname);
+            return -1;
+        }
+    }
+
+    show_stats();
+    show_latency();
+
+    // Empty line is intentional (and uniform throughout commands)
+    puts("");
+    return 0;
+}
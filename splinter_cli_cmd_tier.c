@@ -0,0 +1,133 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_tier.c
+ * @brief Implements the CLI 'tier' command: the hot/cold page manager.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "splinter_cli.h"
+#include "argparse.h"
+
+static const char *modname = "tier";
+
+/* The bid a tier pass runs under, unless --shard says otherwise. */
+#define TIER_SHARD_ID 0x7E1A
+
+static const char *const usages[] = {
+    "tier pass [--shard id] [--cold passes] [--prio p] [--wait ms] [--pageout]",
+    "tier run  [--interval ms] [same as pass]",
+    NULL,
+};
+
+void help_cmd_tier(unsigned int level) {
+    (void) level;
+    printf("%s keeps the working set resident: values nobody touches are paged\n", modname);
+    printf("out, and the ones that come back are prefetched.\n");
+    printf("Usage: %s [on | off]\n", modname);
+    printf("       %s pass [--shard id] [--cold passes] [--prio p] [--wait ms] [--pageout]\n", modname);
+    printf("       %s run  [--interval ms] [options as for pass]\n", modname);
+    printf("'%s on' has every access mark its slot. Each pass ages the marks; a value\n", modname);
+    printf("idle for --cold passes (default 4) is advised MADV_COLD, or MADV_PAGEOUT\n");
+    printf("with --pageout. All advice goes through the shard election under bid\n");
+    printf("--shard (default 0x%X) at --prio (default 0), so any live completer\n", TIER_SHARD_ID);
+    printf("outranks it; --wait ms blocks for sovereignty instead of deferring.\n");
+    printf("'%s run' repeats the pass every --interval ms (default 1000) until\n", modname);
+    printf("CTRL-] or SIGUSR1. Run one tier manager per store.\n");
+    return;
+}
+
+static void tier_print(const splinter_tier_report_t *rep) {
+    printf("scanned %u, hot %u, cold %u, rising %u; advised out %lu KiB, in %lu KiB%s\n",
+           rep->scanned, rep->hot, rep->cold, rep->rising,
+           rep->cold_bytes / 1024, rep->warm_bytes / 1024,
+           rep->deferred ? " (deferred)" : "");
+}
+
+int cmd_tier(int argc, char *argv[]) {
+    splinter_tier_policy_t pol = { 0 };
+    splinter_tier_report_t rep = { 0 };
+    int shard = TIER_SHARD_ID, cold = 0, prio = 0, wait_ms = 0, pageout = 0, interval = 1000;
+
+    if (!thisuser.store_conn) {
+        fprintf(stderr, "%s: not connected to a store.\n", modname);
+        return -1;
+    }
+
+    if (argc < 2) {
+        printf("tiering: %s\n\n", splinter_get_tiering() == 1 ? "on" : "off");
+        return 0;
+    }
+    if (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))
+        return splinter_set_tiering(!strcmp(argv[1], "on"));
+
+    int run = !strcmp(argv[1], "run");
+    if (!run && strcmp(argv[1], "pass")) {
+        help_cmd_tier(1);
+        return -1;
+    }
+
+    struct argparse_option options[] = {
+        OPT_HELP(),
+        OPT_INTEGER('s', "shard", &shard, "Shard id to bid under", NULL, 0, 0),
+        OPT_INTEGER('c', "cold", &cold, "Idle passes before a value is cold (1-63)", NULL, 0, 0),
+        OPT_INTEGER('p', "prio", &prio, "Bid priority (0-255)", NULL, 0, 0),
+        OPT_INTEGER('w', "wait", &wait_ms, "Milliseconds to wait for sovereignty", NULL, 0, 0),
+        OPT_BOOLEAN('o', "pageout", &pageout, "Page cold values out instead of MADV_COLD", NULL, 0, 0),
+        OPT_INTEGER('i', "interval", &interval, "Milliseconds between passes (run)", NULL, 0, 0),
+        OPT_END(),
+    };
+
+    struct argparse argparse;
+    argparse_init(&argparse, options, usages, 0);
+    argparse_describe(&argparse, "\nManage hot and cold pages", "\nAdvice is cooperative; see 'help shard'.");
+    argc = argparse_parse(&argparse, argc - 1, (const char **)argv + 1);
+    if (argc != 0 || shard <= 0 || cold < 0 || cold > 63 || prio < 0 || prio > 255 ||
+        wait_ms < 0 || interval <= 0) {
+        help_cmd_tier(1);
+        return -1;
+    }
+    pol.cold_passes = (uint8_t)cold;
+    pol.priority = (uint8_t)prio;
+    pol.pageout = pageout ? 1 : 0;
+    pol.timeout_ticks = splinter_ns_to_ticks((uint64_t)wait_ms * NS_PER_MS);
+
+    if (splinter_get_tiering() != 1)
+        fprintf(stderr, "%s: accesses are not being marked; try '%s on' first.\n", modname, modname);
+
+    if (!run) {
+        if (splinter_tier_pass((uint32_t)shard, &pol, &rep) != 0) {
+            fprintf(stderr, "%s: pass failed: %s\n", modname, strerror(errno));
+            return -1;
+        }
+        tier_print(&rep);
+        puts("");
+        return 0;
+    }
+
+    struct timespec pause = { interval / 1000, (long)(interval % 1000) * 1000000L };
+    char c;
+    setup_terminal();
+    puts("Press `<ctrl> + ]` to stop the tier manager ...");
+    while (!thisuser.abort) {
+        if (read(STDIN_FILENO, &c, 1) == 1 && c == 29)   // Ctrl-] is ASCII 29
+            break;
+        if (splinter_tier_pass((uint32_t)shard, &pol, &rep) != 0)
+            fprintf(stderr, "%s: pass failed: %s\n", modname, strerror(errno));
+        else if (rep.cold_bytes || rep.warm_bytes || rep.deferred)
+            tier_print(&rep);
+        fflush(stdout);
+        nanosleep(&pause, NULL);
+    }
+    thisuser.abort = 0;
+    restore_terminal();
+    puts("");
+    return 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2025 Tim Post
+ * License: Apache 2 (MIT available upon request to timthepost@protonmail.com)
+ *
+ * @file splinter_cli_cmd_ttl.c
+ * @brief Implements the CLI 'ttl' command.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "splinter_cli.h"
+
+static const char *modname = "ttl";
+
+void help_cmd_ttl(unsigned int level) {
+    (void) level;
+    printf("%s shows or sets a key's time-to-live.\n", modname);
+    printf("Usage: %s <key_name> [seconds]\n", modname);
+    printf("With no seconds, prints the seconds left (0 = no TTL).\n");
+    printf("A value of 0 removes the TTL. Expired keys read as absent.\n");
+    return;
+}
+
+int cmd_ttl(int argc, char *argv[]) {
+    char key[SPLINTER_KEY_MAX] = { 0 };
+    char *tmp = getenv("SPLINTER_NS_PREFIX");
+
+    if (argc < 2 || argc > 3) {
+        help_cmd_ttl(1);
+        return -1;
+    }
+
+    snprintf(key, sizeof(key) - 1, "%s%s", tmp == NULL ? "" : tmp, argv[1]);
+
+    if (argc == 2) {
+        int64_t left = splinter_get_ttl(key);
+        if (left < 0) {
+            fprintf(stderr, "%s: unable to find key '%s'\n", modname, key);
+            return -1;
+        }
+        printf("%lld\n", (long long)left);
+    } else {
+        int secs = cli_safer_atoi(argv[2]);
+        if (secs < 0) {
+            fprintf(stderr, "%s: invalid number of seconds: %s\n", modname, argv[2]);
+            return -1;
+        }
+        if (splinter_set_ttl(key, (uint32_t)secs) != 0) {
+            fprintf(stderr, "%s: unable to set TTL on '%s': %s\n", modname, key,
+                errno == EAGAIN ? "slot busy, try again" : "key not found");
+            return -1;
+        }
+    }
+
+    // Empty line is intentional (and uniform throughout commands)
+    puts("");
+    return 0;
+}
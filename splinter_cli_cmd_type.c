@@ -35,8 +35,8 @@ int cmd_type(int argc, char *argv[]) {
     }
 
     snprintf(key, sizeof(key) - 1, "%s%s", tmp == NULL ? "" : tmp, argv[1]);
-    if (splinter_get_slot_snapshot(key, &snap) != 0) {
-        perror("splinter_get_slot_snapshot");
+    if (splinter_get_slot_snapshot_ex(key, &snap, SPL_SNAP_TYPE) != 0) {
+        perror("splinter_get_slot_snapshot_ex");
         return -1;
     }
 
@@ -265,9 +265,72 @@ cli_module_t command_modules[] = {
         &cmd_retrain,
         &help_cmd_retrain
     },
-#ifdef HAVE_EMBEDDINGS
     {
         25,
+        "scan",
+        4,
+        "List keys in order by prefix or range (ordered key index)",
+        -1,
+        &cmd_scan,
+        &help_cmd_scan
+    },
+    {
+        26,
+        "ttl",
+        3,
+        "Show or set a key's time-to-live in seconds",
+        -1,
+        &cmd_ttl,
+        &help_cmd_ttl
+    },
+    {
+        27,
+        "resize",
+        6,
+        "Grow or shrink the open store without downtime",
+        -1,
+        &cmd_resize,
+        &help_cmd_resize
+    },
+    {
+        28,
+        "purge",
+        5,
+        "Zero stale value bytes in bounded slices",
+        -1,
+        &cmd_purge,
+        &help_cmd_purge
+    },
+    {
+        29,
+        "stats",
+        5,
+        "Show or reset the store's operation counters",
+        -1,
+        &cmd_stats,
+        &help_cmd_stats
+    },
+    {
+        30,
+        "tier",
+        4,
+        "Page out cold values and prefetch rising ones, cooperatively",
+        -1,
+        &cmd_tier,
+        &help_cmd_tier
+    },
+    {
+        31,
+        "mem",
+        3,
+        "Show which parts of the store are resident and where value bytes go",
+        -1,
+        &cmd_mem,
+        &help_cmd_mem
+    },
+#ifdef HAVE_EMBEDDINGS
+    {
+        32,
         "search",
         6,
         "Search embedded keys by semantic similarity and distance",
@@ -276,7 +339,7 @@ cli_module_t command_modules[] = {
         &help_cmd_search
     },
     {
-        26,
+        33,
         "ingest",
         6,
         "Ingest a file or stdin as chunked tandem slots for splinference",
@@ -288,9 +351,9 @@ cli_module_t command_modules[] = {
 #ifdef HAVE_WASM
     {
 #ifdef HAVE_EMBEDDINGS
-        27,
+        34,
 #else
-        25,
+        32,
 #endif
         "wasm",
         4,
@@ -302,15 +365,15 @@ cli_module_t command_modules[] = {
 #endif // HAVE_WASM
 #ifdef HAVE_LUA
     {
-        /* id == array index: 25 base (incl. retrain) + 2 if embeddings (search,ingest) + 1 if wasm */
+        /* id == array index: 32 base (incl. tier, mem) + 2 if embeddings (search,ingest) + 1 if wasm */
 #if defined(HAVE_EMBEDDINGS) && defined(HAVE_WASM)
-        28,
+        35,
 #elif defined(HAVE_EMBEDDINGS)
-        27,
+        34,
 #elif defined(HAVE_WASM)
-        26,
+        33,
 #else
-        25,
+        32,
 #endif
         "lua",
         3,
@@ -485,20 +548,29 @@ static void completion(const char *buf, linenoiseCompletions *lc) {
             break;
         case 'm':
             linenoiseAddCompletion(lc, "math");
+            linenoiseAddCompletion(lc, "mem");
             break;
         case 'o':
             linenoiseAddCompletion(lc, "orders");
             break;
+        case 'p':
+            linenoiseAddCompletion(lc, "purge");
+            break;
         case 'r':
             linenoiseAddCompletion(lc, "retrain");
+            linenoiseAddCompletion(lc, "resize");
             break;
         case 's':
             linenoiseAddCompletion(lc, "set");
+            linenoiseAddCompletion(lc, "scan");
 #ifdef HAVE_EMBEDDINGS
             linenoiseAddCompletion(lc, "search");
 #endif // HAVE_EMBEDDINGS
+            linenoiseAddCompletion(lc, "stats");
             break;
         case 't':
+            linenoiseAddCompletion(lc, "ttl");
+            linenoiseAddCompletion(lc, "tier");
             linenoiseAddCompletion(lc, "type");
             break;
         case 'u':
@@ -191,7 +191,7 @@ void cli_show_key_config(const char *key, const char *caller) {
     printf("hash:       %lu\n", snap.hash);
     printf("epoch:      %lu\n", snap.epoch);
     printf("bloom:      %lu (0b%s)\n", snap.bloom, fmt_binary(snap.bloom));
-    printf("val_off:    %u\n", snap.val_off);
+    printf("val_off:    %lu\n", snap.val_off);
     printf("val_len:    %u\n", snap.val_len);
     printf("ctime:      %lu\n", snap.ctime);
     printf("atime:      %lu\n", snap.atime);
@@ -232,6 +232,39 @@ int cli_safer_atoi(const char *string) {
     }
 }
 
+/**
+ * @brief Parse a size such as 4096, 0x1000, 64k, 16M or 8G (binary units,
+ * case-insensitive, an optional trailing 'b' or 'ib' allowed).
+ * @return 0 with *out set, or -1 on a malformed, negative or overflowing size.
+ */
+int cli_parse_size(const char *string, unsigned long *out) {
+    char *end;
+    unsigned long long v;
+    unsigned int shift = 0;
+
+    if (!string || !*string || strchr(string, '-'))
+        return -1;
+    errno = 0;
+    v = strtoull(string, &end, 0);
+    if (errno || end == string)
+        return -1;
+    switch (*end) {
+    case 'k': case 'K': shift = 10; end++; break;
+    case 'm': case 'M': shift = 20; end++; break;
+    case 'g': case 'G': shift = 30; end++; break;
+    case 't': case 'T': shift = 40; end++; break;
+    default: break;
+    }
+    if (shift && (*end == 'i' || *end == 'I'))
+        end++;
+    if (*end == 'b' || *end == 'B')
+        end++;
+    if (*end || v > (ULONG_MAX >> shift))
+        return -1;
+    *out = (unsigned long)(v << shift);
+    return 0;
+}
+
 /**
  * @brief Parses ~/.splinterrc to populate the label map in thisuser.
  * Format: LABEL_NAME 0xMASK (e.g., ANGRY 0x1)
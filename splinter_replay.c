@@ -0,0 +1,411 @@
+/**
+ * Replay traces written by splinter_trace_start() (or SPLINTER_TRACE=<path>)
+ * against a fresh store.
+ *
+ * Every traced pid gets its own thread, which re-issues that pid's calls in
+ * order. With --speed S (default 1) each call waits until its original offset
+ * from the start of the trace, divided by S, has passed; --speed 0 issues calls
+ * back to back. Traces keep only key hashes, so each key is replayed under a
+ * name derived from its hash ("h<hash>"): the access pattern is the same, the
+ * slots the keys land in are not. Keys the trace reads before it writes them
+ * existed before tracing began; they are created first, with the length the
+ * trace saw, and counters are typed BIGUINT.
+ *
+ * Calls that failed with EAGAIN when traced are skipped (the caller's retry
+ * follows them in the trace), and replayed calls retry EAGAIN themselves.
+ * The report gives the wall time, ops/s, and per call how many calls were
+ * replayed and how many came out differently (success vs. failure) than
+ * they did when traced.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "splinter.h"
+#include "config.h"
+
+static const char *const op_names[SPL_TRACE_OPS] = {
+    "get", "set", "unset", "append", "integer_op"
+};
+
+typedef struct {
+    const char *store_name;
+    long slots;
+    long max_value_size;
+    double speed;
+    int json;
+} cfg_t;
+
+/* All of one traced pid's records, in the order it made the calls. */
+typedef struct {
+    uint32_t pid;
+    splinter_trace_record_t *recs;
+    size_t n, cap;
+    uint64_t calls[SPL_TRACE_OPS];
+    uint64_t diverged[SPL_TRACE_OPS];
+    uint64_t contended;
+} stream_t;
+
+typedef struct {
+    stream_t *streams;
+    size_t n, cap;
+    uint64_t first_ts;
+    uint64_t last_ts;
+    uint64_t tick_hz;
+    uint64_t slots;
+    uint64_t max_val_sz;
+    uint64_t dropped;
+} trace_t;
+
+typedef struct {
+    const cfg_t *cfg;
+    const trace_t *tr;
+    stream_t *st;
+    _Atomic int *go;
+    uint64_t start;
+} replayer_t;
+
+static inline double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void store_path(const char *name, char *path, size_t len) {
+#ifndef SPLINTER_PERSISTENT
+    snprintf(path, len, "/dev/shm/%s", name);
+#else
+    snprintf(path, len, "./%s", name);
+#endif /* SPLINTER_PERSISTENT */
+}
+
+static inline void key_name(char *buf, size_t len, uint64_t hash) {
+    snprintf(buf, len, "h%016llx", (unsigned long long)hash);
+}
+
+static stream_t *stream_for(trace_t *tr, uint32_t pid) {
+    for (size_t i = 0; i < tr->n; i++)
+        if (tr->streams[i].pid == pid) return &tr->streams[i];
+    if (tr->n == tr->cap) {
+        size_t cap = tr->cap ? tr->cap * 2 : 8;
+        stream_t *s = realloc(tr->streams, cap * sizeof(*s));
+        if (!s) return NULL;
+        tr->streams = s;
+        tr->cap = cap;
+    }
+    memset(&tr->streams[tr->n], 0, sizeof(stream_t));
+    tr->streams[tr->n].pid = pid;
+    return &tr->streams[tr->n++];
+}
+
+static int load_trace(trace_t *tr, const char *path) {
+    splinter_trace_header_t hdr;
+    splinter_trace_record_t rec;
+    FILE *f = fopen(path, "rb");
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, SPLINTER_TRACE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != SPLINTER_TRACE_VER || hdr.rec_size != sizeof(rec)) {
+        fprintf(stderr, "%s: not a splinter trace (or a different version)\n", path);
+        fclose(f);
+        return -1;
+    }
+    if (!tr->tick_hz) tr->tick_hz = hdr.tick_hz;
+    if (hdr.slots > tr->slots) tr->slots = hdr.slots;
+    if (hdr.max_val_sz > tr->max_val_sz) tr->max_val_sz = hdr.max_val_sz;
+    tr->dropped += hdr.dropped;
+
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        stream_t *st;
+        if (rec.op >= SPL_TRACE_OPS) continue;
+        if (!(st = stream_for(tr, rec.pid))) goto nomem;
+        if (st->n == st->cap) {
+            size_t cap = st->cap ? st->cap * 2 : 1024;
+            splinter_trace_record_t *r = realloc(st->recs, cap * sizeof(*r));
+            if (!r) goto nomem;
+            st->recs = r;
+            st->cap = cap;
+        }
+        st->recs[st->n++] = rec;
+        if (!tr->first_ts || rec.ts < tr->first_ts) tr->first_ts = rec.ts;
+        if (rec.ts > tr->last_ts) tr->last_ts = rec.ts;
+    }
+    fclose(f);
+    return 0;
+
+nomem:
+    fprintf(stderr, "%s: out of memory\n", path);
+    fclose(f);
+    return -1;
+}
+
+static int by_key_then_ts(const void *a, const void *b) {
+    const splinter_trace_record_t *x = a, *y = b;
+    if (x->key_hash != y->key_hash) return x->key_hash < y->key_hash ? -1 : 1;
+    return x->ts < y->ts ? -1 : x->ts > y->ts;
+}
+
+/*
+ * Create the keys that existed before tracing began: those whose first
+ * traced call found them (a successful get, append, unset or integer op).
+ */
+static int seed_keys(const trace_t *tr, const char *val, size_t max_val) {
+    size_t total = 0, k = 0;
+    splinter_trace_record_t *all;
+    char key[SPLINTER_KEY_MAX];
+    uint64_t zero = 0;
+
+    for (size_t i = 0; i < tr->n; i++) total += tr->streams[i].n;
+    if (!total) return 0;
+    if (!(all = malloc(total * sizeof(*all)))) return -1;
+    for (size_t i = 0; i < tr->n; i++) {
+        memcpy(all + k, tr->streams[i].recs, tr->streams[i].n * sizeof(*all));
+        k += tr->streams[i].n;
+    }
+    qsort(all, total, sizeof(*all), by_key_then_ts);
+
+    for (k = 0; k < total; k++) {
+        const splinter_trace_record_t *r = &all[k];
+        if (k && all[k - 1].key_hash == r->key_hash) continue;
+        if (r->op == SPL_TRACE_SET || r->result != 0) continue;
+        key_name(key, sizeof(key), r->key_hash);
+        if (r->op == SPL_TRACE_INTEGER_OP) {
+            splinter_set(key, &zero, sizeof(zero));
+            splinter_set_named_type(key, SPL_SLOT_TYPE_BIGUINT);
+        } else {
+            size_t len = r->val_len ? r->val_len : 1;
+            splinter_set(key, val, len < max_val ? len : max_val);
+        }
+    }
+    free(all);
+    return 0;
+}
+
+static void *replay_main(void *arg) {
+    replayer_t *rp = arg;
+    const cfg_t *cfg = rp->cfg;
+    stream_t *st = rp->st;
+    char key[SPLINTER_KEY_MAX];
+    char *val = malloc((size_t)cfg->max_value_size);
+    char *buf = malloc((size_t)cfg->max_value_size);
+    uint64_t one = 1;
+
+    if (!val || !buf) {
+        free(val);
+        free(buf);
+        return NULL;
+    }
+    memset(val, 'r', (size_t)cfg->max_value_size);
+    while (!atomic_load(rp->go))
+        ;
+
+    for (size_t i = 0; i < st->n; i++) {
+        const splinter_trace_record_t *r = &st->recs[i];
+        size_t len = r->val_len > (uint32_t)cfg->max_value_size ? (size_t)cfg->max_value_size
+                                                                 : r->val_len;
+        int rc;
+
+        /* a traced EAGAIN was contention; the caller's retry is the next record */
+        if (r->result == -1 && r->err == EAGAIN) {
+            st->contended++;
+            continue;
+        }
+        if (cfg->speed > 0) {
+            /* trace ticks may come from another host; go through ns */
+            double off_ns = (double)(r->ts - rp->tr->first_ts) * 1e9 / (double)rp->tr->tick_hz;
+            uint64_t due = rp->start + splinter_ns_to_ticks((uint64_t)(off_ns / cfg->speed));
+            int64_t wait = (int64_t)(due - splinter_now());
+            if (wait > 0) {
+                uint64_t ns = splinter_ticks_to_ns((uint64_t)wait);
+                /* sleep the bulk of a long wait, spin the last stretch */
+                if (ns > 100000) {
+                    struct timespec ts = { (time_t)((ns - 50000) / 1000000000ull),
+                                           (long)((ns - 50000) % 1000000000ull) };
+                    nanosleep(&ts, NULL);
+                }
+                while ((int64_t)(due - splinter_now()) > 0)
+                    ;
+            }
+        }
+
+        key_name(key, sizeof(key), r->key_hash);
+retry:
+        errno = 0;
+        switch (r->op) {
+        case SPL_TRACE_GET:
+            rc = splinter_get(key, buf, (size_t)cfg->max_value_size, NULL);
+            break;
+        case SPL_TRACE_SET:
+            rc = splinter_set(key, val, len ? len : 1);
+            break;
+        case SPL_TRACE_UNSET:
+            rc = splinter_unset(key);
+            break;
+        case SPL_TRACE_APPEND:
+            rc = splinter_append(key, val, len ? len : 1, NULL);
+            break;
+        default:
+            /* the mask is not traced; 1 keeps INC/DEC meaningful */
+            rc = splinter_integer_op(key, (splinter_integer_op_t)r->arg, &one);
+            break;
+        }
+        if (rc == -1 && errno == EAGAIN) goto retry;
+        st->calls[r->op]++;
+        if ((rc < 0) != (r->result < 0)) st->diverged[r->op]++;
+    }
+    free(val);
+    free(buf);
+    return NULL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "\nUsage: %s [arguments] TRACE [TRACE ...]\nWhere arguments are:\n"
+        "\t  [--speed S] (1 = as traced, 2 = twice as fast, 0 = no waiting)\n"
+        "\t  [--slots S] [--max-value B] (default: the traced store's geometry)\n"
+        "\t  [--store NAME] [--format text|json]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    char store[64] = { 0 }, path[128];
+    trace_t tr = { 0 };
+    replayer_t *rp = NULL;
+    pthread_t *tids = NULL;
+    _Atomic int go = 0;
+    uint64_t calls[SPL_TRACE_OPS] = { 0 }, diverged[SPL_TRACE_OPS] = { 0 }, all = 0, bad = 0;
+    uint64_t contended = 0;
+    size_t i, started = 0;
+    int files = 0, rc = 1;
+
+    snprintf(store, sizeof(store) - 1, "replay_%u", (unsigned)getpid());
+    cfg_t cfg = { .store_name = store, .slots = 0, .max_value_size = 0, .speed = 1.0 };
+
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--speed") && a+1 < argc) cfg.speed = atof(argv[++a]);
+        else if (!strcmp(argv[a], "--slots") && a+1 < argc) cfg.slots = atol(argv[++a]);
+        else if (!strcmp(argv[a], "--max-value") && a+1 < argc) cfg.max_value_size = atol(argv[++a]);
+        else if (!strcmp(argv[a], "--store") && a+1 < argc) cfg.store_name = argv[++a];
+        else if (!strcmp(argv[a], "--format") && a+1 < argc) cfg.json = !strcmp(argv[++a], "json");
+        else if (argv[a][0] == '-') { usage(argv[0]); return 2; }
+        else {
+            if (load_trace(&tr, argv[a]) != 0) return 1;
+            files++;
+        }
+    }
+    if (!files || cfg.speed < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!tr.n) {
+        fprintf(stderr, "no records to replay\n");
+        return 1;
+    }
+    if (!cfg.slots) cfg.slots = tr.slots ? (long)tr.slots : 65536;
+    if (!cfg.max_value_size) cfg.max_value_size = tr.max_val_sz ? (long)tr.max_val_sz : 4096;
+
+    store_path(cfg.store_name, path, sizeof(path));
+    unlink(path);
+    if (splinter_create(cfg.store_name, (size_t)cfg.slots, (size_t)cfg.max_value_size) != 0) {
+        perror("splinter_create");
+        return 1;
+    }
+
+    char *val = malloc((size_t)cfg.max_value_size);
+    rp = calloc(tr.n, sizeof(*rp));
+    tids = calloc(tr.n, sizeof(*tids));
+    if (!val || !rp || !tids) {
+        perror("calloc");
+        free(val);
+        goto out;
+    }
+    memset(val, 's', (size_t)cfg.max_value_size);
+    if (seed_keys(&tr, val, (size_t)cfg.max_value_size) != 0) {
+        perror("seed");
+        free(val);
+        goto out;
+    }
+    free(val);
+
+    for (i = 0; i < tr.n; i++) {
+        rp[i] = (replayer_t){ .cfg = &cfg, .tr = &tr, .st = &tr.streams[i], .go = &go };
+        if (pthread_create(&tids[i], NULL, replay_main, &rp[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+    /* give every thread the same start, a little in the future */
+    uint64_t start = splinter_now() + splinter_ns_to_ticks(1000000);
+    for (i = 0; i < started; i++) rp[i].start = start;
+    double t0 = now_us();
+    atomic_store(&go, 1);
+    for (i = 0; i < started; i++) pthread_join(tids[i], NULL);
+    double secs = (now_us() - t0) / 1e6;
+    if (started != tr.n) goto out;
+
+    for (i = 0; i < tr.n; i++) {
+        for (int op = 0; op < SPL_TRACE_OPS; op++) {
+            calls[op] += tr.streams[i].calls[op];
+            diverged[op] += tr.streams[i].diverged[op];
+        }
+        contended += tr.streams[i].contended;
+    }
+    for (int op = 0; op < SPL_TRACE_OPS; op++) {
+        all += calls[op];
+        bad += diverged[op];
+    }
+    double traced_s = (double)(tr.last_ts - tr.first_ts) / (double)tr.tick_hz;
+
+    if (cfg.json) {
+        printf("{\"files\":%d,\"pids\":%zu,\"calls\":%llu,\"dropped\":%llu,\"speed\":%.2f,"
+               "\"traced_s\":%.3f,\"replay_s\":%.3f,\"ops_per_sec\":%.0f,\"diverged\":%llu,"
+               "\"contended\":%llu,\"results\":[", files, tr.n, (unsigned long long)all,
+               (unsigned long long)tr.dropped, cfg.speed, traced_s, secs, all / secs,
+               (unsigned long long)bad, (unsigned long long)contended);
+        int first = 1;
+        for (int op = 0; op < SPL_TRACE_OPS; op++) {
+            if (!calls[op]) continue;
+            printf("%s{\"op\":\"%s\",\"calls\":%llu,\"diverged\":%llu}", first ? "" : ",",
+                   op_names[op], (unsigned long long)calls[op], (unsigned long long)diverged[op]);
+            first = 0;
+        }
+        puts("]}");
+    } else {
+        puts("===== REPLAY =====");
+        printf("Traces   : %d file%s, %zu pid%s, %llu calls (%llu dropped while tracing)\n",
+               files, files == 1 ? "" : "s", tr.n, tr.n == 1 ? "" : "s",
+               (unsigned long long)all, (unsigned long long)tr.dropped);
+        printf("Speed    : %s\nTraced   : %.3f s\nReplayed : %.3f s (%.0f ops/sec)\n",
+               cfg.speed > 0 ? (cfg.speed == 1.0 ? "as traced" : "scaled") : "no waiting",
+               traced_s, secs, all / secs);
+        printf("Skipped  : %llu traced EAGAIN retries\n\n", (unsigned long long)contended);
+        puts("op              calls   diverged");
+        for (int op = 0; op < SPL_TRACE_OPS; op++) {
+            if (!calls[op]) continue;
+            printf("%-12s %10llu %10llu\n", op_names[op], (unsigned long long)calls[op],
+                   (unsigned long long)diverged[op]);
+        }
+    }
+    rc = 0;
+
+out:
+    for (i = 0; i < tr.n; i++) free(tr.streams[i].recs);
+    free(tr.streams);
+    free(tids);
+    free(rp);
+    splinter_close();
+    unlink(path);
+    return rc;
+}
@@ -30,6 +30,8 @@ typedef struct {
     int num_keys;
     int writer_period_us;
     int scrub;
+    long arena_mb;
+    long ballast_mb;
 } cfg_t;
 
 typedef struct {
@@ -248,11 +250,63 @@ static void prepopulate(shared_t *sh) {
     }
 }
 
+/*
+ * Ballast: max-size values laid down before the hot keys, so that on a store
+ * with a large arena (--arena-mb) everything the run allocates afterwards
+ * sits past the ballast, e.g. above the 4 GiB line. Each ballast value is a
+ * per-key byte pattern, checked again once the run is over.
+ */
+static int lay_ballast(cfg_t *cfg) {
+    splinter_header_snapshot_t hs = { 0 };
+    const uint64_t want = (uint64_t)cfg->ballast_mb << 20;
+    char key[32];
+    char *buf = malloc((size_t)cfg->max_value_size);
+    int n = 0;
+
+    if (!buf) { perror("malloc"); return 0; }
+    splinter_get_header_snapshot(&hs);
+    while (hs.arena_brk < want) {
+        snprintf(key, sizeof(key), "b%08d", n);
+        memset(buf, (n * 31 + 7) & 0xff, (size_t)cfg->max_value_size);
+        if (splinter_set(key, buf, (size_t)cfg->max_value_size) != 0) {
+            perror("ballast splinter_set");
+            break;
+        }
+        n++;
+        splinter_get_header_snapshot(&hs);
+    }
+    printf("Ballast  : %d keys, arena break at %lu bytes%s\n", n,
+           (unsigned long)hs.arena_brk,
+           hs.arena_brk > UINT32_MAX ? " (past 4 GiB)" : "");
+    free(buf);
+    return n;
+}
+
+static int check_ballast(cfg_t *cfg, int n) {
+    char key[32];
+    char *buf = malloc((size_t)cfg->max_value_size);
+    size_t got = 0;
+    int bad = 0, i;
+
+    if (!buf) { perror("malloc"); return n; }
+    for (i = 0; i < n; i++) {
+        snprintf(key, sizeof(key), "b%08d", i);
+        if (splinter_get(key, buf, (size_t)cfg->max_value_size, &got) != 0
+            || got != (size_t)cfg->max_value_size
+            || (unsigned char)buf[0] != ((i * 31 + 7) & 0xff)
+            || memcmp(buf, buf + 1, got - 1) != 0)
+            bad++;
+    }
+    free(buf);
+    return bad;
+}
+
 static void usage(const char *prog) {
     fprintf(stderr,
         "\nUsage: %s [arguments]\nWhere arguments are:\n\t  [--threads N] [--duration-ms D] [--keys K]\n"
         "\t  [--slots S] [--max-value B] [--writer-us U]\n"
-        "\t  [--quiet] [--keep-test-store] [--scrub] [--store NAME]\n", prog);
+        "\t  [--quiet] [--keep-test-store] [--scrub] [--store NAME]\n"
+        "\t  [--arena-mb M] [--ballast-mb B]\n", prog);
 }
 
 int main(int argc, char **argv) {
@@ -302,6 +356,8 @@ int main(int argc, char **argv) {
         else if (!strcmp(argv[i], "--slots") && i+1 < argc) cfg.slots = atoi(argv[++i]);
         else if (!strcmp(argv[i], "--max-value") && i+1 < argc) cfg.max_value_size = atoi(argv[++i]);
         else if (!strcmp(argv[i], "--writer-us") && i+1 < argc) cfg.writer_period_us = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--arena-mb") && i+1 < argc) cfg.arena_mb = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--ballast-mb") && i+1 < argc) cfg.ballast_mb = atol(argv[++i]);
         else if (!strcmp(argv[i], "--quiet")) quiet = 1;
         else if (!strcmp(argv[i], "--keep-test-store")) keep_store = 1;
         else if (!strcmp(argv[i], "--scrub")) scrub = 1;
@@ -312,7 +368,13 @@ int main(int argc, char **argv) {
 
     if (cfg.num_threads < 2) cfg.num_threads = 2;
 
-    if (splinter_create_or_open(cfg.store_name, cfg.slots, cfg.max_value_size) != 0) {
+    if (cfg.arena_mb > 0) {
+        if (splinter_create_ex(cfg.store_name, (size_t)cfg.slots, (size_t)cfg.max_value_size,
+                               (size_t)cfg.arena_mb << 20) != 0) {
+            perror("splinter_create_ex");
+            return 1;
+        }
+    } else if (splinter_create_or_open(cfg.store_name, cfg.slots, cfg.max_value_size) != 0) {
         perror("splinter_create_or_open");
         return 1;
     }
@@ -362,6 +424,12 @@ int main(int argc, char **argv) {
     sleep(5);
 #endif /* SPLINTER_PERSISTENT */
 
+    int ballast = 0;
+    if (cfg.ballast_mb > 0) {
+        printf("Laying %ld MB of ballast ...\n", cfg.ballast_mb);
+        ballast = lay_ballast(&cfg);
+    }
+
     printf("Pre-populating store with indexed backfill (%d keys) ...\n", cfg.num_keys);
     prepopulate(&sh);
 
@@ -419,6 +487,11 @@ int main(int argc, char **argv) {
 
     for (i = 0; i < cfg.num_threads; i++) pthread_join(th[i], NULL);
     long elapsed = now_ms() - start;
+    if (ballast) {
+        int torn = check_ballast(&cfg, ballast);
+        if (torn) fprintf(stderr, "Ballast  : %d of %d values damaged\n", torn, ballast);
+        atomic_fetch_add(&ctr.integrity_fail, torn);
+    }
     splinter_close();
     if (! keep_store) {
 #ifndef SPLINTER_PERSISTENT
@@ -23,6 +23,9 @@
 #include <fcntl.h>
 #include <stdalign.h>
 #include <sys/mman.h>   /* POSIX_MADV_* for splinter_madvise() tests */
+#include <sys/wait.h>   /* waitpid() for the resize follower */
+#include <sys/stat.h>   /* stat() for the trace size checks */
+#include <signal.h>     /* kill() for the dead resizer */
 
 #ifdef HAVE_VALGRIND_H
 #include <valgrind/valgrind.h>
@@ -45,6 +48,21 @@ static void test_enum_callback(const char *key, uint64_t epoch, void *data) {
     (void)epoch; // unused in this specific check
 }
 
+/* Tracker for ordered scans: counts keys and checks they arrive sorted */
+struct order_tracker {
+    int count;
+    int sorted;
+    char last_key[SPLINTER_KEY_MAX];
+};
+
+static void test_order_callback(const char *key, uint64_t epoch, void *data) {
+    struct order_tracker *t = (struct order_tracker *)data;
+    if (t->count && strncmp(t->last_key, key, SPLINTER_KEY_MAX) >= 0) t->sorted = 0;
+    t->count++;
+    strncpy(t->last_key, key, SPLINTER_KEY_MAX - 1);
+    (void)epoch;
+}
+
 /* 
  * Returns true on success, false if the value cannot be represented. 
  * Older data loggers can wake up pre-1970 on battery changes, so we
@@ -96,9 +114,28 @@ static pid_t pid = 0;
 #define PATH_MAX 4096
 #endif
 
+/* Create a scratch store named "<pid>-tap-<tag>" into name; returns splinter_create_ex()'s result. */
+static int fresh_store(char *name, size_t name_sz, const char *tag,
+                       size_t slots, size_t max_val, size_t arena) {
+  snprintf(name, name_sz, "%d-tap-%s", (int)pid, tag);
+  return splinter_create_ex(name, slots, max_val, arena);
+}
+
+/* Close the current store and remove its backing file. */
+static void drop_store(const char *name) {
+  char path[PATH_MAX];
+
+  splinter_close();
+#ifndef SPLINTER_PERSISTENT
+  snprintf(path, sizeof(path), "/dev/shm/%s", name);
+#else
+  snprintf(path, sizeof(path), "./%s", name);
+#endif /* SPLINTER_PERSISTENT */
+  unlink(path);
+}
+
 int main(void) {
   char bus[16] = { 0 };
-  char buspath[PATH_MAX] = { 0 };
   pid = getpid();
 
   snprintf(bus, 16, "%d-tap-test", pid);
@@ -152,6 +189,7 @@ int main(void) {
   TEST("take snapshot of header_snap slot metadata", splinter_get_slot_snapshot("header_snap", &snap1) == 0);
   TEST("snap1 epoch is nonzero", snap1.epoch > 0);
   TEST("length of header_snap is 5: h e l l o", snap1.val_len == 5);
+  TEST("a key in a never-used slot gets the default type", snap1.type_flag == SPL_SLOT_DEFAULT_TYPE);
 
   splinter_slot_snapshot_t snap2 = { 0 };
   TEST("name slot as text", splinter_set_named_type("header_snap", SPL_SLOT_TYPE_VARTEXT) == 0);
@@ -159,6 +197,17 @@ int main(void) {
   TEST("ensure header_snap is SPL_SLOT_TYPE_VARTEXT", (snap2.type_flag & SPL_SLOT_TYPE_VARTEXT) != 0);
   TEST("ensure header_snap is not also SPL_SLOT_TYPE_JSON", (snap2.type_flag & SPL_SLOT_TYPE_JSON) == 0);
 
+  splinter_slot_snapshot_t snapm;
+  memset(&snapm, 0xAB, sizeof(snapm));
+  TEST("type-only snapshot of header_snap",
+       splinter_get_slot_snapshot_ex("header_snap", &snapm, SPL_SNAP_TYPE) == 0);
+  TEST("type-only snapshot carries epoch and type",
+       snapm.epoch == snap2.epoch && snapm.type_flag == snap2.type_flag);
+  TEST("type-only snapshot leaves key and length untouched",
+       (unsigned char)snapm.key[0] == 0xAB && snapm.val_len == 0xABABABABu);
+  TEST("masked snapshot of a missing key fails",
+       splinter_get_slot_snapshot_ex("no_such_key", &snapm, SPL_SNAP_META) == -1);
+
   time_t curtime = time(NULL);
   unsigned long longtime = 0;
   TEST("host can convert time_t to unsigned long and temporal tests can continue", 
@@ -376,6 +425,178 @@ TEST("active data survives hygiene sweep",
 verify_buf[verify_sz] = '\0';
 TEST("verified content integrity after purge", strcmp(verify_buf, "data_to_keep") == 0);
 
+// Incremental purge: stale tail, watermark skip, budgeted resume, ranges.
+int saved_mop = splinter_get_mop();
+char long_val[200];
+memset(long_val, 'x', sizeof(long_val));
+splinter_set_mop(0);
+splinter_set("purge_tail", long_val, sizeof(long_val));
+splinter_set("purge_tail", "abc", 3);
+splinter_cursor_t pcur = { 0 };
+TEST("splinter_purge_step runs to completion with no budget", splinter_purge_step(&pcur, 0) == 0);
+splinter_header_snapshot_t purge_hdr = { 0 };
+splinter_get_header_snapshot(&purge_hdr);
+TEST("purge cursor ends at the slot count", pcur.next == purge_hdr.slots);
+const unsigned char *tail = splinter_get_raw_ptr("purge_tail", &verify_sz, NULL);
+int tail_clean = tail != NULL;
+for (size_t k = 3; tail && k < 64; k++) if (tail[k]) tail_clean = 0;
+TEST("purge zeroes the stale tail past val_len", tail_clean && memcmp(tail, "abc", 3) == 0);
+uint64_t purged_epoch = splinter_get_epoch("purge_tail");
+memset(&pcur, 0, sizeof(pcur));
+splinter_purge_step(&pcur, 0);
+TEST("a clean slot is skipped on the next purge", splinter_get_epoch("purge_tail") == purged_epoch);
+memset(&pcur, 0, sizeof(pcur));
+int purge_steps = 0, purge_rc;
+while ((purge_rc = splinter_purge_step(&pcur, 1)) == 1) purge_steps++;
+TEST("a 1 ns budget purge resumes until done", purge_rc == 0 && purge_steps > 0);
+splinter_cursor_t prange = { .next = 0, .end = 10 };
+TEST("purge stops at the cursor's end", splinter_purge_step(&prange, 0) == 0 && prange.next == 10);
+TEST("splinter_purge_step rejects a NULL cursor", splinter_purge_step(NULL, 0) == -2);
+splinter_unset("purge_tail");
+splinter_set("purge_gone", "secret_bytes", 12);
+const unsigned char *gone = splinter_get_raw_ptr("purge_gone", &verify_sz, NULL);
+splinter_unset("purge_gone");
+splinter_purge();
+int gone_clean = gone != NULL;
+for (size_t k = 0; gone && k < 12; k++) if (gone[k]) gone_clean = 0;
+TEST("a deleted value's bytes are zero after purge with mop off", gone_clean);
+splinter_set_mop((unsigned)saved_mop);
+
+/* -- operation counters -- */
+splinter_stats_t st = { 0 };
+char stat_buf[32];
+size_t stat_sz = 0;
+TEST("counting is off by default", splinter_get_stats(&st) == 0 && st.enabled == 0 && st.ops[SPL_OP_GET] == 0);
+TEST("enable operation counters", splinter_set_stats(1) == 0);
+splinter_set("stat_key", "v1", 2);
+splinter_set("stat_key", "v2", 2);
+splinter_get("stat_key", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_get("stat_absent", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_append("stat_key", "x", 1, NULL);
+splinter_unset("stat_key");
+splinter_get_stats(&st);
+TEST("counters record each operation",
+     st.enabled == 1 && st.ops[SPL_OP_SET] == 2 && st.ops[SPL_OP_GET] == 2 &&
+     st.ops[SPL_OP_APPEND] == 1 && st.ops[SPL_OP_UNSET] == 1);
+TEST("a get of an absent key counts as a miss", st.misses == 1);
+uint64_t probes = 0;
+for (int b = 0; b < SPLINTER_PROBE_BUCKETS; b++) probes += st.probe[b];
+TEST("successful gets and sets land in the probe histogram", probes == 3);
+splinter_set_stats(0);
+splinter_get("stat_absent", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_get_stats(&st);
+TEST("turning counting off keeps totals and stops counting", st.ops[SPL_OP_GET] == 2 && st.enabled == 0);
+TEST("reset zeroes the counters", splinter_reset_stats() == 0 &&
+     splinter_get_stats(&st) == 0 && st.ops[SPL_OP_SET] == 0 && st.misses == 0);
+TEST("splinter_get_stats rejects NULL", splinter_get_stats(NULL) == -2);
+splinter_set_stats(1);
+splinter_shard_claim(0x31, SPL_INTENT_WILLNEED, 10, (uint64_t)1<<60);
+splinter_shard_claim(0x32, SPL_INTENT_WILLNEED, 20, (uint64_t)1<<60);
+splinter_shard_election(NULL);
+errno = 0;
+TEST("a non-sovereign madvise defers",
+     splinter_madvise(0x31, NULL, 0, POSIX_MADV_NORMAL, 0) == -1 && errno == EAGAIN);
+splinter_shard_release(0x32);
+splinter_shard_election(NULL);
+splinter_shard_election(NULL);
+splinter_shard_release(0x31);
+splinter_get_stats(&st);
+TEST("elections count each new sovereign once", st.sovereign_changes == 2);
+TEST("a deferred madvise is counted once", st.madvise_defers == 1);
+splinter_set_stats(0);
+splinter_reset_stats();
+
+/* -- latency histograms -- */
+splinter_latency_t lat = { 0 };
+TEST("latency sampling is off by default", splinter_get_latency(SPL_LAT_GET, &lat) == 0 &&
+     lat.every == 0 && lat.samples == 0);
+TEST("time every call", splinter_set_latency_sampling(1) == 0);
+splinter_set("lat_key", "v", 1);
+for (int k = 0; k < 100; k++) splinter_get("lat_key", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_get_latency(SPL_LAT_GET, &lat);
+TEST("every get is timed", lat.samples == 100 && lat.every == 1);
+TEST("percentiles are ordered and capped by the max",
+     lat.p50 <= lat.p90 && lat.p90 <= lat.p99 && lat.p99 <= lat.p999 && lat.p999 <= lat.max);
+splinter_get_latency(SPL_LAT_SET, &lat);
+TEST("sets land in their own histogram", lat.samples == 1);
+TEST("reset clears the histograms", splinter_reset_latency() == 0 &&
+     splinter_get_latency(SPL_LAT_GET, &lat) == 0 && lat.samples == 0 && lat.max == 0);
+splinter_set_latency_sampling(4);
+for (int k = 0; k < 8; k++) splinter_get("lat_key", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_get_latency(SPL_LAT_GET, &lat);
+TEST("sampling 1 in 4 times 2 of 8 calls", lat.samples == 2);
+TEST("an unknown call is refused", splinter_get_latency(SPL_LAT_OPS, &lat) == -2);
+splinter_set_latency_sampling(0);
+splinter_reset_latency();
+splinter_unset("lat_key");
+
+/* -- tick calibration -- */
+uint64_t hz = splinter_tick_hz();
+TEST("the tick rate is known", hz > 0 && splinter_tick_hz() == hz);
+TEST("one second of ticks is one second", splinter_ticks_to_ns(hz) == 1000000000ull &&
+     splinter_ns_to_ticks(1000000000ull) == hz);
+TEST("conversions survive intervals past 2^64 / 1e9 ticks",
+     splinter_ticks_to_ns(hz * 3600ull) == 3600ull * 1000000000ull);
+uint64_t tick0 = splinter_now();
+struct timespec nap = { 0, 20 * 1000000L };
+nanosleep(&nap, NULL);
+uint64_t napped_ns = splinter_ticks_to_ns(splinter_now() - tick0);
+TEST("a 20 ms sleep measures as 20 ms or a little more", napped_ns >= 19000000ull && napped_ns < 1000000000ull);
+
+/* -- tracing -- */
+char trace_path[64];
+snprintf(trace_path, sizeof(trace_path), "/tmp/splinter_test_trace.%d", (int)getpid());
+TEST("stop without a trace is refused", splinter_trace_stop() == -1 && errno == EINVAL);
+TEST("start a trace", splinter_trace_start(trace_path) == 0);
+TEST("a second trace is refused", splinter_trace_start(trace_path) == -1 && errno == EBUSY);
+splinter_set("trace_key", "abc", 3);
+splinter_get("trace_key", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_append("trace_key", "de", 2, NULL);
+splinter_get("trace_absent", stat_buf, sizeof(stat_buf), &stat_sz);
+splinter_unset("trace_key");
+TEST("stop the trace", splinter_trace_stop() == 0);
+splinter_set("trace_key", "untraced", 8);
+splinter_unset("trace_key");
+splinter_trace_header_t thdr = { 0 };
+splinter_trace_record_t trec[8];
+int tfd = open(trace_path, O_RDONLY);
+ssize_t thdr_got = tfd >= 0 ? read(tfd, &thdr, sizeof(thdr)) : -1;
+ssize_t trec_got = tfd >= 0 ? read(tfd, trec, sizeof(trec)) : -1;
+if (tfd >= 0) close(tfd);
+unlink(trace_path);
+TEST("the trace starts with its header", thdr_got == (ssize_t)sizeof(thdr) &&
+     !memcmp(thdr.magic, SPLINTER_TRACE_MAGIC, 8) && thdr.version == SPLINTER_TRACE_VER &&
+     thdr.rec_size == sizeof(splinter_trace_record_t) && thdr.tick_hz == hz && thdr.dropped == 0);
+TEST("only calls made while tracing are recorded", trec_got == 5 * (ssize_t)sizeof(trec[0]));
+TEST("records keep call order and lengths",
+     trec[0].op == SPL_TRACE_SET && trec[0].val_len == 3 && trec[0].result == 0 &&
+     trec[1].op == SPL_TRACE_GET && trec[1].val_len == 3 &&
+     trec[2].op == SPL_TRACE_APPEND && trec[2].val_len == 2 &&
+     trec[3].op == SPL_TRACE_GET && trec[3].result == -1 &&
+     trec[4].op == SPL_TRACE_UNSET && trec[4].val_len == 5);
+TEST("records share a key hash and carry the pid",
+     trec[0].key_hash == trec[4].key_hash && trec[0].key_hash != trec[3].key_hash &&
+     trec[0].pid == (uint32_t)getpid() && trec[0].ts <= trec[4].ts);
+
+// A forked child must not write into its parent's trace.
+TEST("start a trace before forking", splinter_trace_start(trace_path) == 0);
+splinter_set("trace_key", "p", 1);
+pid_t tchild = fork();
+if (tchild == 0) {
+    // Enough calls to cross a drain boundary if the child were still tracing.
+    for (int k = 0; k < 40000; k++) splinter_get("trace_key", stat_buf, sizeof(stat_buf), &stat_sz);
+    _exit(splinter_trace_stop() == -1 && errno == EINVAL ? 0 : 1);
+}
+int tstatus = -1;
+waitpid(tchild, &tstatus, 0);
+TEST("a forked child is not tracing", WIFEXITED(tstatus) && WEXITSTATUS(tstatus) == 0);
+splinter_trace_stop();
+struct stat tst;
+TEST("the parent's trace holds only its own record",
+     stat(trace_path, &tst) == 0 &&
+     tst.st_size == (off_t)(sizeof(splinter_trace_header_t) + sizeof(splinter_trace_record_t)));
+unlink(trace_path);
+
 /* -- system key (binary scratchpads) -- */
 const char *system_key = "__system_key";
 TEST("Set system key as __system_key with one byte length", splinter_set(system_key, "0", 1) == 0);
@@ -468,6 +689,23 @@ TEST("revived bid is sovereign", splinter_shard_election(NULL) == 0x12);
 TEST("madvise succeeds for sovereign", splinter_madvise(0x12, NULL, 0, POSIX_MADV_WILLNEED, 0) == 0);
 splinter_shard_release(0x12);
 
+/* the cached election must still follow bids starting and expiring on time */
+// Both windows hang off one timestamp and are wide enough that a slow or
+// preempted run still makes both elections inside them.
+uint64_t shard_t0 = splinter_now(), shard_soon = splinter_ns_to_ticks(300 * NS_PER_MS);
+TEST("claim a bid that starts in 300 ms",
+     splinter_shard_claim_ex(0x13, 1000, SPL_INTENT_WILLNEED, 100, (uint64_t)1<<60, shard_t0 + shard_soon) == 0);
+TEST("claim a bid that ends in 300 ms",
+     splinter_shard_claim_ex(0x14, 1000, SPL_INTENT_WILLNEED, 200, shard_soon, shard_t0) == 0);
+TEST("the live bid wins", splinter_shard_election(NULL) == 0x14);
+TEST("repeat elections agree", splinter_shard_election(NULL) == 0x14 && splinter_shard_is_sovereign(0x14) == 1);
+while (splinter_now() - shard_t0 <= shard_soon) {
+    struct timespec shard_wait = { 0, 50 * NS_PER_MS };
+    nanosleep(&shard_wait, NULL);
+}
+TEST("the winner changes once the windows pass", splinter_shard_election(NULL) == 0x13);
+splinter_shard_release(0x13); splinter_shard_release(0x14);
+
 /* splinter_madvise: non-sovereign with timeout 0 defers (EAGAIN) */
 TEST("claim hi-prio blocker", splinter_shard_claim(0x20, SPL_INTENT_WILLNEED, 255, (uint64_t)1<<60) == 0);
 TEST("claim lo-prio waiter",  splinter_shard_claim(0x21, SPL_INTENT_WILLNEED, 1,   (uint64_t)1<<60) == 0);
@@ -475,6 +713,61 @@ TEST("non-sovereign madvise defers with EAGAIN",
      splinter_madvise(0x21, NULL, 0, POSIX_MADV_WILLNEED, 0) == -1 && errno == EAGAIN);
 splinter_shard_release(0x20); splinter_shard_release(0x21);
 
+/* splinter_madvise: a blocking waiter times out, or takes over when the window closes */
+TEST("claim a 200 ms blocker",
+     splinter_shard_claim_ex(0x22, 1000, SPL_INTENT_WILLNEED, 255, splinter_ns_to_ticks(200000000), splinter_now()) == 0);
+TEST("claim a patient waiter", splinter_shard_claim(0x23, SPL_INTENT_WILLNEED, 1, (uint64_t)1<<60) == 0);
+TEST("blocking madvise times out while outranked",
+     splinter_madvise(0x23, NULL, 0, POSIX_MADV_WILLNEED, splinter_ns_to_ticks(20000000)) == -1 && errno == ETIMEDOUT);
+TEST("blocking madvise lands once the blocker expires",
+     splinter_madvise(0x23, NULL, 0, POSIX_MADV_WILLNEED, splinter_ns_to_ticks(5000000000ull)) == 0);
+splinter_shard_release(0x22); splinter_shard_release(0x23);
+
+/* scoped bids only compete where their scopes overlap */
+splinter_shard_scope_t lo_half = { 0, 64, 0 }, hi_half = { 64, 128, 0 }, mid = { 32, 96, 0 };
+splinter_shard_scope_t lab_a = { 0, 0, 0x1 }, lab_b = { 0, 0, 0x2 }, bad_scope = { 9, 3, 0 };
+TEST("scope with slot_lo > slot_hi is refused",
+     splinter_shard_claim_scoped(0x40, SPL_INTENT_WILLNEED, 1, (uint64_t)1<<60, &bad_scope) == -2);
+TEST("claim a low-slot bid",  splinter_shard_claim_scoped(0x40, SPL_INTENT_WILLNEED,   10, (uint64_t)1<<60, &lo_half) == 0);
+TEST("claim a high-slot bid", splinter_shard_claim_scoped(0x41, SPL_INTENT_SEQUENTIAL, 20, (uint64_t)1<<60, &hi_half) == 0);
+TEST("disjoint ranges are both sovereign",
+     splinter_shard_is_sovereign(0x40) == 1 && splinter_shard_is_sovereign(0x41) == 1);
+TEST("scoped sovereign advises its own slots",
+     splinter_madvise(0x40, NULL, 0, POSIX_MADV_WILLNEED, 0) == 0 &&
+     splinter_madvise(0x41, NULL, 0, POSIX_MADV_SEQUENTIAL, 0) == 0);
+TEST("claim an overlapping range above both",
+     splinter_shard_claim_scoped(0x42, SPL_INTENT_RANDOM, 30, (uint64_t)1<<60, &mid) == 0);
+TEST("an overlapping higher priority outranks both",
+     splinter_shard_is_sovereign(0x42) == 1 && splinter_shard_is_sovereign(0x40) == 0 &&
+     splinter_shard_is_sovereign(0x41) == 0);
+TEST("outranked scoped madvise defers",
+     splinter_madvise(0x40, NULL, 0, POSIX_MADV_WILLNEED, 0) == -1 && errno == EAGAIN);
+splinter_shard_release(0x42);
+TEST("claim an unscoped bid", splinter_shard_claim(0x43, SPL_INTENT_RANDOM, 15, (uint64_t)1<<60) == 0);
+TEST("an unscoped bid overlaps every scope",
+     splinter_shard_is_sovereign(0x40) == 0 && splinter_shard_is_sovereign(0x41) == 1 &&
+     splinter_shard_is_sovereign(0x43) == 0);
+splinter_shard_release(0x43);
+TEST("claim a DONTNEED over the high slots",
+     splinter_shard_claim_scoped(0x44, SPL_INTENT_DONTNEED, 200, (uint64_t)1<<60, &hi_half) == 0);
+TEST("soft bumper only where a protective bid overlaps",
+     splinter_shard_is_sovereign(0x44) == 0 && splinter_shard_is_sovereign(0x41) == 1);
+splinter_shard_release(0x44);
+splinter_shard_release(0x40); splinter_shard_release(0x41);
+TEST("claim label bids on distinct labels",
+     splinter_shard_claim_scoped(0x45, SPL_INTENT_WILLNEED, 10, (uint64_t)1<<60, &lab_a) == 0 &&
+     splinter_shard_claim_scoped(0x46, SPL_INTENT_WILLNEED, 20, (uint64_t)1<<60, &lab_b) == 0);
+TEST("label masks without a shared bit do not conflict",
+     splinter_shard_is_sovereign(0x45) == 1 && splinter_shard_is_sovereign(0x46) == 1);
+TEST("a range meets any label mask",
+     splinter_shard_claim_scoped(0x47, SPL_INTENT_WILLNEED, 5, (uint64_t)1<<60, &lo_half) == 0 &&
+     splinter_shard_is_sovereign(0x47) == 0);
+TEST("election still names one winner for the table", splinter_shard_election(NULL) == 0x46);
+TEST("plain claim resets the scope",
+     splinter_shard_claim(0x45, SPL_INTENT_WILLNEED, 10, (uint64_t)1<<60) == 0 &&
+     splinter_shard_is_sovereign(0x45) == 0);
+splinter_shard_release(0x45); splinter_shard_release(0x46); splinter_shard_release(0x47);
+
 /* table full -> ENOSPC */
 for (uint32_t i = 0; i < SPLINTER_MAX_SHARDS; i++) splinter_shard_claim(0x100 + i, SPL_INTENT_RANDOM, 1, (uint64_t)1<<60);
 TEST("33rd claim fails with ENOSPC",
@@ -487,9 +780,86 @@ splinter_shard_claim(0x30, SPL_INTENT_SEQUENTIAL, 77, (uint64_t)1<<60);
 TEST("table snapshot returns 32 records", splinter_shard_table_snapshot(bsnap, SPLINTER_MAX_SHARDS) == SPLINTER_MAX_SHARDS);
 TEST("snapshot reflects claimed bid", bsnap[0].shard_id == 0x30 || /* slot-order independent */ 1);
 splinter_shard_release(0x30);
+splinter_shard_claim_scoped(0x30, SPL_INTENT_SEQUENTIAL, 77, (uint64_t)1<<60, &mid);
+splinter_shard_table_snapshot(bsnap, SPLINTER_MAX_SHARDS);
+int scope_seen = 0;
+for (int b = 0; b < SPLINTER_MAX_SHARDS; b++)
+    if (bsnap[b].shard_id == 0x30)
+        scope_seen = bsnap[b].slot_lo == 32 && bsnap[b].slot_hi == 96 && bsnap[b].sovereign;
+TEST("snapshot carries the bid's scope", scope_seen);
+splinter_shard_release(0x30);
+
+/* --- ordered key index --- */
+TEST("key index is off by default", splinter_get_key_index() == 0);
+struct order_tracker ot = { 0, 1, { 0 } };
+TEST("scan refused while index is off",
+     splinter_scan_prefix("ns/", test_order_callback, &ot) == -1 && errno == ENOTSUP);
+
+splinter_set("ns/b/1", "x", 1);
+splinter_set("ns/a/2", "x", 1);
+TEST("enable key index (indexes existing keys)", splinter_set_key_index(1) == 0);
+TEST("key index reports enabled", splinter_get_key_index() == 1);
+splinter_set("ns/a/1", "x", 1);
+splinter_set("ns/a/3", "x", 1);
+splinter_set("ns/a/2", "y", 1);   /* overwrite: must not duplicate */
+splinter_set("ns/c", "x", 1);
+
+ot = (struct order_tracker){ 0, 1, { 0 } };
+TEST("prefix scan finds namespace", splinter_scan_prefix("ns/a/", test_order_callback, &ot) == 3);
+TEST("prefix scan is ordered", ot.sorted && strcmp(ot.last_key, "ns/a/3") == 0);
+
+ot = (struct order_tracker){ 0, 1, { 0 } };
+TEST("range scan is half-open", splinter_scan_range("ns/a/2", "ns/b/1", test_order_callback, &ot) == 2);
+TEST("range scan stops before hi", strcmp(ot.last_key, "ns/a/3") == 0);
+
+splinter_unset("ns/a/1");
+ot = (struct order_tracker){ 0, 1, { 0 } };
+TEST("unset removes key from index", splinter_scan_prefix("ns/a/", test_order_callback, &ot) == 2);
+
+/* more keys than one scan batch, all in order */
+char ikey[SPLINTER_KEY_MAX];
+for (int k = 99; k >= 0; k--) {
+    snprintf(ikey, sizeof(ikey), "ix/%03d", k);
+    splinter_set(ikey, "v", 1);
+}
+ot = (struct order_tracker){ 0, 1, { 0 } };
+TEST("multi-batch prefix scan sees every key", splinter_scan_prefix("ix/", test_order_callback, &ot) == 100);
+TEST("multi-batch prefix scan is ordered", ot.sorted && strcmp(ot.last_key, "ix/099") == 0);
+int whole = splinter_index_rebuild();
+ot = (struct order_tracker){ 0, 1, { 0 } };
+TEST("rebuild indexes every live key", whole > 0 && splinter_scan_prefix("", test_order_callback, &ot) == whole);
+TEST("full scan is ordered", ot.sorted);
+for (int k = 0; k < 100; k++) {
+    snprintf(ikey, sizeof(ikey), "ix/%03d", k);
+    splinter_unset(ikey);
+}
+splinter_unset("ns/a/2"); splinter_unset("ns/a/3");
+splinter_unset("ns/b/1"); splinter_unset("ns/c");
+TEST("disable key index", splinter_set_key_index(0) == 0);
+
+/* --- TTL bookkeeping (expiry and eviction are exercised on a small store below) --- */
+splinter_set("ttl_key", "v", 1);
+TEST("new key has no TTL", splinter_get_ttl("ttl_key") == 0);
+uint64_t ttl_epoch = splinter_get_epoch("ttl_key");
+TEST("set TTL", splinter_set_ttl("ttl_key", 3600) == 0);
+TEST("setting a TTL moves the slot epoch by a whole write", splinter_get_epoch("ttl_key") == ttl_epoch + 2);
+int64_t ttl_left = splinter_get_ttl("ttl_key");
+TEST("TTL counts down from what was set", ttl_left > 3590 && ttl_left <= 3600);
+errno = 0;
+TEST("TTL on missing key fails with ENOENT", splinter_set_ttl("no_such_ttl_key", 10) == -1 && errno == ENOENT);
+errno = 0;
+TEST("TTL read of a missing key fails with ENOENT", splinter_get_ttl("no_such_ttl_key") == -1 && errno == ENOENT);
+TEST("clear TTL", splinter_set_ttl("ttl_key", 0) == 0 && splinter_get_ttl("ttl_key") == 0);
+splinter_set_ttl("ttl_key", 3600);
+splinter_unset("ttl_key");
+splinter_set("ttl_key", "v", 1);
+TEST("re-created key does not inherit TTL", splinter_get_ttl("ttl_key") == 0);
+splinter_unset("ttl_key");
+TEST("eviction is off by default", splinter_get_eviction() == 0);
 
 /* --- event bus --- */
 TEST("event bus init", splinter_event_bus_init() == 0);
+splinter_set_stats(1);
 
 splinter_set("eb_key1", "hello", 5);
 splinter_set("eb_key2", "world", 5);
@@ -507,17 +877,426 @@ TEST("event bus open returns valid fd", efd >= 0);
 /* Two writes already happened, so eventfd counter >= 2; wait should return immediately */
 TEST("event bus wait returns immediately (data ready)", splinter_event_bus_wait(efd, 500) == 0);
 splinter_event_bus_close(efd);
+splinter_get_stats(&st);
+TEST("a bus wait consumes every wake-up written so far",
+     st.eventfd_writes >= 2 && st.eventfd_reads == st.eventfd_writes);
+splinter_set_stats(0);
 
 splinter_close();
 splinter_header_snapshot_t closed = { 0 };
 TEST("store actually closed", splinter_get_header_snapshot(&closed) != 0);
 
-#ifndef SPLINTER_PERSISTENT
-  snprintf(buspath, sizeof(buspath) -1, "/dev/shm/%s", bus);
-#else
-  snprintf(buspath, sizeof(buspath) -1, "./%s", bus);
-#endif /* SPLINTER_PERSISTENT */
-  unlink(buspath);
+drop_store(bus);
+
+/* --- cache residence: CLOCK eviction and TTL expiry on a tiny store --- */
+/* A hole opened ahead of a key on its probe must not take a second copy of
+ * it: unset each key in turn, overwrite the rest, and the unset key must still
+ * find a slot. "p0", "p4" and "p8" differ only in the low bits FNV-1a keeps
+ * for the slot index mod 4, so they share a home slot and push each other on. */
+char pbus[32];
+TEST("create 4-slot probe store", fresh_store(pbus, sizeof(pbus), "probe", 4, 64, 0) == 0);
+char pkey[16];
+int pdup_ok = 1;
+for (int k = 0; k < 4; k++) {
+    snprintf(pkey, sizeof(pkey), "p%d", k * 4);
+    if (splinter_set(pkey, "v", 1) != 0) pdup_ok = 0;
+}
+for (int x = 0; x < 4; x++) {
+    char xkey[16];
+    snprintf(xkey, sizeof(xkey), "p%d", x * 4);
+    splinter_unset(xkey);
+    for (int k = 0; k < 4; k++) {
+        snprintf(pkey, sizeof(pkey), "p%d", k * 4);
+        if (k != x && splinter_set(pkey, "u", 1) != 0) pdup_ok = 0;
+    }
+    if (splinter_set(xkey, "v", 1) != 0) pdup_ok = 0;
+}
+TEST("overwrites past a hole keep one copy per key", pdup_ok);
+drop_store(pbus);
+
+char evbus[32];
+TEST("create 4-slot cache store", fresh_store(evbus, sizeof(evbus), "evict", 4, 64, 0) == 0);
+char ekey[16];
+int filled = 0;
+for (int k = 0; k < 4; k++) {
+    snprintf(ekey, sizeof(ekey), "c%d", k);
+    filled += (splinter_set(ekey, "v", 1) == 0);
+}
+TEST("fill cache store", filled == 4);
+TEST("full store refuses a new key (ENOSPC)", splinter_set("c4", "v", 1) == -1 && errno == ENOSPC);
+TEST("overwrite still works when full", splinter_set("c1", "w", 1) == 0);
+
+TEST("enable eviction", splinter_set_eviction(1) == 0 && splinter_get_eviction() == 1);
+splinter_set_label("c0", 0x1);   /* labelled: pinned */
+TEST("full store evicts to admit a new key", splinter_set("c4", "v", 1) == 0);
+splinter_header_snapshot_t ehs = { 0 };
+splinter_get_header_snapshot(&ehs);
+TEST("eviction is counted", ehs.evicted == 1);
+TEST("labelled key survives eviction", splinter_get("c0", NULL, 0, NULL) == 0);
+int evictions_ok = 1;
+for (int k = 5; k < 12; k++) {
+    snprintf(ekey, sizeof(ekey), "c%d", k);
+    if (splinter_set(ekey, "v", 1) != 0) evictions_ok = 0;
+}
+TEST("steady-state churn keeps admitting keys", evictions_ok);
+TEST("labelled key survives churn", splinter_get("c0", NULL, 0, NULL) == 0);
+
+TEST("set 1s TTL", splinter_set_ttl("c11", 1) == 0);
+/* A second short-lived key that only the CLOCK sweep will find. */
+int ettl = 0;
+for (int k = 5; k < 11 && !ettl; k++) {
+    snprintf(ekey, sizeof(ekey), "c%d", k);
+    ettl = splinter_set_ttl(ekey, 1) == 0;
+}
+TEST("set 1s TTL on a second key", ettl);
+splinter_set_eviction(0);
+sleep(2);
+TEST("expired key reads as absent (ENOENT)", splinter_get("c11", NULL, 0, NULL) == -1 && errno == ENOENT);
+splinter_get_header_snapshot(&ehs);
+TEST("expiry is counted", ehs.expired == 1);
+TEST("expired slot is free again", splinter_set("c12", "v", 1) == 0);
+TEST("full store sweeps a lapsed TTL without eviction", splinter_set("c13", "v", 1) == 0 &&
+     splinter_get(ekey, NULL, 0, NULL) == -1 && errno == ENOENT);
+TEST("with no TTL left a full store refuses again (ENOSPC)",
+     splinter_set("c14", "v", 1) == -1 && errno == ENOSPC);
+drop_store(evbus);
+
+/* --- value arena: size-class extents on a small explicit arena --- */
+char abus[32];
+TEST("arena smaller than one max value is refused (EINVAL)",
+     fresh_store(abus, sizeof(abus), "arena", 16, 1024, 512) == -2 && errno == EINVAL);
+TEST("create store with a 2 KiB arena", fresh_store(abus, sizeof(abus), "arena", 16, 1024, 2048) == 0);
+char big[1024], small[200], aout[1024];
+size_t alen = 0;
+memset(big, 'B', sizeof(big));
+memset(small, 's', sizeof(small));
+splinter_header_snapshot_t ahs = { 0 };
+splinter_get_header_snapshot(&ahs);
+TEST("header reports arena size", ahs.arena_sz == 2048 && ahs.arena_inuse == 0);
+TEST("max-size value takes a top-class extent", splinter_set("a", big, 1000) == 0);
+TEST("small value takes a small extent", splinter_set("b", small, 100) == 0);
+splinter_get_header_snapshot(&ahs);
+TEST("arena in-use tracks extent sizes", ahs.arena_inuse == 1024 + 128);
+TEST("shrinking a value moves it to a smaller extent", splinter_set("a", "tiny", 4) == 0);
+splinter_get_header_snapshot(&ahs);
+uint64_t abrk = ahs.arena_brk;
+TEST("freed extent is returned to its class", ahs.arena_inuse == 64 + 128);
+TEST("same-class value reuses the freed extent", splinter_set("c", big, 1000) == 0);
+splinter_get_header_snapshot(&ahs);
+TEST("extent reuse does not advance the break", ahs.arena_brk == abrk);
+TEST("exhausted arena refuses a new value (ENOSPC)",
+     splinter_set("d", big, 1000) == -1 && errno == ENOSPC);
+TEST("append grows a value into a larger extent",
+     splinter_append("b", small, 100, &alen) == 0 && alen == 200);
+TEST("relocated value keeps its bytes",
+     splinter_get("b", aout, sizeof(aout), &alen) == 0 && alen == 200 && memcmp(aout, small, 200) == 0);
+TEST("shrunk value reads back intact",
+     splinter_get("a", aout, sizeof(aout), &alen) == 0 && alen == 4 && memcmp(aout, "tiny", 4) == 0);
+TEST("unset frees the extent for reuse", splinter_unset("c") >= 0 && splinter_set("d", big, 1000) == 0);
+drop_store(abus);
+
+/* --- 64-bit value offsets: arenas past 4 GiB (sparse, never touched) --- */
+char wbus[32];
+TEST("arena past 256 GiB is refused (EFBIG)",
+     fresh_store(wbus, sizeof(wbus), "wide", 4, 64, (size_t)300 << 30) == -2 && errno == EFBIG);
+TEST("create store with a 5 GiB arena", fresh_store(wbus, sizeof(wbus), "wide", 4, 64, (size_t)5 << 30) == 0);
+splinter_get_header_snapshot(&ahs);
+TEST("header reports the full 5 GiB arena", ahs.arena_sz == (uint64_t)5 << 30);
+TEST("value round-trips in a wide arena",
+     splinter_set("w", "wide", 4) == 0
+     && splinter_get("w", aout, sizeof(aout), &alen) == 0 && alen == 4 && memcmp(aout, "wide", 4) == 0);
+drop_store(wbus);
+
+/* --- chained values past max_val_sz --- */
+char cbus[32];
+TEST("create 256-byte-max store with a 64 KiB arena", fresh_store(cbus, sizeof(cbus), "chain", 8, 256, 65536) == 0);
+uint8_t cval[2048], cout[2048];
+for (size_t k = 0; k < sizeof(cval); k++) cval[k] = (uint8_t)(k * 7 + 3);
+size_t clen = 0;
+TEST("long value refused while chaining is off (EMSGSIZE)",
+     splinter_set("long", cval, 1000) == -1 && errno == EMSGSIZE);
+TEST("enable chaining", splinter_set_chaining(1) == 0 && splinter_get_chaining() == 1);
+splinter_header_snapshot_t chs = { 0 };
+splinter_get_header_snapshot(&chs);
+TEST("header reports chain_max", chs.chain_max == (256 / 4) * 256);
+TEST("set chained value", splinter_set("long", cval, 1000) == 0);
+TEST("chained value reads back as one value",
+     splinter_get("long", cout, sizeof(cout), &clen) == 0 && clen == 1000 && memcmp(cout, cval, 1000) == 0);
+struct iovec civ[8];
+uint64_t cep = 0;
+TEST("iov view reports its segment count", splinter_get_iov("long", NULL, 0, &clen, NULL) == 4);
+int civn = splinter_get_iov("long", civ, 8, &clen, &cep);
+size_t cpos = 0;
+int civ_ok = (civn == 4);
+for (int k = 0; civ_ok && k < civn; k++) {
+    civ_ok = memcmp(civ[k].iov_base, cval + cpos, civ[k].iov_len) == 0;
+    cpos += civ[k].iov_len;
+}
+TEST("iov view covers the value in order", civ_ok && cpos == 1000 && cep == splinter_get_epoch("long"));
+TEST("iov view refuses a short array (EMSGSIZE)",
+     splinter_get_iov("long", civ, 2, NULL, NULL) == -1 && errno == EMSGSIZE);
+TEST("raw pointer refuses a chained value (EMSGSIZE)",
+     splinter_get_raw_ptr("long", NULL, NULL) == NULL && errno == EMSGSIZE);
+TEST("append extends a chain", splinter_append("long", cval + 1000, 500, &clen) == 0 && clen == 1500);
+TEST("extended chain reads back",
+     splinter_get("long", cout, sizeof(cout), &clen) == 0 && clen == 1500 && memcmp(cout, cval, 1500) == 0);
+TEST("set short value", splinter_set("grow", cval, 200) == 0);
+TEST("append past max_val_sz starts a chain", splinter_append("grow", cval + 200, 200, &clen) == 0 && clen == 400);
+TEST("promoted chain keeps its bytes",
+     splinter_get("grow", cout, sizeof(cout), &clen) == 0 && clen == 400 && memcmp(cout, cval, 400) == 0);
+TEST("short overwrite collapses a chain", splinter_set("long", "short", 5) == 0);
+size_t craw = 0;
+const void *cptr = splinter_get_raw_ptr("long", &craw, NULL);
+TEST("collapsed value is contiguous again", cptr != NULL && craw == 5 && memcmp(cptr, "short", 5) == 0);
+TEST("value past chain_max refused (EMSGSIZE)",
+     splinter_set("huge", cval, (size_t)chs.chain_max + 1) == -1 && errno == EMSGSIZE);
+TEST("unset releases a chain", splinter_unset("grow") == 400 && splinter_unset("long") == 5);
+splinter_get_header_snapshot(&chs);
+TEST("all extents returned after unset", chs.arena_inuse == 0);
+drop_store(cbus);
+
+/* --- online resize --- */
+char rbus[32];
+TEST("create 4-slot store to outgrow", fresh_store(rbus, sizeof(rbus), "resize", 4, 64, 0) == 0);
+char rkey[16], rval[256], rout[256];
+int rfilled = 0;
+for (int k = 0; k < 4; k++) {
+    snprintf(rkey, sizeof(rkey), "r%d", k);
+    snprintf(rval, sizeof(rval), "value-%d", k);
+    rfilled += (splinter_set(rkey, rval, strlen(rval)) == 0);
+}
+TEST("fill the small store", rfilled == 4);
+splinter_set_label("r1", 0x4);
+splinter_set_ttl("r2", 600);
+uint64_t r0_epoch = splinter_get_epoch("r0");
+TEST("zero geometry refused (EINVAL)", splinter_resize(0, 64) == -2 && errno == EINVAL);
+
+int rpipe[2];
+TEST("open follower pipe", pipe(rpipe) == 0);
+pid_t follower = fork();
+if (follower == 0) {
+    /* Attached before the resize; must land on the new store afterwards. */
+    char go;
+    close(rpipe[1]);
+    if (read(rpipe[0], &go, 1) != 1) _exit(2);
+    size_t flen = 0;
+    splinter_header_snapshot_t fhs = { 0 };
+    /* The lowest free descriptor moves up if following leaks one. */
+    int fd_before = dup(0);
+    close(fd_before);
+    /* First call is a metadata write, which must follow before touching the slot. */
+    int ok = splinter_bump_slot("r3") == 0 &&
+             splinter_get("r3", rout, sizeof(rout), &flen) == 0 &&
+             flen == 7 && memcmp(rout, "value-3", 7) == 0 &&
+             splinter_get_header_snapshot(&fhs) == 0 && fhs.slots == 16;
+    int fd_after = dup(0);
+    close(fd_after);
+    _exit(!ok ? 1 : fd_after != fd_before ? 3 : 0);
+}
+close(rpipe[0]);
+char rtrace[64];
+snprintf(rtrace, sizeof(rtrace), "/tmp/splinter_test_rtrace.%d", (int)getpid());
+splinter_trace_start(rtrace);
+TEST("resize to 16 slots x 256 bytes", splinter_resize(16, 256) == 0);
+splinter_trace_stop();
+struct stat rtst;
+TEST("the copy itself is not traced",
+     stat(rtrace, &rtst) == 0 && rtst.st_size == (off_t)sizeof(splinter_trace_header_t));
+unlink(rtrace);
+if (write(rpipe[1], "g", 1) != 1) perror("write");
+close(rpipe[1]);
+int fstatus = 0;
+waitpid(follower, &fstatus, 0);
+TEST("attached process follows the resize", WIFEXITED(fstatus) && WEXITSTATUS(fstatus) == 0);
+
+splinter_header_snapshot_t rhs = { 0 };
+splinter_get_header_snapshot(&rhs);
+TEST("new geometry in effect", rhs.slots == 16 && rhs.max_val_sz == 256);
+size_t rlen = 0;
+TEST("values survive the resize",
+     splinter_get("r0", rout, sizeof(rout), &rlen) == 0 && rlen == 7 && memcmp(rout, "value-0", 7) == 0);
+TEST("epoch survives the resize", splinter_get_epoch("r0") == r0_epoch);
+splinter_slot_snapshot_t rsnap = { 0 };
+splinter_get_slot_snapshot("r1", &rsnap);
+TEST("labels survive the resize", rsnap.bloom == 0x4);
+TEST("TTL survives the resize", splinter_get_ttl("r2") > 500);
+TEST("poll on a moved store times out instead of hanging",
+     splinter_poll("r2", 20) == -1 && errno == ETIMEDOUT);
+rfilled = 0;
+for (int k = 4; k < 16; k++) {
+    snprintf(rkey, sizeof(rkey), "r%d", k);
+    rfilled += (splinter_set(rkey, "v", 1) == 0);
+}
+TEST("grown store takes more keys", rfilled == 12);
+memset(rval, 'x', 200);
+TEST("grown store takes longer values", splinter_set("r0", rval, 200) == 0);
+TEST("shrinking below the live key count fails (ENOSPC)",
+     splinter_resize(4, 256) == -1 && errno == ENOSPC);
+TEST("failed resize leaves the store writable", splinter_set("r5", "w", 1) == 0 &&
+     splinter_get("r5", rout, sizeof(rout), &rlen) == 0 && rlen == 1);
+drop_store(rbus);
+
+/* A resize whose processes are killed mid-walk must not wedge the store. */
+char dbus[32];
+TEST("create store for a dead resizer", fresh_store(dbus, sizeof(dbus), "deadresize", 16384, 1024, 0) == 0);
+/* Big enough values that the walk outlasts a scheduler slice. */
+char dval[1024];
+memset(dval, 'v', sizeof(dval));
+int dfilled = 0;
+for (int k = 0; k < 8192; k++) {
+    snprintf(rkey, sizeof(rkey), "d%d", k);
+    memcpy(dval, rkey, strlen(rkey));
+    dfilled += (splinter_set(rkey, dval, sizeof(dval)) == 0);
+}
+TEST("fill the store to resize", dfilled == 8192);
+pid_t dresizer = fork();
+if (dresizer == 0) {
+    setpgid(0, 0);   /* so one kill takes the copying child too */
+    _exit(splinter_resize(32768, 1024) == 0 ? 0 : 1);
+}
+int dstatus = 0;
+while (waitpid(dresizer, &dstatus, WNOHANG) == 0) {
+    if (splinter_set("d0", "x", 1) == -1 && errno == EAGAIN) {
+        kill(-dresizer, SIGKILL);
+        waitpid(dresizer, &dstatus, 0);
+        break;
+    }
+}
+/* Killed mid-walk the resize rolls back, killed after the rename it is
+ * published; either way writes must go through again. */
+int dwritable = 0;
+for (int tries = 0; tries < 1000 && !dwritable; tries++) {
+    dwritable = splinter_set("d0", "y", 1) == 0;
+    if (!dwritable) usleep(1000);
+}
+TEST("store is writable after its resizer dies", dwritable);
+TEST("keys survive a dead resizer",
+     splinter_get("d7", dval, sizeof(dval), &rlen) == 0 && rlen == sizeof(dval) &&
+     memcmp(dval, "d7", 2) == 0);
+TEST("a new resize runs after a dead one", splinter_resize(32768, 1024) == 0);
+drop_store(dbus);
+
+/* --- occupancy bitmap and slot iterator --- */
+char obus[32];
+TEST("create 200-slot store for iteration", fresh_store(obus, sizeof(obus), "iter", 200, 64, 0) == 0);
+char okey[16];
+int oset = 1;
+for (int k = 0; k < 70; k++) {
+    snprintf(okey, sizeof(okey), "it%02d", k);
+    oset = oset && splinter_set(okey, okey, strlen(okey)) == 0;
+}
+TEST("populate 70 keys", oset);
+TEST("unset two of them", splinter_unset("it03") >= 0 && splinter_unset("it42") >= 0);
+splinter_cursor_t ocur = { 0 };
+splinter_slot_snapshot_t osnap;
+int ovisits = 0, ointact = 1;
+uint64_t olast = 0;
+while (splinter_iter_next(&ocur, &osnap, SPL_SNAP_META) == 1) {
+    ovisits++;
+    ointact = ointact && osnap.val_len == strlen(osnap.key) && strncmp(osnap.key, "it", 2) == 0
+              && strcmp(osnap.key, "it03") != 0 && strcmp(osnap.key, "it42") != 0
+              && (ovisits == 1 || ocur.next - 1 > olast);
+    olast = ocur.next - 1;
+}
+TEST("iterator visits every live key once", ovisits == 68);
+TEST("iterator snapshots carry key and length, in slot order", ointact);
+TEST("exhausted cursor stays exhausted", splinter_iter_next(&ocur, &osnap, SPL_SNAP_META) == 0);
+size_t ocount = 0;
+char *okeys[128];
+TEST("splinter_list agrees with the iterator",
+     splinter_list(okeys, 128, &ocount) == 0 && ocount == 68);
+memset(&osnap, 0xAB, sizeof(osnap));
+splinter_cursor_t okcur = { 0 };
+TEST("key-only mask leaves other fields untouched",
+     splinter_iter_next(&okcur, &osnap, SPL_SNAP_KEY) == 1 && osnap.key[0] == 'i'
+     && osnap.val_len == 0xABABABABu && osnap.epoch % 2 == 0);
+TEST("iterator rejects a NULL cursor", splinter_iter_next(NULL, &osnap, SPL_SNAP_META) == -2);
+drop_store(obus);
+
+/* --- hot/cold tiering: three page-sized values in a row --- */
+char tbus[32];
+TEST("create store for tiering", fresh_store(tbus, sizeof(tbus), "tier", 16, 4096, 65536) == 0);
+char tval[4096], tout[4096];
+size_t tlen = 0;
+memset(tval, 't', sizeof(tval));
+splinter_tier_policy_t tpol = { .cold_passes = 2 };
+splinter_tier_report_t trep = { 0 };
+TEST("tiering is off by default", splinter_get_tiering() == 0);
+TEST("tier pass refuses shard id 0", splinter_tier_pass(0, &tpol, &trep) == -2);
+TEST("turn tiering on", splinter_set_tiering(1) == 0 && splinter_get_tiering() == 1);
+splinter_set("hot", tval, sizeof(tval));
+splinter_set("pad", tval, sizeof(tval));
+splinter_set("cold", tval, sizeof(tval));
+TEST("fresh writes are hot",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.scanned == 3 && trep.hot == 3 && trep.cold == 0);
+splinter_get("hot", tout, sizeof(tout), &tlen);
+TEST("one idle pass is not cold yet",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.hot == 1 && trep.cold == 0);
+splinter_get("hot", tout, sizeof(tout), &tlen);
+TEST("idle values go cold and are advised out",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.cold == 2 && trep.cold_bytes > 0 &&
+     trep.deferred == 0);
+uint64_t first_cold = trep.cold_bytes;
+splinter_get("hot", tout, sizeof(tout), &tlen);
+// Only a value straddling a page it shares with "hot" is advised again.
+TEST("cold values are advised once",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.cold == 2 && trep.cold_bytes < first_cold);
+splinter_get("cold", tout, sizeof(tout), &tlen);
+TEST("a cold value read again is prefetched",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.rising == 1 && trep.warm_bytes > 0);
+TEST("claim a protective bid", splinter_shard_claim(0x61, SPL_INTENT_WILLNEED, 200, (uint64_t)1<<60) == 0);
+splinter_get("hot", tout, sizeof(tout), &tlen);
+splinter_tier_pass(0x60, &tpol, &trep);
+splinter_get("hot", tout, sizeof(tout), &tlen);
+TEST("paging out defers to a live WILLNEED bid",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.deferred == 1 && trep.cold_bytes == 0);
+splinter_shard_release(0x61);
+TEST("deferred values are advised on the next pass",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.cold_bytes > 0);
+TEST("tier pass leaves no bid behind", splinter_shard_election(NULL) == 0);
+splinter_shard_claim(0x62, SPL_INTENT_WILLNEED, 10, (uint64_t)1<<60);
+errno = 0;
+TEST("tier pass refuses a shard id that already has a bid",
+     splinter_tier_pass(0x62, &tpol, &trep) == -1 && errno == EBUSY);
+TEST("the refused bid is left in place", splinter_shard_election(NULL) == 0x62);
+splinter_shard_release(0x62);
+splinter_set("s_hot", "warm", 4);
+splinter_set("s_cold", "idle", 4);
+for (int tp = 0; tp < 3; tp++) {
+    splinter_get("s_hot", tout, sizeof(tout), &tlen);
+    splinter_get("hot", tout, sizeof(tout), &tlen);
+    splinter_tier_pass(0x60, &tpol, &trep);
+}
+splinter_get("s_cold", tout, sizeof(tout), &tlen);
+TEST("a cold value sharing a page with a hot one was never marked advised",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.rising == 0);
+splinter_set_tiering(0);
+splinter_get("hot", tout, sizeof(tout), &tlen);
+TEST("reads are not marked with tiering off",
+     splinter_tier_pass(0x60, &tpol, &trep) == 0 && trep.hot == 0);
+drop_store(tbus);
+
+/* --- residency and footprint --- */
+char mbus[32];
+TEST("create store for mem report", fresh_store(mbus, sizeof(mbus), "mem", 64, 4096, 65536) == 0);
+char mval[100];
+memset(mval, 'm', sizeof(mval));
+splinter_set("m1", mval, 100);
+splinter_set("m2", mval, 10);
+splinter_set_label("m1", 0x4);
+splinter_mem_report_t mrep;
+TEST("mem report refuses NULL", splinter_mem_report(NULL) == -2);
+TEST("mem report succeeds", splinter_mem_report(&mrep) == 0 && mrep.page_size > 0);
+TEST("header is resident", mrep.region[SPL_REGION_HEADER].resident > 0);
+TEST("mem report counts live values",
+     mrep.all.keys == 2 && mrep.all.val_bytes == 110 && mrep.all.ext_bytes >= 110 + 64);
+TEST("freshly written values are resident", mrep.all.resident == mrep.all.ext_bytes);
+TEST("mem report splits by label",
+     mrep.label[2].keys == 1 && mrep.label[2].val_bytes == 100 && mrep.label[0].keys == 0);
+uint64_t mkeys = 0;
+for (int b = 0; b < SPLINTER_MEM_RANGES; b++) mkeys += mrep.range[b].keys;
+TEST("slot ranges cover every key", mkeys == 2 && mrep.range_slots == 4);
+drop_store(mbus);
 
 #ifdef HAVE_VALGRIND_H
   if (RUNNING_ON_VALGRIND) {